@@ -93,7 +93,7 @@ extern void eiint21(void);
 /* CAN global error interrupt; */
 extern void eiint22(void);
 /* CAN receive FIFO interrupt; */
-extern void eiint23(void);
+extern void isr_can_rx(void);
 /* CAN0 error interrupt; */
 extern void eiint24(void);
 /* CAN0 transmit/receive FIFO receive complete interrupt; */
@@ -120,8 +120,8 @@ extern void eiint34(void);
 extern void isr_gps(void);
 /* RLIN30 status interrupt; */
 extern void eiint36(void);
-/* External interrupt; */
-extern void eiint37(void);
+/* External interrupt, software requested context switch; */
+extern void vPortYield(void);
 /* External interrupt; */
 extern void eiint38(void);
 /* External interrupt; */
@@ -850,7 +850,7 @@ void * const INT_Vectors[] = {
     /* CAN global error interrupt; */
     (void *)eiint22,
     /* CAN receive FIFO interrupt; */
-    (void *)eiint23,
+    (void *)isr_can_rx,
     /* CAN0 error interrupt; */
     (void *)eiint24,
     /* CAN0 transmit/receive FIFO receive complete interrupt; */
@@ -877,8 +877,8 @@ void * const INT_Vectors[] = {
     (void *)isr_gps,
     /* RLIN30 status interrupt; */
     (void *)eiint36,
-    /* External interrupt; */
-    (void *)eiint37,
+    /* External interrupt, software requested context switch; */
+    (void *)vPortYield,
     /* External interrupt; */
     (void *)eiint38,
     /* External interrupt; */
@@ -22,10 +22,12 @@
 #include "hal_can.h"
 
 #define DRV_CAN_TX_FIFO_SIZE_D          (80)                    //Transmit FIFO Buffer Size
-#define DRV_CAN_RX_BUFF_SIZE_D          (80)                    //Receive FIFO Buffer Size
+#define DRV_CAN_RX_BUFF_SIZE_D          (128)                   //Receive FIFO Buffer Size, 20 ms of a fully loaded 500 kbps bus
 #define DRV_CAN_TASK_RATE_MSEC_D        (1)                     //Transmit MSG Rate
 #define DRV_CAN_RX_MSG_RATE_MSEC_D      (10)                    //Receive MSG Rate
 #define DRV_CAN_MSG_FILT_NO_D           (10)                    //No of filters to be applied
+#define DRV_CAN_FD_EN_D                 ((HAL_CAN_FD_EN) ? TRUE : FALSE)    //CAN FD frames sent and received, 2Mbps data phase, set by HAL_CAN_FD_EN
+#define DRV_CAN_STATS_WINDOW_MSEC_D     (1000)                  //Measurement window of the frame rates and bus load
 
 typedef enum
 {
@@ -45,6 +47,40 @@ typedef enum
     eBUFF_READ_SUCCESS
 }DRV_CAN_RX_BUFF_STAT_T;
 
+typedef struct
+{
+    U32 u32TxFrames;                                //Frames handed to the controller
+    U32 u32TxSwOverflow;                            //Frames rejected because the transmit queue was full
+    U32 u32TxDelayTotalTicks;                       //Sum of queueing delays, in drv_can_bPeriodicTask calls
+    U32 u32TxDelayMaxTicks;                         //Longest queueing delay, in drv_can_bPeriodicTask calls
+    U16 u16TxQueuePeak;                             //Highest number of frames waiting in the transmit queue
+}DRV_CAN_TX_STATS_T;
+
+typedef struct
+{
+    U32 u32RxFrames;                                //Frames stored in the receive buffer
+    U32 u32RxSwOverflow;                            //Frames dropped because the receive buffer was full
+    U32 u32RxHwOverflow;                            //Times the controller receive FIFO lost frames
+    U16 u16RxQueuePeak;                             //Highest number of frames waiting in the receive buffer
+}DRV_CAN_RX_STATS_T;
+
+typedef struct
+{
+    U32 u32RxFramesPerSec;                          //Frames read from the controller in the last window, dropped ones included
+    U32 u32TxFramesPerSec;                          //Frames handed to the controller in the last window
+    U16 u16BusLoadPermille;                         //Bus time of these frames in the last window, worst case bit stuffing
+    U16 u16BusLoadPeakPermille;                     //Highest bus load of any window
+    U8 u8TxErrCnt;                                  //Transmit error counter at the last poll
+    U8 u8RxErrCnt;                                  //Receive error counter at the last poll
+    BOOL_T bErrPassive;                             //Error passive at the last poll
+    U32 u32BusErrors;                               //Polls that found a bus error
+    U32 u32ErrPassiveCount;                         //Transitions to error passive
+    U32 u32BusOffCount;                             //Transitions to bus off
+    U32 u32BusOffRecoveries;                        //Bus off left by the controller recovery sequence, 128 x 11 recessive bits
+}DRV_CAN_BUS_STATS_T;
+
+typedef void (*DRV_CAN_TRACE_CB_T)(const CAN_MSG_T* psMsg, BOOL_T bTx);
+
 /**
  * @brief                   Function to CAN Driver Initialization.
  * @return                  TRUE:               Success.
@@ -54,6 +90,8 @@ extern BOOL_T drv_can_bInit(void);
 
 /**
  * @brief                   CAN Driver Transmit Message function copies data from application buffer to TxFIFO.
+ *                          Queued frames go to the controller in bus arbitration order, frames of the same ID keep their order:
+ *                          a frame is held while one with its ID is still pending in the controller.
  * @param      psMsg        A pointer to CAN_MSG_T
  * @return                  eBUFF_SUCCESS:              Buffer write Success.
  *                          eBUFF_ERR:                  If TxFIFO is full.
@@ -70,7 +108,53 @@ extern DRV_CAN_RX_BUFF_STAT_T drv_can_bReadRecvMsg(CAN_MSG_T *pRxMsg);
 
 /**
  * @brief                   CAN Driver Periodic function.
+ *                          Polls the channel errors, frames stay queued while the channel is bus off.
+ *                          Bus off is left by the controller itself (ISO 11898-1 recovery), the driver only counts it.
 */
 extern void drv_can_bPeriodicTask(void);
 
+/**
+ * @brief                   Function to replace the hardware receive filter, frames not matching any rule never reach the driver.
+ *                          Frames held by the controller are lost during the change, the driver buffers are kept.
+ *                          Waits for the controller mode changes, call it from a thread and not from an interrupt.
+ * @param      psRules      A pointer to the receive rules, see hal_can_bConfRxFilter.
+ * @param      u16Count     Number of rules, up to HAL_CAN_RX_RULE_MAX.
+ * @return                  TRUE:               Success.
+ *                          FALSE:              If a rule is invalid or the controller did not change mode.
+*/
+extern BOOL_T drv_can_bSetRxFilter(const CANID_MASKVALUE_T* psRules, U16 u16Count);
+
+/**
+ * @brief                   Function to set the trace callback, NULL to remove it.
+ * @param      pfnTraceCb   Called from the receive interrupt for every frame read from the controller (bTx FALSE), even when
+ *                          the receive buffer is full, and from drv_can_bPeriodicTask for every frame handed to the controller
+ *                          (bTx TRUE, u32Timestamp set). It must be short.
+*/
+extern void drv_can_vSetTraceCallback(DRV_CAN_TRACE_CB_T pfnTraceCb);
+
+/**
+ * @brief                   Function to read the transmit statistics.
+ * @param      psStats      A pointer to DRV_CAN_TX_STATS_T
+*/
+extern void drv_can_vGetTxStats(DRV_CAN_TX_STATS_T* psStats);
+
+/**
+ * @brief                   Function to read the receive statistics.
+ * @param      psStats      A pointer to DRV_CAN_RX_STATS_T
+*/
+extern void drv_can_vGetRxStats(DRV_CAN_RX_STATS_T* psStats);
+
+/**
+ * @brief                   Function to read the bus load and error statistics.
+ * @param      psStats      A pointer to DRV_CAN_BUS_STATS_T
+*/
+extern void drv_can_vGetBusStats(DRV_CAN_BUS_STATS_T* psStats);
+
+/**
+ * @brief                   Function to read the bus state.
+ * @return                  CAN_BUS_OFF:        Channel is bus off, transmission is held.
+ *                          CAN_BUS_NORMAL:     Otherwise.
+*/
+extern DRV_CAN_BUS_STAT_T drv_can_eGetBusState(void);
+
 #endif
\ No newline at end of file
@@ -19,20 +19,36 @@
 
 #include "AEPL_types.h"
 
+#define HAL_CAN_TIMESTAMP_HZ        (60000000UL)    //Receive timestamp clock, OSTM1 count clock
+#define HAL_CAN_STD_ID_MASK         (0x000007FFUL)  //11 bit standard identifier
+#define HAL_CAN_EXT_ID_MASK         (0x1FFFFFFFUL)  //29 bit extended identifier
+#define HAL_CAN_RX_RULE_MAX         (128u)          //Receive rules of channel 0, limit of the receive rule table
+#define HAL_CAN_RX_FIFO_NUM         (1u)            //Receive FIFOs in use, FIFO 0 is drained by the receive interrupt
+#define HAL_CAN_FD_EN               (0u)            //1: CAN FD mode and 64 byte frame buffers, 0: classic frames only, 8 byte buffers
+#if HAL_CAN_FD_EN
+#define HAL_CAN_MAX_DATA_LEN        (64u)           //CAN FD payload, classic frames carry up to 8 bytes
+#else
+#define HAL_CAN_MAX_DATA_LEN        (8u)            //Classic payload, keeps CAN_MSG_T at 32 bytes instead of 88
+#endif
+
+//Error events of CAN_ERR_FLG_T, latched by the controller until read.
+#define HAL_CAN_ERR_BUS             (0x0001u)       //Bus error, any of stuff, form, ACK, CRC or bit error
+#define HAL_CAN_ERR_PASSIVE         (0x0004u)       //Error passive entered
+#define HAL_CAN_ERR_BUS_OFF         (0x0008u)       //Bus off entered
+#define HAL_CAN_ERR_BUS_ON          (0x0010u)       //Bus off left, 128 x 11 recessive bits seen
+
 typedef struct 
 {
-    U32 u32MsgId;
-    U8 u8Dlc;
-    U8 aU8Data[8];
+    U32 u32MsgId;                                   //11 or 29 bit identifier depending on bIde
+    BOOL_T bIde;                                    //Identifier extension, TRUE: 29 bit extended ID, FALSE: 11 bit standard ID
+    BOOL_T bFdf;                                    //TRUE: CAN FD frame, FALSE: classic frame
+    BOOL_T bBrs;                                    //Bit rate switch, data phase at the data bit rate, CAN FD frames only
+    U8 u8Dlc;                                       //Data length in bytes, FD lengths above 8 are padded to 12, 16, 20, 24, 32, 48 or 64 on Tx
+    U8 aU8Data[HAL_CAN_MAX_DATA_LEN];
+    U32 u32Timestamp;                               //Receive time in HAL_CAN_TIMESTAMP_HZ counts, wraps, not used for Tx
 }CAN_MSG_T;
 
-//:Need TBD
-struct CANFD_MSG_T
-{
-    U32 u32MsgId;
-    U8 u8Dlc;
-    U8 aU8Data[64];
-};
+typedef void (*HAL_CAN_RX_CB_T)(void);
 
 typedef enum 
 {
@@ -54,14 +70,18 @@ typedef enum
 typedef struct 
 {
     BOOL_T bBusOff;
+    BOOL_T bErrPassive;
     U8 u8TxErr;
     U8 u8RxErr;
+    U16 u16Events;                                  //HAL_CAN_ERR_* events since the last call
 }CAN_ERR_FLG_T;
 
 typedef struct
 {
     U32 u32CanID;
     U32 u32MaskValue;
+    BOOL_T bIde;                                    //TRUE to match extended ID frames only, FALSE for standard ID frames only
+    U8 u8RxFifo;                                    //Destination receive FIFO, below HAL_CAN_RX_FIFO_NUM
 }CANID_MASKVALUE_T;
 
 /**
@@ -90,6 +110,15 @@ extern BOOL_T hal_can_bSetBaudRate (CAN_BAUD_RATE_T eBaudRate);
 */
 extern BOOL_T hal_can_bTxMsg (const CAN_MSG_T* sCanMsg);
 
+/**
+ * @brief                   Function to check whether a frame with the same ID is still waiting in a transmit buffer.
+ *                          The controller sends buffers of equal ID lowest buffer first, not in load order.
+ * @param      sCanMsg      Pointer to Tx message
+ * @return                  TRUE:               If a frame with this ID and format is pending.
+ *                          FALSE:              Otherwise.
+*/
+extern BOOL_T hal_can_bTxIdPending (const CAN_MSG_T* sCanMsg);
+
 /**
  * @brief                   Function to Set CAN Module baudrate.
  * @param      sCanMsg      Pointer to Rx message
@@ -99,14 +128,55 @@ extern BOOL_T hal_can_bTxMsg (const CAN_MSG_T* sCanMsg);
 extern BOOL_T hal_can_bRxMsg (CAN_MSG_T* sCanMsg);
 
 /**
- * @brief                   Function to Get CAN Module Error state.
- * @param      sCANErr      Pointer to CAN_ERR_FLG_T
+ * @brief                   Function to check and clear the receive FIFO message lost flag.
+ * @return                  TRUE:               If frames were lost since the last call.
+ *                          FALSE:              No frame lost.
+*/
+extern BOOL_T hal_can_bRxLost (void);
+
+/**
+ * @brief                   Function to set the receive FIFO interrupt callback.
+ * @param      pfnRxCb      Called from the interrupt when frames are received, it must read them with hal_can_bRxMsg.
+*/
+extern void hal_can_vSetRxCallback (HAL_CAN_RX_CB_T pfnRxCb);
+
+/**
+ * @brief                   Function to read the receive timestamp clock.
+ * @return                  Current time in HAL_CAN_TIMESTAMP_HZ counts, same clock as CAN_MSG_T u32Timestamp.
+*/
+extern U32 hal_can_u32GetTimestamp (void);
+
+/**
+ * @brief                   Function to read the bit rate set at init.
+ * @param      bDataPhase   TRUE: CAN FD data phase bit rate, FALSE: nominal bit rate.
+ * @return                  Bit rate in bit/s, the nominal bit rate for the data phase when CAN FD is disabled.
+*/
+extern U32 hal_can_u32GetBitRate (BOOL_T bDataPhase);
+
+/**
+ * @brief                   Function to Get CAN Module Error state, the error events are cleared.
+ * @param      psCANErr     Pointer to CAN_ERR_FLG_T
+*/
+extern void hal_can_vGetError (CAN_ERR_FLG_T* psCANErr);
+
+/**
+ * @brief                   Function to Configure Rx filter, to be called in global reset mode.
+ *                          A frame is accepted when (ID & u32MaskValue) == (u32CanID & u32MaskValue) for any rule.
+ * @param      psRules      Receive rules, can be NULL when u16Count is 0.
+ * @param      u16Count     Number of rules, up to HAL_CAN_RX_RULE_MAX, 0 rejects all frames.
+ * @return                  TRUE:               Success.
+ *                          FALSE:              If a rule is invalid, nothing written.
 */
-extern void hal_can_vGetError (CAN_ERR_FLG_T sCANErr);
+extern BOOL_T hal_can_bConfRxFilter (const CANID_MASKVALUE_T* psRules, U16 u16Count);
 
 /**
- * @brief                   Function to Configure Rx filter
+ * @brief                   Function to replace the Rx filter while the controller is running.
+ *                          The controller goes through global reset, frames in its FIFOs and pending transmissions are lost.
+ * @param      psRules      Receive rules, see hal_can_bConfRxFilter.
+ * @param      u16Count     Number of rules.
+ * @return                  TRUE:               Success.
+ *                          FALSE:              If a rule is invalid or a mode change timed out.
 */
-extern BOOL_T hal_can_bConfRxFilter (void); 
+extern BOOL_T hal_can_bSetRxFilter (const CANID_MASKVALUE_T* psRules, U16 u16Count); 
 
 #endif
\ No newline at end of file
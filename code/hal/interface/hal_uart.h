@@ -51,6 +51,12 @@ typedef struct
     uint32_t baud;
 } HalUartConfig_t;
 
+/**
+ *  @brief                                  Receive notification, called from the receive interrupt for every byte.
+ *                                          The byte is already in the receive buffer, keep this short.
+*/
+typedef void (*HalUartRxCallback_t)         (uint8_t byte);
+
 /**
  *  @brief                                  Creates a handle for the identify.
  *  @param      handlePtr                   On success, user provided handle will be updated and can be then be used for further API usage.
@@ -198,4 +204,14 @@ HalUartErr_n hal_uart_get_identity          (HalUartHandle_t handle, HalUartIden
 */
 HalUartErr_n hal_uart_get_config            (HalUartHandle_t handle, HalUartConfig_t* configPtr);
 
+/**
+ *  @brief                                  Sets the function notified of received bytes.
+ *  @param      handle                      A valid handle to UART.
+ *  @param      callback                    Receive notification, NULL to stop notifications.
+ *  @return                                 HalUartErrOk:               Success.
+ *                                          HalUartErrParam:            If handle is NULL.
+ *                                          HalUartErrForbidden:        If handle is not created.
+*/
+HalUartErr_n hal_uart_set_rx_callback       (HalUartHandle_t handle, HalUartRxCallback_t callback);
+
 #endif /* HAL_UART_H */
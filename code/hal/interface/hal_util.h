@@ -22,6 +22,7 @@
 #include <stddef.h>
 
 #define hal_util_assert(e)                  ((e) ? (void)0 : abort())
+#define HAL_UTIL_COUNTER_HZ                 ( 60UL * 1000UL * 1000UL )      // Free running counter clock (OSTM1, started by tcu_time_init).
 
 void hal_util_inc_mem_create                (uint8_t* buf, size_t bufSize, uint8_t incrementingSeed);
 bool hal_util_inc_mem_check                 (uint8_t* buf, size_t bufSize, uint8_t incrementingSeed);
@@ -29,6 +30,7 @@ void hal_util_static_mem_create             (uint8_t* buf, size_t bufSize, uint8
 bool hal_util_static_mem_check              (uint8_t* buf, size_t bufSize, uint8_t byte);
 void hal_util_delay                         (uint32_t delayMs);
 void hal_util_delay_us                      (uint32_t delayUs);
+uint32_t hal_util_counter                   (void);
 void* hal_util_memset                       (void *dest, int byte, size_t sizeDest);
 void* hal_util_memcpy                       (void *dest, const void *src, size_t sizeDest);
 size_t hal_util_strncpy                     (char* dest, const char* src, size_t sizeDest);
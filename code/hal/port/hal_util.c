@@ -25,6 +25,7 @@
  * Individual modules should either use HAL delay or OSAL delay based on their circumstantial requirements.
 */
 #include "osal.h"
+#include "iodefine.h"
 
 void hal_util_inc_mem_create                (uint8_t* buf, size_t bufSize, uint8_t incrementingSeed)
 {
@@ -103,6 +104,12 @@ void hal_util_delay_us                      (uint32_t delayUs)
     }
 }
 
+uint32_t hal_util_counter                   (void)
+{
+    // OSTM1 counts down from 0xFFFFFFFF, invert it so differences of two readings are elapsed counts.
+    return 0xFFFFFFFFUL - OSTM1.CNT;
+}
+
 void* hal_util_memset                       (void* dest, int byte, size_t sizeDest)
 {
     size_t index = 0;
@@ -15,22 +15,53 @@
  * @brief       CAN Driver Source file.
  */
 
+//Standard includes.
+#include <stddef.h>
+
  //Driver interface includes.
 #include "drv_can.h"
+#include "r_cg_macrodriver.h"
 
-#define READ_RX_COUNT           ( 8 )
+//Written by the receive FIFO interrupt, read by the application.
 static struct DRV_CAN_RX_BUFF_T{
     CAN_MSG_T asRxBuff[DRV_CAN_RX_BUFF_SIZE_D];     //Receive Buffer
-    U16 u16BufWrPtr;                                //Receive Buffer Write pointer
-    U16 u16BufRdPtr;                                //Receive Buffer Read pointer
+    volatile U16 u16BufWrPtr;                       //Receive Buffer Write pointer
+    volatile U16 u16BufRdPtr;                       //Receive Buffer Read pointer
 }drv_can_sRxBuff;
 
+static DRV_CAN_RX_STATS_T drv_can_sRxStats;
+
+typedef struct
+{
+    CAN_MSG_T sMsg;
+    U32 u32Key;                                     //Arbitration field, see drv_can_u32ArbKey
+    U32 u32Seq;                                     //Arrival order, keeps frames of the same ID in order
+    U32 u32Tick;                                    //Periodic task tick when queued, for the queueing delay
+}DRV_CAN_TX_ENTRY_T;
+
+//Transmit queue is a binary min-heap on CAN ID so the highest priority frame is loaded first, like bus arbitration.
 static struct DRV_CAN_TX_FIFO_T{
-    CAN_MSG_T asTxFifo[DRV_CAN_TX_FIFO_SIZE_D];      //Transmit Buffer
-    U16 u16FifoWrPtr;                                //Transmit Buffer Write pointer
-    U16 u16FifoRdPtr;                                //Transmit Buffer Read pointer
+    DRV_CAN_TX_ENTRY_T asTxFifo[DRV_CAN_TX_FIFO_SIZE_D];    //Transmit Buffer
+    U16 u16Count;                                           //Frames queued
+    U32 u32Seq;                                             //Next arrival number
 }drv_can_sTxFifo;
 
+static DRV_CAN_TX_STATS_T drv_can_sTxStats;
+static U32 drv_can_u32Tick;                         //Periodic task calls
+static DRV_CAN_TRACE_CB_T drv_can_pfnTraceCb = NULL;
+
+//Frames and bus time of the current measurement window, counted by the transmit and receive handlers.
+static struct DRV_CAN_BUS_WINDOW_T{
+    U32 u32Start;                                   //Timestamp clock at the start of the window
+    U32 u32RxFrames;
+    U32 u32TxFrames;
+    U32 u32NominalBits;                             //Bits sent at the nominal bit rate
+    U32 u32DataBits;                                //Bits sent at the data bit rate, data phase of CAN FD frames with BRS
+}drv_can_sBusWindow;
+
+static DRV_CAN_BUS_STATS_T drv_can_sBusStats;
+static volatile BOOL_T drv_can_bTxHold = FALSE;     //Set while the controller is in reset for a filter change
+
 typedef enum 
 {
     STATE_INIT,
@@ -39,25 +70,48 @@ typedef enum
     STATE_SHUTDOWN
 }drv_can_state_n;
 
-static CANID_MASKVALUE_T g_CanIdMaskValDetails[] =
-{
-    { 0x30E, 0x00000FFE },                          //will allow ID 0x30E and 0x30F
-    { 0x310, 0x00000F00 },                          //will allow ID 0x310, 0x31C, 0x31D and 0x361
-    { 0x600, 0x00000F00 },                          //will allow ID 0x600, 0x601, 0x603
-    { 0x09A, 0x00000088 }                           //will allow ID 0x09A, 0x0AD, 0x0AE
-};
-
-#define CANID_MASKVAL_TABLE_SIZE    (sizeof(g_CanIdMaskValDetails)/sizeof(g_CanIdMaskValDetails[0]))
-
 /**
  *  @brief         CAN Driver Transmit handler.
 */
 static DRV_CAN_BUFF_STAT_T drv_can_bTxHandler(void);
 
 /**
- *  @brief         CAN Driver Transmit handler.
+ *  @brief         Gives the arbitration field of a data frame as a number, the lower value wins arbitration.
+ *                 Base ID, then SRR and IDE (recessive for extended frames), then the 18 ID extension bits.
+*/
+static U32 drv_can_u32ArbKey(const CAN_MSG_T* psMsg);
+
+/**
+ *  @brief         Tells whether queue entry A goes on the bus before entry B, arbitration order then arrival order.
+*/
+static BOOL_T drv_can_bTxBefore(const DRV_CAN_TX_ENTRY_T* psA, const DRV_CAN_TX_ENTRY_T* psB);
+
+/**
+ *  @brief         Removes the head of the transmit queue.
+*/
+static void drv_can_vTxPop(void);
+
+/**
+ *  @brief         CAN Driver Receive handler, moves all frames of the receive FIFO into the software buffer.
+ *                 Runs from the receive FIFO interrupt.
 */
-static DRV_CAN_BUFF_STAT_T drv_can_bRxHandler(void);
+static void drv_can_vRxHandler(void);
+
+/**
+ *  @brief         Adds a frame to the measurement window, bit count with worst case bit stuffing.
+*/
+static void drv_can_vCountBusTime(const CAN_MSG_T* psMsg, BOOL_T bTx);
+
+/**
+ *  @brief         Reads the channel error state into the bus statistics.
+ *  @return        TRUE if the channel is bus off.
+*/
+static BOOL_T drv_can_bPollErrors(void);
+
+/**
+ *  @brief         Computes the frame rates and bus load once the measurement window has elapsed.
+*/
+static void drv_can_vCloseWindow(void);
 
 static U8 g_taskState = STATE_INIT;
 
@@ -66,17 +120,19 @@ BOOL_T drv_can_bInit(void)
     BOOL_T bStat = FALSE;
 
     //Intialise Tx & Rx FIFO & Buffer 
-    drv_can_sTxFifo.u16FifoRdPtr = 0;
-    drv_can_sTxFifo.u16FifoWrPtr = 0;
+    drv_can_sTxFifo.u16Count = 0;
+    drv_can_sTxFifo.u32Seq = 0;
 
     drv_can_sRxBuff.u16BufRdPtr = 0;
     drv_can_sRxBuff.u16BufWrPtr = 0;
+    hal_can_vSetRxCallback(drv_can_vRxHandler);
 
     //TODO: Need to send mask table poninter for filter and masking.
-    if ( hal_can_bInit(eCAN1, eCAN_BAUD_500K, FALSE) )
+    if ( hal_can_bInit(eCAN1, eCAN_BAUD_500K, DRV_CAN_FD_EN_D) )
     {
         //Init Success
         bStat = TRUE;
+        drv_can_sBusWindow.u32Start = hal_can_u32GetTimestamp();
         g_taskState = STATE_ACTIVE_OPERATION;
     }
     return bStat;
@@ -85,40 +141,112 @@ BOOL_T drv_can_bInit(void)
 DRV_CAN_BUFF_STAT_T drv_can_bTxMessage(CAN_MSG_T* psMsg)
 {
     volatile U8 u8LpCnt = 0;
-    volatile U8 u8WriteDataPtr = 0;
+    DRV_CAN_TX_ENTRY_T sEntry;
+    U16 u16Idx = 0;
+    U16 u16Parent = 0;
     DRV_CAN_BUFF_STAT_T bStat = eBUFF_ERR;
-    u8WriteDataPtr = drv_can_sTxFifo.u16FifoWrPtr + 1;
 
-    //Check if u8WriteDataPtr reaches to max
-    if(u8WriteDataPtr >= DRV_CAN_TX_FIFO_SIZE_D)
+    if((psMsg->u8Dlc > HAL_CAN_MAX_DATA_LEN) || (psMsg->bFdf && !DRV_CAN_FD_EN_D))
+    {
+        return eBUFF_ERR;
+    }
+
+    sEntry.sMsg.u32MsgId = psMsg->u32MsgId;
+    sEntry.sMsg.bIde = psMsg->bIde;
+    sEntry.sMsg.bFdf = psMsg->bFdf;
+    sEntry.sMsg.bBrs = psMsg->bBrs;
+    sEntry.sMsg.u8Dlc = psMsg->u8Dlc;
+    //copy the data into TxFiFo
+    for(u8LpCnt = 0; u8LpCnt < (psMsg->u8Dlc) ; u8LpCnt++)
     {
-        u8WriteDataPtr = 0;
+        sEntry.sMsg.aU8Data[u8LpCnt] = psMsg->aU8Data[u8LpCnt];
     }
+
+    //Queue is shared with the periodic task of the system thread
+    DI();
     //check for buffer full
-    if(u8WriteDataPtr == drv_can_sTxFifo.u16FifoRdPtr)
+    if(drv_can_sTxFifo.u16Count >= DRV_CAN_TX_FIFO_SIZE_D)
     {
         //buffer is full
+        drv_can_sTxStats.u32TxSwOverflow++;
         bStat = eBUFF_ERR;
     }
     else
     {
-        //copy the msg into TxFiFo
-        drv_can_sTxFifo.asTxFifo[drv_can_sTxFifo.u16FifoWrPtr].u32MsgId = psMsg->u32MsgId;
-        drv_can_sTxFifo.asTxFifo[drv_can_sTxFifo.u16FifoWrPtr].u8Dlc = psMsg->u8Dlc;
+        sEntry.u32Key = drv_can_u32ArbKey(&sEntry.sMsg);
+        sEntry.u32Seq = drv_can_sTxFifo.u32Seq++;
+        sEntry.u32Tick = drv_can_u32Tick;
 
-        //copy the data into TxFiFo
-        for(u8LpCnt = 0; u8LpCnt < (psMsg->u8Dlc) ; u8LpCnt++)
+        //sift up from the new leaf
+        u16Idx = drv_can_sTxFifo.u16Count++;
+        while(u16Idx > 0)
         {
-            drv_can_sTxFifo.asTxFifo[drv_can_sTxFifo.u16FifoWrPtr].aU8Data[u8LpCnt] = psMsg->aU8Data[u8LpCnt];
+            u16Parent = (u16Idx - 1) / 2;
+            if(!drv_can_bTxBefore(&sEntry, &drv_can_sTxFifo.asTxFifo[u16Parent]))
+            {
+                break;
+            }
+            drv_can_sTxFifo.asTxFifo[u16Idx] = drv_can_sTxFifo.asTxFifo[u16Parent];
+            u16Idx = u16Parent;
         }
+        drv_can_sTxFifo.asTxFifo[u16Idx] = sEntry;
 
-        drv_can_sTxFifo.u16FifoWrPtr = u8WriteDataPtr;
+        if(drv_can_sTxFifo.u16Count > drv_can_sTxStats.u16TxQueuePeak)
+        {
+            drv_can_sTxStats.u16TxQueuePeak = drv_can_sTxFifo.u16Count;
+        }
         bStat =  eBUFF_SUCCESS;
     }
+    EI();
     
     return bStat;
 }
 
+void drv_can_vGetTxStats(DRV_CAN_TX_STATS_T* psStats)
+{
+    DI();
+    *psStats = drv_can_sTxStats;
+    EI();
+}
+
+BOOL_T drv_can_bSetRxFilter(const CANID_MASKVALUE_T* psRules, U16 u16Count)
+{
+    BOOL_T bStat = FALSE;
+
+    //Keep the transmit handler off the controller while it is in reset, the mode changes are waited for with interrupts on
+    drv_can_bTxHold = TRUE;
+    bStat = hal_can_bSetRxFilter(psRules, u16Count);
+    drv_can_bTxHold = FALSE;
+
+    return bStat;
+}
+
+void drv_can_vSetTraceCallback(DRV_CAN_TRACE_CB_T pfnTraceCb)
+{
+    DI();
+    drv_can_pfnTraceCb = pfnTraceCb;
+    EI();
+}
+
+void drv_can_vGetRxStats(DRV_CAN_RX_STATS_T* psStats)
+{
+    DI();
+    *psStats = drv_can_sRxStats;
+    EI();
+}
+
+void drv_can_vGetBusStats(DRV_CAN_BUS_STATS_T* psStats)
+{
+    DI();
+    *psStats = drv_can_sBusStats;
+    EI();
+}
+
+DRV_CAN_BUS_STAT_T drv_can_eGetBusState(void)
+{
+    return ( g_taskState == STATE_ERR_HANDLING ) ? CAN_BUS_OFF : CAN_BUS_NORMAL;
+}
+
 DRV_CAN_RX_BUFF_STAT_T drv_can_bReadRecvMsg(CAN_MSG_T *pRxMsg)
 {
     volatile U8 u8LpCnt = 0;
@@ -141,7 +269,11 @@ DRV_CAN_RX_BUFF_STAT_T drv_can_bReadRecvMsg(CAN_MSG_T *pRxMsg)
     {
         //Copy the Message from Rx msg buffer into software buffer
         pRxMsg->u32MsgId = drv_can_sRxBuff.asRxBuff[drv_can_sRxBuff.u16BufRdPtr].u32MsgId;
+        pRxMsg->bIde = drv_can_sRxBuff.asRxBuff[drv_can_sRxBuff.u16BufRdPtr].bIde;
+        pRxMsg->bFdf = drv_can_sRxBuff.asRxBuff[drv_can_sRxBuff.u16BufRdPtr].bFdf;
+        pRxMsg->bBrs = drv_can_sRxBuff.asRxBuff[drv_can_sRxBuff.u16BufRdPtr].bBrs;
         pRxMsg->u8Dlc = drv_can_sRxBuff.asRxBuff[drv_can_sRxBuff.u16BufRdPtr].u8Dlc;
+        pRxMsg->u32Timestamp = drv_can_sRxBuff.asRxBuff[drv_can_sRxBuff.u16BufRdPtr].u32Timestamp;
         
         //Copy the Data from Rx msg buffer into software buffer
         for ( u8LpCnt = 0 ; u8LpCnt < (drv_can_sRxBuff.asRxBuff[drv_can_sRxBuff.u16BufRdPtr].u8Dlc) ; u8LpCnt++ )
@@ -156,57 +288,271 @@ DRV_CAN_RX_BUFF_STAT_T drv_can_bReadRecvMsg(CAN_MSG_T *pRxMsg)
 
 static DRV_CAN_BUFF_STAT_T drv_can_bTxHandler(void)
 { 
-    volatile U16 u16TxDataPtr = 0;
     DRV_CAN_BUFF_STAT_T bStat = eBUFF_ERR;
-    u16TxDataPtr = drv_can_sTxFifo.u16FifoRdPtr + 1;
-    
-    //Check if msg present in TxFiFo
-    if ( drv_can_sTxFifo.u16FifoRdPtr != drv_can_sTxFifo.u16FifoWrPtr )
+    DRV_CAN_TRACE_CB_T pfnTraceCb = NULL;
+    CAN_MSG_T sMsg;
+    U32 u32Delay = 0;
+
+    if ( drv_can_bTxHold )
     {
-        //Check if u16TxDataPtr reaches to max
-        if ( u16TxDataPtr >= DRV_CAN_TX_FIFO_SIZE_D )
+        return bStat;
+    }
+
+    //Load the highest priority frames while the controller has free transmit buffers, one frame per DI section
+    for ( ;; )
+    {
+        DI();
+        //A frame waits while its ID is pending in hardware, equal IDs would go out lowest buffer first instead of in order
+        if ( ( drv_can_sTxFifo.u16Count == 0 ) ||
+             hal_can_bTxIdPending(&drv_can_sTxFifo.asTxFifo[0].sMsg) ||
+             !hal_can_bTxMsg(&drv_can_sTxFifo.asTxFifo[0].sMsg) )
+        {
+            EI();
+            break;
+        }
+        sMsg = drv_can_sTxFifo.asTxFifo[0].sMsg;
+        drv_can_vCountBusTime(&sMsg, TRUE);
+        u32Delay = drv_can_u32Tick - drv_can_sTxFifo.asTxFifo[0].u32Tick;
+        drv_can_sTxStats.u32TxFrames++;
+        drv_can_sTxStats.u32TxDelayTotalTicks += u32Delay;
+        if ( u32Delay > drv_can_sTxStats.u32TxDelayMaxTicks )
         {
-            u16TxDataPtr = 0;
+            drv_can_sTxStats.u32TxDelayMaxTicks = u32Delay;
         }
+        drv_can_vTxPop();
+        pfnTraceCb = drv_can_pfnTraceCb;
+        EI();
 
-        //Send Message to Transmit
-        if ( hal_can_bTxMsg((CAN_MSG_T*)&(drv_can_sTxFifo.asTxFifo[drv_can_sTxFifo.u16FifoRdPtr])) )
+        if ( pfnTraceCb != NULL )
         {
-            drv_can_sTxFifo.u16FifoRdPtr = u16TxDataPtr;
-            bStat = eBUFF_SUCCESS;
+            sMsg.u32Timestamp = hal_can_u32GetTimestamp();
+            pfnTraceCb(&sMsg, TRUE);
         }
+        bStat = eBUFF_SUCCESS;
     }
 
     return bStat;
 }
 
-static DRV_CAN_BUFF_STAT_T drv_can_bRxHandler(void)
+static U32 drv_can_u32ArbKey(const CAN_MSG_T* psMsg)
 {
-    volatile U16 u16RxDataPtr = 0;
-    DRV_CAN_BUFF_STAT_T bStat = eBUFF_ERR;
-    u16RxDataPtr = drv_can_sRxBuff.u16BufWrPtr + 1;
+    if ( psMsg->bIde )
+    {
+        return ( ((psMsg->u32MsgId >> 18) & HAL_CAN_STD_ID_MASK) << 20 ) | ( 0x3UL << 18 ) | ( psMsg->u32MsgId & 0x3FFFFUL );
+    }
+    return ( psMsg->u32MsgId & HAL_CAN_STD_ID_MASK ) << 20;
+}
 
-    //Check if u16RxDataPtr reaches to max
-    if(u16RxDataPtr >= DRV_CAN_RX_BUFF_SIZE_D)
+static BOOL_T drv_can_bTxBefore(const DRV_CAN_TX_ENTRY_T* psA, const DRV_CAN_TX_ENTRY_T* psB)
+{
+    if ( psA->u32Key != psB->u32Key )
     {
-        u16RxDataPtr = 0;
+        return ( psA->u32Key < psB->u32Key ) ? TRUE : FALSE;
     }
-    //check for buffer full
-    if(u16RxDataPtr == drv_can_sRxBuff.u16BufRdPtr)
+    return ( (S32)(psA->u32Seq - psB->u32Seq) < 0 ) ? TRUE : FALSE;
+}
+
+static void drv_can_vTxPop(void)
+{
+    DRV_CAN_TX_ENTRY_T* psLast = NULL;
+    U16 u16Idx = 0;
+    U16 u16Child = 0;
+
+    if ( drv_can_sTxFifo.u16Count == 0 )
     {
-        //buffer full
-        bStat = eBUFF_ERR;
+        return;
     }
-    else
+
+    //move the last leaf to the root and sift it down
+    psLast = &drv_can_sTxFifo.asTxFifo[--drv_can_sTxFifo.u16Count];
+    while ( (u16Child = (2 * u16Idx) + 1) < drv_can_sTxFifo.u16Count )
     {
+        if ( ((u16Child + 1) < drv_can_sTxFifo.u16Count) &&
+             drv_can_bTxBefore(&drv_can_sTxFifo.asTxFifo[u16Child + 1], &drv_can_sTxFifo.asTxFifo[u16Child]) )
+        {
+            u16Child++;
+        }
+        if ( !drv_can_bTxBefore(&drv_can_sTxFifo.asTxFifo[u16Child], psLast) )
+        {
+            break;
+        }
+        drv_can_sTxFifo.asTxFifo[u16Idx] = drv_can_sTxFifo.asTxFifo[u16Child];
+        u16Idx = u16Child;
+    }
+    drv_can_sTxFifo.asTxFifo[u16Idx] = *psLast;
+}
+
+static void drv_can_vRxHandler(void)
+{
+    CAN_MSG_T sDropMsg;
+    U16 u16RxDataPtr = 0;
+    U16 u16Used = 0;
+
+    for ( ;; )
+    {
+        u16RxDataPtr = drv_can_sRxBuff.u16BufWrPtr + 1;
+
+        //Check if u16RxDataPtr reaches to max
+        if(u16RxDataPtr >= DRV_CAN_RX_BUFF_SIZE_D)
+        {
+            u16RxDataPtr = 0;
+        }
+        //check for buffer full
+        if(u16RxDataPtr == drv_can_sRxBuff.u16BufRdPtr)
+        {
+            //buffer full, still empty the receive FIFO so the newest frames are not held back
+            if(!hal_can_bRxMsg(&sDropMsg))
+            {
+                break;
+            }
+            if(drv_can_pfnTraceCb != NULL)
+            {
+                drv_can_pfnTraceCb(&sDropMsg, FALSE);
+            }
+            drv_can_vCountBusTime(&sDropMsg, FALSE);
+            drv_can_sRxStats.u32RxSwOverflow++;
+            continue;
+        }
+
         //Store Received Message in RxBuff
-        if(hal_can_bRxMsg((CAN_MSG_T*)&(drv_can_sRxBuff.asRxBuff[drv_can_sRxBuff.u16BufWrPtr])))
+        if(!hal_can_bRxMsg(&drv_can_sRxBuff.asRxBuff[drv_can_sRxBuff.u16BufWrPtr]))
         {
-            drv_can_sRxBuff.u16BufWrPtr = u16RxDataPtr;
-            bStat = eBUFF_SUCCESS;
+            break;
+        }
+        if(drv_can_pfnTraceCb != NULL)
+        {
+            drv_can_pfnTraceCb(&drv_can_sRxBuff.asRxBuff[drv_can_sRxBuff.u16BufWrPtr], FALSE);
+        }
+        drv_can_vCountBusTime(&drv_can_sRxBuff.asRxBuff[drv_can_sRxBuff.u16BufWrPtr], FALSE);
+        drv_can_sRxBuff.u16BufWrPtr = u16RxDataPtr;
+        drv_can_sRxStats.u32RxFrames++;
+
+        u16Used = (U16)((u16RxDataPtr + DRV_CAN_RX_BUFF_SIZE_D - drv_can_sRxBuff.u16BufRdPtr) % DRV_CAN_RX_BUFF_SIZE_D);
+        if(u16Used > drv_can_sRxStats.u16RxQueuePeak)
+        {
+            drv_can_sRxStats.u16RxQueuePeak = u16Used;
         }
     }
-    return bStat;
+
+    if(hal_can_bRxLost())
+    {
+        drv_can_sRxStats.u32RxHwOverflow++;
+    }
+}
+
+static void drv_can_vCountBusTime(const CAN_MSG_T* psMsg, BOOL_T bTx)
+{
+    U32 u32Data = (U32)psMsg->u8Dlc * 8u;
+    U32 u32Arb = 0;
+    U32 u32Fd = 0;
+
+    if ( !psMsg->bFdf )
+    {
+        //SOF to CRC is stuffed, then CRC delimiter, ACK, EOF and intermission
+        u32Arb = ( psMsg->bIde ? 54u : 34u ) + u32Data;
+        drv_can_sBusWindow.u32NominalBits += u32Arb + ((u32Arb - 1u) / 4u) + 13u;
+    }
+    else
+    {
+        //Arbitration phase up to BRS, data phase from ESI to the CRC with stuff count and fixed stuff bits
+        u32Arb = psMsg->bIde ? 36u : 17u;
+        u32Fd = 5u + u32Data;
+        u32Fd += (u32Fd / 4u) + ( (psMsg->u8Dlc > 16u) ? (4u + 21u + 7u) : (4u + 17u + 6u) );
+        u32Arb += ((u32Arb - 1u) / 4u) + 13u;
+        if ( psMsg->bBrs )
+        {
+            drv_can_sBusWindow.u32NominalBits += u32Arb;
+            drv_can_sBusWindow.u32DataBits += u32Fd;
+        }
+        else
+        {
+            drv_can_sBusWindow.u32NominalBits += u32Arb + u32Fd;
+        }
+    }
+
+    if ( bTx )
+    {
+        drv_can_sBusWindow.u32TxFrames++;
+    }
+    else
+    {
+        drv_can_sBusWindow.u32RxFrames++;
+    }
+}
+
+static BOOL_T drv_can_bPollErrors(void)
+{
+    CAN_ERR_FLG_T sErr;
+
+    hal_can_vGetError(&sErr);
+
+    DI();
+    drv_can_sBusStats.u8TxErrCnt = sErr.u8TxErr;
+    drv_can_sBusStats.u8RxErrCnt = sErr.u8RxErr;
+    drv_can_sBusStats.bErrPassive = sErr.bErrPassive;
+    if ( sErr.u16Events & HAL_CAN_ERR_BUS )
+    {
+        drv_can_sBusStats.u32BusErrors++;
+    }
+    if ( sErr.u16Events & HAL_CAN_ERR_PASSIVE )
+    {
+        drv_can_sBusStats.u32ErrPassiveCount++;
+    }
+    if ( sErr.u16Events & HAL_CAN_ERR_BUS_OFF )
+    {
+        drv_can_sBusStats.u32BusOffCount++;
+    }
+    if ( sErr.u16Events & HAL_CAN_ERR_BUS_ON )
+    {
+        drv_can_sBusStats.u32BusOffRecoveries++;
+    }
+    EI();
+
+    return sErr.bBusOff;
+}
+
+static void drv_can_vCloseWindow(void)
+{
+    struct DRV_CAN_BUS_WINDOW_T sWindow;
+    U32 u32Now = hal_can_u32GetTimestamp();
+    U32 u32WindowMs = (u32Now - drv_can_sBusWindow.u32Start) / (HAL_CAN_TIMESTAMP_HZ / 1000UL);
+    U32 u32NominalNs = 1000000000UL / hal_can_u32GetBitRate(FALSE);
+    U32 u32DataNs = 1000000000UL / hal_can_u32GetBitRate(TRUE);
+    U32 u32BusUs = 0;
+    U32 u32Load = 0;
+
+    if ( u32WindowMs < DRV_CAN_STATS_WINDOW_MSEC_D )
+    {
+        return;
+    }
+
+    DI();
+    sWindow = drv_can_sBusWindow;
+    drv_can_sBusWindow.u32Start = u32Now;
+    drv_can_sBusWindow.u32RxFrames = 0;
+    drv_can_sBusWindow.u32TxFrames = 0;
+    drv_can_sBusWindow.u32NominalBits = 0;
+    drv_can_sBusWindow.u32DataBits = 0;
+    EI();
+
+    //Bus time in us, split so a long window does not overflow
+    u32BusUs = ((sWindow.u32NominalBits / 1000UL) * u32NominalNs) + (((sWindow.u32NominalBits % 1000UL) * u32NominalNs) / 1000UL);
+    u32BusUs += ((sWindow.u32DataBits / 1000UL) * u32DataNs) + (((sWindow.u32DataBits % 1000UL) * u32DataNs) / 1000UL);
+    u32Load = u32BusUs / u32WindowMs;
+    if ( u32Load > 1000UL )
+    {
+        u32Load = 1000UL;                           //Worst case stuffing overestimates a fully loaded bus
+    }
+
+    DI();
+    drv_can_sBusStats.u32RxFramesPerSec = (sWindow.u32RxFrames * 1000UL) / u32WindowMs;
+    drv_can_sBusStats.u32TxFramesPerSec = (sWindow.u32TxFrames * 1000UL) / u32WindowMs;
+    drv_can_sBusStats.u16BusLoadPermille = (U16)u32Load;
+    if ( drv_can_sBusStats.u16BusLoadPermille > drv_can_sBusStats.u16BusLoadPeakPermille )
+    {
+        drv_can_sBusStats.u16BusLoadPeakPermille = drv_can_sBusStats.u16BusLoadPermille;
+    }
+    EI();
 }
 
 void drv_can_bPeriodicTask(void)
@@ -224,29 +570,32 @@ void drv_can_bPeriodicTask(void)
         
         case STATE_ACTIVE_OPERATION:
         {
-            if ( 0 )    //TODO: if error occurs change state to STATE_ERR_HANDLING else do normal operations
+            drv_can_u32Tick++;
+            if ( drv_can_bPollErrors() )
             {
+                //Hold the queued frames until the channel is back
                 g_taskState = STATE_ERR_HANDLING;
             }
             else
             {
                 //FIXME: Return code not handled
                 drv_can_bTxHandler();
-                //TODO:Read till Message available in Rx FIFO
-                for ( U8 u8i = 0 ; u8i < READ_RX_COUNT ; u8i++ )
-                {
-                    if( eBUFF_ERR == drv_can_bRxHandler() )
-                    {
-                        break;
-                    }
-                }
+                //Received frames are moved by the receive FIFO interrupt
             }
+            drv_can_vCloseWindow();
         }
         break;
 
         case STATE_ERR_HANDLING:
         {
-            // Handle Bus-off here.
+            drv_can_u32Tick++;
+            //Controller leaves bus off after 128 x 11 recessive bits, it is not forced back so a faulty node stays off the bus
+            if ( !drv_can_bPollErrors() )
+            {
+                g_taskState = STATE_ACTIVE_OPERATION;
+                drv_can_bTxHandler();
+            }
+            drv_can_vCloseWindow();
         }
         break;
 
@@ -14,12 +14,77 @@
  * @brief       CAN Hardware Abstration Layer Source file.
  */
  
+#include <stddef.h>
 #include "hal_can.h"
 #include "r_cg_userdefine.h"
 
 //Demo code includes.
 #include "r_cg_macrodriver.h"
 
+#define HAL_CAN_TX_BUF_NUM          (16u)       //Transmit buffers of channel 0 used, controller picks the lowest ID among them
+#define HAL_CAN_TMSTS_BUSY          (0x19u)     //TMTARM | TMTRM | TMTSTS, abort or transmit requested or in progress
+
+//Transmit buffer and receive FIFO access windows, each one is 0x80 bytes.
+typedef struct
+{
+    union __tag269 uId;
+    union __tag269 uPtr;
+    union __tag269 uFdCtr;
+    union __tag269 auData[16];
+    U8 au8Reserved[52];
+}HAL_CAN_BUF_REGS_T;
+
+//Receive rule table window, 16 rules of the page selected in CFDGAFLECTR.
+typedef struct
+{
+    union __tag269 uId;
+    union __tag269 uMask;
+    union __tag269 uPtr0;
+    union __tag269 uPtr1;
+}HAL_CAN_RULE_REGS_T;
+
+#define HAL_CAN_RULES_PER_PAGE      (16u)
+#define HAL_CAN_MODE_WAIT_CNT       (100000UL)  //Polls of a status register before a mode change is given up
+#define HAL_CAN_RULE(n)             (((volatile HAL_CAN_RULE_REGS_T*)&RCFDC0.CFDGAFLID0) + (n))
+#define HAL_CAN_TX_BUF(n)           (((volatile HAL_CAN_BUF_REGS_T*)&RCFDC0.CFDTMID0) + (n))
+#define HAL_CAN_RX_FIFO(n)          (((volatile HAL_CAN_BUF_REGS_T*)&RCFDC0.CFDRFID0) + (n))
+#define HAL_CAN_FD_FDF              (0x04u)     //FDF bit of the transmit FD control and receive FD status registers
+#define HAL_CAN_FD_BRS              (0x02u)     //BRS bit of the transmit FD control and receive FD status registers
+#define HAL_CAN_TMC(n)              ((&RCFDC0.CFDTMC0)[(n)])
+#define HAL_CAN_TMSTS(n)            ((&RCFDC0.CFDTMSTS0)[(n)])
+#define HAL_CAN_ID_IDE              (0x80000000UL)  //IDE bit of the ID registers, rule ID and rule mask registers
+#define HAL_CAN_ID_RTR              (0x40000000UL)  //RTR bit of the ID registers, rule ID and rule mask registers
+#define HAL_CAN_TIMESTAMP()         (0xFFFFFFFFUL - OSTM1.CNT)    //OSTM1 is the free running down counter of tcu_time
+
+#define HAL_CAN_STS_PASSIVE         (0x08u)     //EPSTS of the channel status register
+#define HAL_CAN_STS_BUS_OFF         (0x10u)     //BOSTS of the channel status register
+#define HAL_CAN_ERFL_EVENTS         (HAL_CAN_ERR_BUS | HAL_CAN_ERR_PASSIVE | HAL_CAN_ERR_BUS_OFF | HAL_CAN_ERR_BUS_ON)
+#define HAL_CAN_FD_DATA_BPS         (2000000UL) //Data phase bit rate set by hal_can_bInit
+
+static HAL_CAN_RX_CB_T hal_can_pfnRxCb = NULL;
+static U32 hal_can_u32NominalBps = 0;
+static U32 hal_can_u32DataBps = 0;
+
+//Nominal bit rate of each CAN_BAUD_RATE_T.
+static const U32 hal_can_au32Bps[eCAN_BAUD_MAX] = { 125000UL, 250000UL, 500000UL, 1000000UL, 4000000UL };
+
+//Data length of each DLC code.
+static const U8 hal_can_au8DlcLen[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64 };
+
+//Filter installed at init, accepts all standard and extended frames into receive FIFO 0.
+static const CANID_MASKVALUE_T hal_can_asDefaultRules[] =
+{
+    { 0x00000000, 0x00000000, FALSE, 0 },
+    { 0x00000000, 0x00000000, TRUE, 0 }
+};
+
+/**
+ * @brief                   Waits until the masked bits of a status register read the expected value.
+ * @return                  TRUE:               Status reached.
+ *                          FALSE:              If HAL_CAN_MODE_WAIT_CNT polls elapsed.
+*/
+static BOOL_T hal_can_bWaitStatus (volatile U8* pu8Reg, U8 u8Mask, U8 u8Value);
+
 BOOL_T hal_can_bInit (CAN_MCU_MODULE_T eModuleNo, CAN_BAUD_RATE_T eBaudRate, BOOL_T nCanFdEn)
 {
     volatile BOOL_T bStatus = TRUE;
@@ -50,8 +115,19 @@ BOOL_T hal_can_bInit (CAN_MCU_MODULE_T eModuleNo, CAN_BAUD_RATE_T eBaudRate, BOO
     //Configure Baudrate        //:Need TBD
     (void)hal_can_bSetBaudRate(eBaudRate);
 
-    //Configure Rx Filter      //:Need TBD
-    hal_can_bConfRxFilter();
+    if (nCanFdEn)
+    {
+        RCFDC0.CFDC0DCFG.UINT32 = 0x03030E00;           //Data phase 2Mbps, 20Tq, 1,15,4, 80% sampling, SJW 4Tq.
+        RCFDC0.CFDC0FDCFG.UINT32 = 0x000F0200;          //CAN FD mode, transmitter delay compensation, offset 15Tq.
+        hal_can_u32DataBps = HAL_CAN_FD_DATA_BPS;
+    }
+    else
+    {
+        hal_can_u32DataBps = hal_can_u32NominalBps;
+    }
+
+    //Configure Rx Filter
+    (void)hal_can_bConfRxFilter(hal_can_asDefaultRules, sizeof(hal_can_asDefaultRules) / sizeof(hal_can_asDefaultRules[0]));
 
     // Configure Tx MailBox.    //:Need TBD
 
@@ -79,6 +155,7 @@ BOOL_T hal_can_bSetBaudRate (CAN_BAUD_RATE_T eBaudRate)
 
     RCFDC0.CFDGCFG.UINT32 = 0x10;                       //Timestamp, clock selection(clkc-->40MHz), Priority on ID.
     RCFDC0.CFDC0FDCFG.UINT8[HH] = 0x40;                 //Classical CAN only mode is enabled.
+    hal_can_u32NominalBps = (eBaudRate < eCAN_BAUD_MAX) ? hal_can_au32Bps[eBaudRate] : hal_can_au32Bps[eCAN_BAUD_4M];
 
     switch(eBaudRate)
     {
@@ -119,43 +196,88 @@ BOOL_T hal_can_bSetBaudRate (CAN_BAUD_RATE_T eBaudRate)
 
 BOOL_T hal_can_bTxMsg (const CAN_MSG_T* sCanMsg)
 {
-    volatile BOOL_T bStat = FALSE;
-    U32 u32DataL = 0;
-    U32 u32DataH = 0;
+    volatile HAL_CAN_BUF_REGS_T* psBuf = NULL;
+    U32 au32Data[HAL_CAN_MAX_DATA_LEN / 4] = {0};
+    U8 u8MaxLen = sCanMsg->bFdf ? HAL_CAN_MAX_DATA_LEN : 8u;
+    U8 u8Len = (sCanMsg->u8Dlc > u8MaxLen) ? u8MaxLen : sCanMsg->u8Dlc;
+    U8 u8DlcCode = 0;
+    U8 u8Buf = 0;
+    U8 u8i = 0;
+
+    for (u8Buf = 0; u8Buf < HAL_CAN_TX_BUF_NUM; u8Buf++)
+    {
+        if ((HAL_CAN_TMSTS(u8Buf) & HAL_CAN_TMSTS_BUSY) == 0x00)    //Check if no Tx request is pending
+        {
+            break;
+        }
+    }
+    if (u8Buf >= HAL_CAN_TX_BUF_NUM)
+    {
+        return FALSE;                                   //All buffers busy, frame stays queued in the driver
+    }
+
+    //Smallest DLC holding the data, FD padding bytes are sent as 0
+    while (hal_can_au8DlcLen[u8DlcCode] < u8Len)
+    {
+        u8DlcCode++;
+    }
+    for (u8i = 0; u8i < u8Len; u8i++)
+    {
+        au32Data[u8i >> 2] |= ((U32)sCanMsg->aU8Data[u8i] << ((u8i & 0x03u) * 8u));
+    }
 
-    if((RCFDC0.CFDTMSTS0 & 0x01) == 0x00)               //Check if no Tx request is pending
+    psBuf = HAL_CAN_TX_BUF(u8Buf);
+    if (sCanMsg->bIde)                                  //Transmit buffer ID register, data frame
+    {
+        psBuf->uId.UINT32 = HAL_CAN_ID_IDE | (sCanMsg->u32MsgId & HAL_CAN_EXT_ID_MASK);
+    }
+    else
+    {
+        psBuf->uId.UINT32 = sCanMsg->u32MsgId & HAL_CAN_STD_ID_MASK;
+    }
+    psBuf->uPtr.UINT32 = ((U32)u8DlcCode << 28) | ((U32)u8Buf << 16);   //DLC, label value as buffer number
+    if (sCanMsg->bFdf)                                  //Frame format, bit rate switch
     {
-        RCFDC0.CFDTMIEC0.UINT8[0] = 0x01;               //Transmit Buffer 0 interrupt enabled
-        RCFDC0.CFDTMID0.UINT32 = sCanMsg->u32MsgId;     //Transmit buffer ID register
+        psBuf->uFdCtr.UINT32 = HAL_CAN_FD_FDF | (sCanMsg->bBrs ? HAL_CAN_FD_BRS : 0x00u);
+    }
+    else
+    {
+        psBuf->uFdCtr.UINT32 = 0x00;                    //Classic CAN
+    }
+    for (u8i = 0; u8i < ((hal_can_au8DlcLen[u8DlcCode] + 3u) >> 2); u8i++)
+    {
+        psBuf->auData[u8i].UINT32 = au32Data[u8i];
+    }
+
+    HAL_CAN_TMSTS(u8Buf) = 0x00;                        //Clear previous result
+    HAL_CAN_TMC(u8Buf) = 0x01;                          //Request to transmit, Set TMTR bit
+
+    return TRUE;
+}
 
-        //Transmit buffer pointer register
-        RCFDC0.CFDTMPTR0.UINT16[1] = 0x8012;            //8 data bytes, label value as 0x12
-        RCFDC0.CFDTMFDCTR0.UINT8[LL] = 0x00;            //TO CONFIGURE FRAME MODE FOR Classic CAN 
+BOOL_T hal_can_bTxIdPending (const CAN_MSG_T* sCanMsg)
+{
+    U32 u32Id = sCanMsg->bIde ? (HAL_CAN_ID_IDE | (sCanMsg->u32MsgId & HAL_CAN_EXT_ID_MASK)) : (sCanMsg->u32MsgId & HAL_CAN_STD_ID_MASK);
+    U8 u8Buf = 0;
 
-        for (U8 u8i = 0; u8i < sCanMsg->u8Dlc; u8i++)
+    for (u8Buf = 0; u8Buf < HAL_CAN_TX_BUF_NUM; u8Buf++)
+    {
+        if (((HAL_CAN_TMSTS(u8Buf) & HAL_CAN_TMSTS_BUSY) != 0x00) && (HAL_CAN_TX_BUF(u8Buf)->uId.UINT32 == u32Id))
         {
-            if(u8i <= 3)
-            {
-                u32DataL |= ((U32)sCanMsg->aU8Data[u8i] << (u8i * 8));
-                RCFDC0.CFDTMDF0_0.UINT32 = u32DataL;
-            }
-            else
-            {
-                u32DataH |= ((U32)sCanMsg->aU8Data[u8i] << (u8i * 8));
-                RCFDC0.CFDTMDF1_0.UINT32 = u32DataH; 
-            }
+            return TRUE;
         }
-        RCFDC0.CFDTMSTS0 = 0x00;
-        RCFDC0.CFDTMC0 = 0x01;                          //Request to transmit, Set TMTR bit
-        bStat = TRUE;
     }
-
-    return bStat;
+    return FALSE;
 }
 
 BOOL_T hal_can_bRxMsg (CAN_MSG_T* sCanMsg)
 {
+    volatile HAL_CAN_BUF_REGS_T* psFifo = HAL_CAN_RX_FIFO(0);
     volatile BOOL_T bStat = FALSE;
+    U32 u32Id = 0;
+    U32 u32Word = 0;
+    U8 u8Len = 0;
+    U8 u8i = 0;
 
     RCFDC0.CFDRFSTS0.UINT8[0] &= 0xF7;                  //CLEAR RFIF (Receive FIFO Interrupt Request) Flag
 
@@ -163,17 +285,31 @@ BOOL_T hal_can_bRxMsg (CAN_MSG_T* sCanMsg)
     {
         bStat = TRUE;
 
-        sCanMsg->u32MsgId = RCFDC0.CFDRFID0.UINT16[0];              //Receive FIFO Buffer Access ID Register
-        sCanMsg->u8Dlc = (RCFDC0.CFDRFPTR0.UINT8[3] & 0xF0) >> 4;   //Receive FIFO Buffer Access Pointer Register
+        sCanMsg->u32Timestamp = HAL_CAN_TIMESTAMP();
+        u32Id = psFifo->uId.UINT32;                                 //Receive FIFO Buffer Access ID Register
+        sCanMsg->bIde = (u32Id & HAL_CAN_ID_IDE) ? TRUE : FALSE;
+        sCanMsg->u32MsgId = u32Id & (sCanMsg->bIde ? HAL_CAN_EXT_ID_MASK : HAL_CAN_STD_ID_MASK);
+        sCanMsg->bFdf = (psFifo->uFdCtr.UINT32 & HAL_CAN_FD_FDF) ? TRUE : FALSE;   //Receive FIFO Buffer Access FD Status Register
+        sCanMsg->bBrs = (psFifo->uFdCtr.UINT32 & HAL_CAN_FD_BRS) ? TRUE : FALSE;
+        u8Len = hal_can_au8DlcLen[(psFifo->uPtr.UINT8[3] & 0xF0) >> 4];     //Receive FIFO Buffer Access Pointer Register
+        if (!sCanMsg->bFdf && (u8Len > 8u))
+        {
+            u8Len = 8u;                                             //Classic DLC 9 to 15 means 8 bytes
+        }
+        if (u8Len > HAL_CAN_MAX_DATA_LEN)
+        {
+            u8Len = HAL_CAN_MAX_DATA_LEN;                           //Frame buffers sized for classic payloads
+        }
+        sCanMsg->u8Dlc = u8Len;
 
-        sCanMsg->aU8Data[0] = (U8)(RCFDC0.CFDRFDF0_0.UINT32 & 0x000000FF);
-        sCanMsg->aU8Data[1] = (U8)((RCFDC0.CFDRFDF0_0.UINT32 & 0x0000FF00) >> 8);
-        sCanMsg->aU8Data[2] = (U8)((RCFDC0.CFDRFDF0_0.UINT32 & 0x00FF0000) >> 16);
-        sCanMsg->aU8Data[3] = (U8)((RCFDC0.CFDRFDF0_0.UINT32 & 0xFF000000) >> 24);
-        sCanMsg->aU8Data[4] = (U8)(RCFDC0.CFDRFDF1_0.UINT32 & 0x000000FF);
-        sCanMsg->aU8Data[5] = (U8)((RCFDC0.CFDRFDF1_0.UINT32 & 0x0000FF00) >> 8);
-        sCanMsg->aU8Data[6] = (U8)((RCFDC0.CFDRFDF1_0.UINT32 & 0x00FF0000) >> 16);
-        sCanMsg->aU8Data[7] = (U8)((RCFDC0.CFDRFDF1_0.UINT32 & 0xFF000000) >> 24);
+        for (u8i = 0; u8i < u8Len; u8i++)
+        {
+            if ((u8i & 0x03u) == 0)
+            {
+                u32Word = psFifo->auData[u8i >> 2].UINT32;
+            }
+            sCanMsg->aU8Data[u8i] = (U8)(u32Word >> ((u8i & 0x03u) * 8u));
+        }
 
         RCFDC0.CFDRFPCTR0.UINT8[0] = 0xFF;                          //Receive FIFO Buffer Pointer Control Register
                                                                     //(When these bits are set to FFH, the read pointer moves to the next
@@ -183,50 +319,92 @@ BOOL_T hal_can_bRxMsg (CAN_MSG_T* sCanMsg)
     return bStat;
 }
 
-void hal_can_vGetError (CAN_ERR_FLG_T sCANErr)
+BOOL_T hal_can_bRxLost (void)
+{
+    BOOL_T bLost = FALSE;
+
+    if(RCFDC0.CFDRFSTS0.UINT8[0] & 0x04)                //Check RFMLT (Receive FIFO Message Lost) Flag
+    {
+        RCFDC0.CFDRFSTS0.UINT8[0] &= 0xFB;              //Clear RFMLT Flag
+        bLost = TRUE;
+    }
+
+    return bLost;
+}
+
+void hal_can_vSetRxCallback (HAL_CAN_RX_CB_T pfnRxCb)
+{
+    hal_can_pfnRxCb = pfnRxCb;
+}
+
+U32 hal_can_u32GetTimestamp (void)
 {
-    //can_error_status_s status = candrv_Chnl_GetErrorStatus(CAN0_CHANNEL_0);
+    return HAL_CAN_TIMESTAMP();
 }
 
-BOOL_T hal_can_bConfRxFilter (void)
+U32 hal_can_u32GetBitRate (BOOL_T bDataPhase)
 {
-    // RX FIFO
-    RCFDC0.CFDGAFLCFG0.UINT8[HH] = 0x04;        //No. of rules for channel 0
-    RCFDC0.CFDGAFLECTR.UINT8[LH] = 0x01;        //Enable write to receive rule table
-    RCFDC0.CFDGAFLECTR.UINT8[LL] = 0x00;        //Receive rule page no.configuration
+    return bDataPhase ? hal_can_u32DataBps : hal_can_u32NominalBps;
+}
 
-    //Receive rule 1
-    //Receive Rule ID Register
-    RCFDC0.CFDGAFLID0.UINT16[L] = 0x030E;       //Standard, Data frame, 11 bit ID
+void hal_can_vGetError (CAN_ERR_FLG_T* psCANErr)
+{
+    U8 u8Sts = RCFDC0.CFDC0STS.UINT8[LL];               //Channel Status Register
+    U16 u16Flags = RCFDC0.CFDC0ERFL.UINT16[L] & HAL_CAN_ERFL_EVENTS;    //Channel Error Flag Register
 
-    //Receive Rule Mask Register
-    //RCFDC0.CFDGAFLM0.UINT32 = 0x00000FFE;       //ID bits are compared
-    RCFDC0.CFDGAFLM0.UINT32 = 0x00000000;       //ID bits are compared
+    RCFDC0.CFDC0ERFL.UINT16[L] = (U16)~u16Flags;        //Clear the flags read, writing 1 keeps a flag
 
-    //Receive Rule Pointer 0 Register
-    RCFDC0.CFDGAFLP0_0.UINT8[LH] = 0x80;        //Use message buffer no. 0
-    RCFDC0.CFDGAFLP0_0.UINT8[LL] = 0x08;        //DLC 8bytes
+    psCANErr->bBusOff = (u8Sts & HAL_CAN_STS_BUS_OFF) ? TRUE : FALSE;
+    psCANErr->bErrPassive = (u8Sts & HAL_CAN_STS_PASSIVE) ? TRUE : FALSE;
+    psCANErr->u8RxErr = RCFDC0.CFDC0STS.UINT8[HL];      //REC
+    psCANErr->u8TxErr = RCFDC0.CFDC0STS.UINT8[HH];      //TEC
+    psCANErr->u16Events = u16Flags;
+}
 
-    //Receive Rule Pointer 1 Register
-    RCFDC0.CFDGAFLP1_0.UINT32 = 0x01;           //Rx FIFO 0 selected
+BOOL_T hal_can_bConfRxFilter (const CANID_MASKVALUE_T* psRules, U16 u16Count)
+{
+    volatile HAL_CAN_RULE_REGS_T* psRule = NULL;
+    U16 u16i = 0;
+
+    if ((u16Count > HAL_CAN_RX_RULE_MAX) || ((psRules == NULL) && (u16Count > 0)))
+    {
+        return FALSE;
+    }
+    for (u16i = 0; u16i < u16Count; u16i++)
+    {
+        if (psRules[u16i].u8RxFifo >= HAL_CAN_RX_FIFO_NUM)
+        {
+            return FALSE;
+        }
+    }
 
-    //Receive rule 2
-    //Receive Rule ID Register
-    RCFDC0.CFDGAFLID1.UINT16[0] = 0x0310;       //Standard, Data frame, 11 bit ID
+    RCFDC0.CFDGAFLCFG0.UINT8[HH] = (U8)u16Count;        //No. of rules for channel 0
+    RCFDC0.CFDGAFLECTR.UINT8[LH] = 0x01;                //Enable write to receive rule table
 
-    //Receive Rule Mask Register
-    RCFDC0.CFDGAFLM1.UINT32 = 0x00000F00;       //ID bits are compared
+    for (u16i = 0; u16i < u16Count; u16i++)
+    {
+        RCFDC0.CFDGAFLECTR.UINT8[LL] = (U8)(u16i / HAL_CAN_RULES_PER_PAGE);     //Receive rule page no.configuration
+        psRule = HAL_CAN_RULE(u16i % HAL_CAN_RULES_PER_PAGE);
 
-    //Receive Rule Pointer 0 Register
-    RCFDC0.CFDGAFLP0_1.UINT8[LH] = 0x80;        //Use message buffer no. 0
-    RCFDC0.CFDGAFLP0_1.UINT8[LL] = 0x08;        //DLC 8bytes
+        //Receive Rule ID and Mask Register, data and remote frames, IDE always compared
+        if (psRules[u16i].bIde)
+        {
+            psRule->uId.UINT32 = HAL_CAN_ID_IDE | (psRules[u16i].u32CanID & HAL_CAN_EXT_ID_MASK);
+            psRule->uMask.UINT32 = HAL_CAN_ID_IDE | (psRules[u16i].u32MaskValue & HAL_CAN_EXT_ID_MASK);
+        }
+        else
+        {
+            psRule->uId.UINT32 = psRules[u16i].u32CanID & HAL_CAN_STD_ID_MASK;
+            psRule->uMask.UINT32 = HAL_CAN_ID_IDE | (psRules[u16i].u32MaskValue & HAL_CAN_STD_ID_MASK);
+        }
 
-    //Receive Rule Pointer 1 Register
-    RCFDC0.CFDGAFLP1_1.UINT32 = 0x01;           //Receive FIFO 0 selected
+        psRule->uPtr0.UINT32 = (U32)u16i << 16;                             //Label as rule number, no Rx buffer, no DLC check
+        psRule->uPtr1.UINT32 = 0x01UL << psRules[u16i].u8RxFifo;            //Receive FIFO selected
+    }
 
     //Receive Rule Entry Control Register
     RCFDC0.CFDGAFLECTR.UINT8[LH] = 0x00;        //Disable write to receive rule table
-    RCFDC0.CFDRFCC0.UINT16[L] = 0x1271;         // RFIGCV = xxx(don't care),RFIM = 0(interrupt not occurs each time a message has been received.)
+    RCFDC0.CFDRFCC0.UINT16[L] = 0x1273;         // RFIGCV = xxx(don't care),RFIM = 1(interrupt occurs each time a message has been received.)
                                                 // RFDC =0x010 Receive FIFO Buffer Depth Configuration 
                                                 // RFPLS = 0x111 Receive FIFO Buffer Payload Storage Size Select
                                                 // RFIE =1 Receive FIFO Interrupt Enable
@@ -235,6 +413,50 @@ BOOL_T hal_can_bConfRxFilter (void)
 
 }
 
+BOOL_T hal_can_bSetRxFilter (const CANID_MASKVALUE_T* psRules, U16 u16Count)
+{
+    BOOL_T bStat = FALSE;
+
+    //Global reset mode, channel goes to channel reset mode
+    RCFDC0.CFDGCTR.UINT8[LL] = (RCFDC0.CFDGCTR.UINT8[LL] & 0xFC) | 0x01;
+    if (!hal_can_bWaitStatus(&RCFDC0.CFDGSTS.UINT8[LL], 0x01, 0x01))
+    {
+        return FALSE;
+    }
+
+    bStat = hal_can_bConfRxFilter(psRules, u16Count);
+
+    //Back to global operating mode, the rules of the previous filter stay when the new one was rejected
+    RCFDC0.CFDGCTR.UINT8[LL] &= 0xFC;
+    if (!hal_can_bWaitStatus(&RCFDC0.CFDGSTS.UINT8[LL], 0x03, 0x00))
+    {
+        return FALSE;
+    }
+    RCFDC0.CFDRFCC0.UINT8[0] |= 0x01;           //Receive FIFO is used
+
+    RCFDC0.CFDC0CTR.UINT8[LL] &= 0xFC;          //Channel communication mode
+    if (!hal_can_bWaitStatus(&RCFDC0.CFDC0STS.UINT8[LL], 0x03, 0x00))
+    {
+        return FALSE;
+    }
+
+    return bStat;
+}
+
+static BOOL_T hal_can_bWaitStatus (volatile U8* pu8Reg, U8 u8Mask, U8 u8Value)
+{
+    U32 u32Cnt = 0;
+
+    for (u32Cnt = 0; u32Cnt < HAL_CAN_MODE_WAIT_CNT; u32Cnt++)
+    {
+        if ((*pu8Reg & u8Mask) == u8Value)
+        {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
 //**************************************************************************************************************************
 
 #pragma interrupt CAN_Global_Error_ISR(enable=false, channel=22, fpu=true, callt=false)
@@ -250,6 +472,19 @@ BOOL_T hal_can_bConfRxFilter (void)
 
 //**************************************************************************************************************************
 
+#pragma interrupt isr_can_rx(enable=true, fpu=false, callt=false)
+void isr_can_rx(void)
+{
+    RCFDC0.CFDRFSTS0.UINT8[0] &= 0xF7;              //CLEAR RFIF, frames received while draining raise it again
+
+    if(hal_can_pfnRxCb != NULL)
+    {
+        hal_can_pfnRxCb();
+    }
+}
+
+//**************************************************************************************************************************
+
 #pragma interrupt CAN0_Error_ISR(enable=false, channel=24, fpu=true, callt=false)
  void CAN0_Error_ISR(void)
 {
@@ -69,7 +69,7 @@ void rh850_intc1_can_init                  (void)
     canRegs->reg[0]->BITS.RF = RH850_INTC1_REQUEST_CLEAR;           // 0 - No interrupt request is made.
 
     canRegs->reg[1]->BITS.TB = RH850_INTC1_TABLE_VECTOR;            // 1 - Table method.
-    canRegs->reg[1]->BITS.MK = RH850_INTC1_INTERRUPT_DISABLED;      // 1 - Disables interrupt processing.
+    canRegs->reg[1]->BITS.MK = RH850_INTC1_INTERRUPT_ENABLED;       // 0 - Enables interrupt processing, receive FIFO drained in isr_can_rx.
     canRegs->reg[1]->BITS.RF = RH850_INTC1_REQUEST_CLEAR;           // 0 - No interrupt request is made.
 
     canRegs->reg[2]->BITS.TB = RH850_INTC1_TABLE_VECTOR;            // 1 - Table method.
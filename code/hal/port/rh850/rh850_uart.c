@@ -35,7 +35,7 @@
 
 // Circular buffer backing arrays.
 static uint8_t g_bufTxGps[512UL];
-static uint8_t g_bufRxGps[512UL];
+static uint8_t g_bufRxGps[1024UL];
 static uint8_t g_bufTxGsm[16UL * 1024UL];
 static uint8_t g_bufRxGsm[16UL * 1024UL];
 static uint8_t g_bufTxDbg[4096UL];
@@ -58,6 +58,7 @@ typedef struct
     uint32_t magicCreate;                           // Whether created.
     uint32_t magicInit;                             // Whether initialized.
     uint32_t magicOpen;                             // Whether opened.
+    volatile HalUartRxCallback_t rxCallback;        // Receive notification (optional).
 } HalUartContext_t;
 
 typedef struct
@@ -547,6 +548,27 @@ HalUartErr_n hal_uart_get_config            (HalUartHandle_t handle, HalUartConf
     return err;
 }
 
+HalUartErr_n hal_uart_set_rx_callback       (HalUartHandle_t handle, HalUartRxCallback_t callback)
+{
+    HalUartErr_n err = HalUartErrParam;
+    HalUartContext_t* ctx = (HalUartContext_t*) handle;
+
+    if ( ctx )
+    {
+        if ( PORT_DEFS_MAGIC_TRUE == ctx->magicCreate )
+        {
+            ctx->rxCallback = callback;
+            err = HalUartErrOk;
+        }
+        else
+        {
+            err = HalUartErrForbidden;
+        }
+    }
+
+    return err;
+}
+
 HalUartErr_n rh850_uart_get_identity        (HalUartIdentity_t* identityPtr, PortDefsUart_n portDefsUart)
 {
     HalUartErr_n err = HalUartErrParam;
@@ -657,6 +679,12 @@ void isr_gps(void)
         g_isr_gps_ptr_cbuf->mem[g_isr_gps_rear] = g_isr_gps_byte;
         g_isr_gps_ptr_cbuf->rear = g_isr_gps_new_rear;
     }
+
+    // Notify user.
+    if ( g_Context[PortDefsUartGps].rxCallback )
+    {
+        g_Context[PortDefsUartGps].rxCallback((uint8_t) g_isr_gps_byte);
+    }
 }
 
 #pragma interrupt isr_gsm(enable=true, fpu=false, callt=false)
@@ -677,6 +705,12 @@ void isr_gsm(void)
         g_isr_gsm_ptr_cbuf->mem[g_isr_gsm_rear] = g_isr_gsm_byte;
         g_isr_gsm_ptr_cbuf->rear = g_isr_gsm_new_rear;
     }
+
+    // Notify user.
+    if ( g_Context[PortDefsUartGsm].rxCallback )
+    {
+        g_Context[PortDefsUartGsm].rxCallback((uint8_t) g_isr_gsm_byte);
+    }
 }
 
 #pragma interrupt isr_dbg(enable=true, fpu=false, callt=false)
@@ -697,4 +731,10 @@ void isr_dbg(void)
         g_isr_dbg_ptr_cbuf->mem[g_isr_dbg_rear] = g_isr_dbg_byte;
         g_isr_dbg_ptr_cbuf->rear = g_isr_dbg_new_rear;
     }
+
+    // Notify user.
+    if ( g_Context[PortDefsUartDbg].rxCallback )
+    {
+        g_Context[PortDefsUartDbg].rxCallback((uint8_t) g_isr_dbg_byte);
+    }
 }
@@ -2,35 +2,73 @@
 *   @file   logger_can.c
 */
 
+#include <string.h>
+
 #include "logger_can.h"
+#include "drv_can.h"
+
+#include "r_cg_macrodriver.h"
 
+#define LOGGER_CAN_TX_MAX_SLOTS     ( 250UL )   // Longest schedule planned slot by slot, in ticks.
+#define LOGGER_CAN_WORDS(record)    ( ( sizeof(record) + sizeof(uint32_t) - 1 ) / sizeof(uint32_t) )
+
+// Readers copy without locking and retry if the sequence changed under them.
 typedef struct
 {
-    LoggerCan_u record;
-    uint32_t lockBit;       // Single bit is sufficient but 32-bit padding has better perfomance.
+    volatile uint32_t seq;                              // Odd while a write is in progress.
+    volatile uint32_t word[LOGGER_CAN_RECORD_WORDS];
 } LoggerCanRamTable_t;
 
+typedef struct
+{
+    uint8_t words;          // Record size, 0: no record of this type.
+    uint32_t canId;
+    uint16_t periodMs;      // 0: not broadcast.
+    uint8_t bigEndian;      // 1: 32 bit words sent MSB first, 0: bytes sent as stored.
+} LoggerCanRecordDesc_t;
+
+typedef struct
+{
+    uint16_t periodTicks;
+    uint16_t countdown;     // Ticks until the next frame.
+} LoggerCanTxState_t;
+
 static LoggerCanRamTable_t g_ramTable[LoggerCanMax];
 
+// Record descriptors, GpsB and GpsC have no producer yet and are not broadcast.
+static const LoggerCanRecordDesc_t g_recordDesc[LoggerCanMax] =
+{
+    [LoggerCan000_SysA] = { LOGGER_CAN_WORDS(LoggerCan000_SysA_t), 0x100, 100,  1 },
+    [LoggerCan008_GpsA] = { LOGGER_CAN_WORDS(LoggerCan008_GpsA_t), 0x300, 100,  1 },
+    [LoggerCan009_GpsB] = { LOGGER_CAN_WORDS(LoggerCan009_GpsB_t), 0x301, 0,    1 },
+    [LoggerCan010_GpsC] = { LOGGER_CAN_WORDS(LoggerCan010_GpsC_t), 0x302, 0,    1 },
+    [LoggerCan011_GsmA] = { LOGGER_CAN_WORDS(LoggerCan011_GsmA_t), 0x200, 1000, 0 },
+};
+
+static LoggerCanTxState_t g_txState[LoggerCanMax];
+static uint8_t g_txSlots[LOGGER_CAN_TX_MAX_SLOTS];  // Frames planned in each tick, only used by logger_can_tx_init.
+
 // Set the data into RAM table (for state update operation).
 LoggerCanErr_n logger_can_set(LoggerCanType_n type, LoggerCan_u data)
 {
     LoggerCanErr_n err = LoggerCanErrParam;
-    
-    if ( type < ( sizeof(g_ramTable)/sizeof(g_ramTable[0]) ) )
+    uint8_t idx;
+
+    if ( type < LoggerCanMax )
     {
-        while ( g_ramTable[type].lockBit );
-        g_ramTable[type].lockBit = 1;
-        g_ramTable[type].record.gen.data[0] = data.gen.data[0];
-        g_ramTable[type].record.gen.data[1] = data.gen.data[1];
-        g_ramTable[type].record.gen.data[2] = data.gen.data[2];
-        g_ramTable[type].record.gen.data[3] = data.gen.data[3];
-        g_ramTable[type].record.gen.data[4] = data.gen.data[4];
-        g_ramTable[type].record.gen.data[5] = data.gen.data[5];
-        g_ramTable[type].record.gen.data[6] = data.gen.data[6];
-        g_ramTable[type].record.gen.data[7] = data.gen.data[7];
-        g_ramTable[type].lockBit = 0;
-        err = LoggerCanErrOk;
+        if ( g_recordDesc[type].words > 0 )
+        {
+            // Writers of one record can run at different priorities, keep them out of each other's sequence.
+            DI();
+            g_ramTable[type].seq++;
+            for ( idx = 0 ; idx < g_recordDesc[type].words ; ++idx )
+            {
+                g_ramTable[type].word[idx] = data.word[idx];
+            }
+            g_ramTable[type].seq++;
+            EI();
+            err = LoggerCanErrOk;
+        }
     }
     else
     {
@@ -44,32 +82,150 @@ LoggerCanErr_n logger_can_set(LoggerCanType_n type, LoggerCan_u data)
 LoggerCanErr_n logger_can_get(LoggerCanType_n type, LoggerCan_u* data)
 {
     LoggerCanErr_n err = LoggerCanErrParam;
-    
-    if ( type < ( sizeof(g_ramTable)/sizeof(g_ramTable[0]) ) )
+    uint32_t seq;
+    uint8_t idx;
+
+    if ( type < LoggerCanMax )
     {
-        if(LoggerCan000_SysA == type)
+        if ( g_recordDesc[type].words > 0 )
         {
-            data->sysA = g_ramTable[type].record.sysA;
+            do
+            {
+                seq = g_ramTable[type].seq;
+                for ( idx = 0 ; idx < g_recordDesc[type].words ; ++idx )
+                {
+                    data->word[idx] = g_ramTable[type].word[idx];
+                }
+            } while ( ( seq & 1UL ) || ( seq != g_ramTable[type].seq ) );
+            err = LoggerCanErrOk;
         }
-        else if(LoggerCan008_GpsA == type)
+    }
+    else
+    {
+        err = LoggerCanErrUnexpected;
+    }
+
+    return err;
+}
+
+// Plan the phase of each broadcast record, tickMs is the call period of logger_can_tx_exec.
+void logger_can_tx_init(uint32_t tickMs)
+{
+    uint32_t hyperTicks = 1;
+    uint32_t a, b, t;
+    uint32_t slot, worst, sum, bestWorst, bestSum, bestOffset, offset;
+    uint16_t periodTicks;
+    uint8_t type, shortest;
+    uint8_t planned[LoggerCanMax] = {0};
+
+    memset(g_txState, 0x00, sizeof(g_txState));
+    memset(g_txSlots, 0x00, sizeof(g_txSlots));
+    if ( tickMs == 0 )
+    {
+        return;
+    }
+
+    // Schedule repeats after the LCM of the periods, planned over the longest period if that is too long.
+    for ( type = 0 ; type < LoggerCanMax ; ++type )
+    {
+        if ( g_recordDesc[type].periodMs == 0 )
         {
-            data->gpsA = g_ramTable[type].record.gpsA;
+            continue;
         }
-        else if(LoggerCan009_GpsB == type)
+        periodTicks = ( g_recordDesc[type].periodMs > tickMs ) ? ( g_recordDesc[type].periodMs / tickMs ) : 1;
+        g_txState[type].periodTicks = periodTicks;
+        for ( a = hyperTicks, b = periodTicks ; b != 0 ; t = a % b, a = b, b = t );
+        hyperTicks = ( hyperTicks / a ) * periodTicks;
+        if ( hyperTicks > LOGGER_CAN_TX_MAX_SLOTS )
+        {
+            hyperTicks = LOGGER_CAN_TX_MAX_SLOTS;
+        }
+    }
+
+    // Shortest periods first, each record takes the phase whose busiest tick has the fewest frames.
+    for ( ;; )
+    {
+        shortest = LoggerCanMax;
+        for ( type = 0 ; type < LoggerCanMax ; ++type )
         {
-            data->gpsB = g_ramTable[type].record.gpsB;
+            if ( g_txState[type].periodTicks && !planned[type] &&
+                 ( shortest == LoggerCanMax || g_txState[type].periodTicks < g_txState[shortest].periodTicks ) )
+            {
+                shortest = type;
+            }
         }
-        else if(LoggerCan011_GsmA == type)
+        if ( shortest == LoggerCanMax )
         {
-            data->gsmA = g_ramTable[type].record.gsmA;
+            break;
         }
 
-        err = LoggerCanErrOk;
+        periodTicks = g_txState[shortest].periodTicks;
+        bestWorst = 0xFFFFFFFFUL;
+        bestSum = 0xFFFFFFFFUL;
+        bestOffset = 0;
+        for ( offset = 0 ; offset < periodTicks && offset < hyperTicks ; ++offset )
+        {
+            worst = 0;
+            sum = 0;
+            for ( slot = offset ; slot < hyperTicks ; slot += periodTicks )
+            {
+                worst = ( g_txSlots[slot] > worst ) ? g_txSlots[slot] : worst;
+                sum += g_txSlots[slot];
+            }
+            if ( worst < bestWorst || ( worst == bestWorst && sum < bestSum ) )
+            {
+                bestWorst = worst;
+                bestSum = sum;
+                bestOffset = offset;
+            }
+        }
+        for ( slot = bestOffset ; slot < hyperTicks ; slot += periodTicks )
+        {
+            g_txSlots[slot]++;
+        }
+        g_txState[shortest].countdown = (uint16_t)bestOffset;
+        planned[shortest] = 1;
     }
-    else
+}
+
+// Broadcast the records due in this tick, call every tickMs.
+void logger_can_tx_exec(void)
+{
+    CAN_MSG_T canMsg = {0};
+    LoggerCan_u record = {0};
+    uint8_t type;
+    uint8_t idx;
+
+    for ( type = 0 ; type < LoggerCanMax ; ++type )
     {
-        err = LoggerCanErrUnexpected;
-    }
+        if ( g_txState[type].periodTicks == 0 )
+        {
+            continue;
+        }
+        if ( g_txState[type].countdown > 0 )
+        {
+            g_txState[type].countdown--;
+            continue;
+        }
+        g_txState[type].countdown = g_txState[type].periodTicks - 1;
 
-    return err;
+        // A full transmit queue drops this frame, the next period sends fresh data.
+        if ( LoggerCanErrOk == logger_can_get((LoggerCanType_n)type, &record) )
+        {
+            canMsg.u32MsgId = g_recordDesc[type].canId;
+            canMsg.u8Dlc = sizeof(record.gen.data);
+            memcpy(canMsg.aU8Data, record.gen.data, sizeof(record.gen.data));
+            if ( g_recordDesc[type].bigEndian )
+            {
+                for ( idx = 0 ; idx < g_recordDesc[type].words ; ++idx )
+                {
+                    canMsg.aU8Data[idx * 4 + 0] = (uint8_t)( record.word[idx] >> 24 );
+                    canMsg.aU8Data[idx * 4 + 1] = (uint8_t)( record.word[idx] >> 16 );
+                    canMsg.aU8Data[idx * 4 + 2] = (uint8_t)( record.word[idx] >> 8 );
+                    canMsg.aU8Data[idx * 4 + 3] = (uint8_t)( record.word[idx] >> 0 );
+                }
+            }
+            (void)drv_can_bTxMessage(&canMsg);
+        }
+    }
 }
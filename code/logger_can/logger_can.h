@@ -4,6 +4,8 @@
 
 #include <stdint.h>
 
+#define LOGGER_CAN_RECORD_WORDS     ( 2 )   // Largest record, 8 bytes of a CAN frame.
+
 typedef struct {
     uint8_t data[8];
 } LooggerCanGeneric_t;
@@ -14,8 +16,8 @@ typedef struct {
 } LoggerCan000_SysA_t;
 
 typedef struct {
-    float latitude;
-    float longitude;
+    int32_t latitude;       // Degrees * 1e7.
+    int32_t longitude;      // Degrees * 1e7.
 } LoggerCan008_GpsA_t;
 
 typedef struct {
@@ -49,6 +51,7 @@ typedef enum
 typedef union
 {
     LooggerCanGeneric_t gen;
+    uint32_t word[LOGGER_CAN_RECORD_WORDS];
     LoggerCan000_SysA_t sysA;
     LoggerCan008_GpsA_t gpsA;
     LoggerCan009_GpsB_t gpsB;
@@ -68,3 +71,9 @@ LoggerCanErr_n logger_can_set(LoggerCanType_n type, LoggerCan_u data);
 
 // Get the data from RAM table (for CAN transmit operation).
 LoggerCanErr_n logger_can_get(LoggerCanType_n type, LoggerCan_u* data);
+
+// Plan the phase of each broadcast record, tickMs is the call period of logger_can_tx_exec.
+void logger_can_tx_init(uint32_t tickMs);
+
+// Broadcast the records due in this tick, call every tickMs.
+void logger_can_tx_exec(void);
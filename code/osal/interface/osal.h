@@ -36,12 +36,21 @@ OsalErr_n osal_global_init                  (OsalGenericLogger_t system_logger);
 OsalErr_n osal_start                        (void);
 
 /**
- *  @brief                                  Does service related stuff (normally placed in the service thread)
- *                                          Thread Logger feature requires this function.
+ *  @brief                                  Does service related stuff, prints the queued thread logs.
+ *                                          Thread Logger feature requires this function. Call it from the same
+ *                                          thread as osal_logger_deferred_execute, the global logger is not reentrant.
  *  @return                                 OsalErrOk on success, else one of the defined error codes.
 */
 OsalErr_n osal_service_execute              (void);
 
+/**
+ *  @brief                                  Formats and prints the entries queued with osal_logger_deferred.
+ *                                          Place it in a low priority thread, the formatting cost lands there.
+ *                                          Call it from the same thread as osal_service_execute.
+ *  @return                                 OsalErrOk on success, else one of the defined error codes.
+*/
+OsalErr_n osal_logger_deferred_execute      (void);
+
 /**
  *  @brief                                  Creates a thread with given configuration.
  *  @param  ptrHandle                       The created thread handle will be updated into this upon success.
@@ -73,6 +82,48 @@ OsalErr_n osal_thread_get_stats             (OsalThread_t handle, OsalThreadStat
 */
 OsalErr_n osal_logger                       (OsalThread_t handle, const char* fmt, ...);
 
+/**
+ *  @brief                                  Deferred variant of osal_logger for time critical threads.
+ *                                          Only the format pointer and up to 6 arguments are queued, formatting happens
+ *                                          later in osal_logger_deferred_execute, so the output is not limited to one entry.
+ *                                          The queue of a thread is created by its first call.
+ *  @param  handle                          Handle to previously created thread.
+ *  @param  fmt                             Format string, must stay valid until printed (string literal).
+ *                                          Arguments must be 32 bit (no long long or floating point), strings passed
+ *                                          with %s must stay valid until printed as well.
+ *  @return                                 OsalErrOk on success, else one of the defined error codes (never blocks).
+ *  @note                                   Ordering against osal_logger messages of the same thread is not kept.
+*/
+OsalErr_n osal_logger_deferred              (OsalThread_t handle, const char* fmt, ...);
+
+/**
+ *  @brief                                  Sets events on a thread, waking it if it waits for them.
+ *  @param  handle                          Handle to previously created thread.
+ *  @param  events                          Event bits, meaning is agreed between signaller and thread.
+ *  @return                                 OsalErrOk on success, else one of the defined error codes.
+*/
+OsalErr_n osal_event_set                    (OsalThread_t handle, uint32_t events);
+
+/**
+ *  @brief                                  Interrupt variant of osal_event_set.
+ *                                          The woken thread runs as soon as the interrupt returns if it has the highest priority.
+ *  @param  handle                          Handle to previously created thread.
+ *  @param  events                          Event bits, meaning is agreed between signaller and thread.
+ *  @return                                 OsalErrOk on success, else one of the defined error codes.
+*/
+OsalErr_n osal_event_set_from_isr           (OsalThread_t handle, uint32_t events);
+
+/**
+ *  @brief                                  Takes the events set on the calling thread, waiting for some if there are none.
+ *                                          Events that woke a thread configured with wakeOnEvent are included.
+ *  @param  handle                          Handle to the calling thread.
+ *  @param  events                          Taken event bits are set into this (0 on timeout).
+ *  @param  timeoutMs                       Maximum time to wait, 0 to only take pending events.
+ *  @return                                 OsalErrOk if events were taken, OsalErrTimeout if none,
+ *                                          else one of the defined error codes.
+*/
+OsalErr_n osal_event_take                   (OsalThread_t handle, uint32_t* events, uint32_t timeoutMs);
+
 /**
  *  @brief                                  Sets state variable for periodic execute timer.
  *  @param  currentTick                     Variable to initialize.
@@ -86,6 +137,7 @@ OsalErr_n osal_tmr_init                     (uint32_t* currentTick);
  *  @param  periodMs                        Periodicity in miliseconds.
  *  @param  lastTick                        Pointer to tick value (state variable whose memory is managed by caller).
  *  @return                                 OsalErrOk on success, else one of the defined error codes.
+ *  @note                                   Has to be polled, osal_timer.h timers expire on their own.
 */
 OsalErr_n osal_tmr_exec                     (OsalProcedure_t execute, uint32_t periodMs, uint32_t* lastTick);
 
@@ -103,4 +155,12 @@ OsalErr_n osal_delay                        (uint32_t delayMs);
 */
 OsalErr_n osal_tick_get                     (uint32_t* tick);
 
+/**
+ *  @brief                                  Time since the scheduler started, use this instead of counting loops.
+ *                                          Correct at any tick rate and across tickless idle periods, does not wrap.
+ *  @param  ms                              Time in miliseconds will be updated into this.
+ *  @return                                 OsalErrOk on success, else one of the defined error codes.
+*/
+OsalErr_n osal_time_ms                      (uint64_t* ms);
+
 #endif /* OSAL_H */
@@ -0,0 +1,86 @@
+/**
+ * @file        osal_timer.h
+ *
+ * @copyright   Accolade Electronics Pvt Ltd, 2023-24
+ *              All Rights Reserved
+ *              UNPUBLISHED, LICENSED SOFTWARE.
+ *              Accolade Electronics, Pune
+ *              CONFIDENTIAL AND PROPRIETARY INFORMATION
+ *              WHICH IS THE PROPERTY OF M/s Accolade Electronics.
+ *
+ * @date        19 October 2026
+ * @author      agent <agent@local>
+ *
+ * @brief       OSAL Timer abstraction - header.
+ *
+ * @details     Software timers on a hashed timer wheel, start and stop are O(1) and only the wheel slots that passed
+ *              are visited on execute. Deadlines are kept in 64 bit miliseconds (osal_time_ms) and never wrap.
+ *              On expiry a timer sets events on a thread (see osal_event_take) and/or calls a function from the
+ *              thread running osal_timer_execute.
+ */
+
+#ifndef OSAL_TIMER_H
+#define OSAL_TIMER_H
+
+#include "osal_types.h"
+
+typedef struct
+{
+    uint32_t periodMs;                      // Reload period after expiry (0 means one-shot).
+    OsalProcedure_t fnExpire;               // Called on expiry from osal_timer_execute (optional, keep short).
+    OsalThread_t thread;                    // Thread whose events are set on expiry (optional).
+    uint32_t events;                        // Events set on thread.
+} OsalTimerConfig_t;
+
+/**
+ *  @brief                                  A global init for OSAL Timer.
+ *  @return                                 OsalErrOk on success, else one of the defined error codes.
+*/
+OsalErr_n osal_timer_global_init            (void);
+
+/**
+ *  @brief                                  Creates a stopped timer.
+ *  @param  ptrTimer                        Pointer to handle where created timer will be updated into.
+ *  @param  config                          Configuration.
+ *  @return                                 OsalErrOk on success, else one of the defined error codes.
+*/
+OsalErr_n osal_timer_create                 (OsalTimer_t* ptrTimer, const OsalTimerConfig_t* config);
+
+/**
+ *  @brief                                  Stops and destroys a timer.
+ *  @param  timer                           Handle to a previously created timer.
+ *  @return                                 OsalErrOk on success, else one of the defined error codes.
+*/
+OsalErr_n osal_timer_destroy                (OsalTimer_t timer);
+
+/**
+ *  @brief                                  Starts a timer, a running timer is restarted.
+ *  @param  timer                           Handle to a previously created timer.
+ *  @param  timeoutMs                       Time to first expiry.
+ *  @return                                 OsalErrOk on success, else one of the defined error codes.
+*/
+OsalErr_n osal_timer_start                  (OsalTimer_t timer, uint32_t timeoutMs);
+
+/**
+ *  @brief                                  Stops a timer, nothing happens if it is not running.
+ *  @param  timer                           Handle to a previously created timer.
+ *  @return                                 OsalErrOk on success, else one of the defined error codes.
+*/
+OsalErr_n osal_timer_stop                   (OsalTimer_t timer);
+
+/**
+ *  @brief                                  Tells whether a one-shot timer expired since it was last started.
+ *  @param  timer                           Handle to a previously created timer.
+ *  @param  expired                         Result will be set into this.
+ *  @return                                 OsalErrOk on success, else one of the defined error codes.
+*/
+OsalErr_n osal_timer_expired                (OsalTimer_t timer, bool* expired);
+
+/**
+ *  @brief                                  Timer service, expires the due timers.
+ *                                          Must be called from one thread only, as often as the timer precision needed.
+ *  @return                                 OsalErrOk on success, else one of the defined error codes.
+*/
+OsalErr_n osal_timer_execute                (void);
+
+#endif /* OSAL_TIMER_H */
@@ -23,6 +23,7 @@
 
 #define OSAL_TRUE                           ( 0x03A1C0CA )
 #define OSAL_FALSE                          ( 0x03A1DEAF )
+#define OSAL_SLACK_NONE                     ( 0xFFFFFFFFUL )    // usSlackMin of a thread without a period.
 
 /**
  *  @brief                                  Opaque handle for thread.
@@ -34,6 +35,11 @@ typedef struct  OsalThreadContext_t*        OsalThread_t;
 */
 typedef struct  OsalMutexContext_t*         OsalMutex_t;
 
+/**
+ *  @brief                                  Opaque handle for timer.
+*/
+typedef struct  OsalTimerContext_t*         OsalTimer_t;
+
 /**
  *  @brief                                  Prototype for user provided functions.
 */
@@ -88,16 +94,23 @@ typedef struct
     uint32_t stackSize;                     // Stack size in bytes.
     uint32_t periodicityMs;                 // Period at which task should execute (0 means continuous).
     const char* name;                       // Task name (optional).
+    bool wakeOnEvent;                       // Events run the poll function before the period ends (periodic threads).
+    uint8_t stressLoadPct;                  // Busy time added to each run in percent of the period (OSAL_STRESS_EN builds).
 } OsalThreadConfig_t;
 
 typedef struct
 {
     uint32_t countLoops;                    // Number of times loop executed.
     uint32_t msExec;                        // Total execute time for poll function till now.
-    uint32_t msExecSecond;                  // Average exec time for last second.
-    uint32_t msExecMinute;                  // Average exec time for last minute.
-    uint32_t msExecHour;                    // Average exec time for last hour.
-    uint32_t msExecDay;                     // Average exec time for last day.
+    uint32_t usExecLast;                    // Exec time of the last loop.
+    uint32_t usExecMin;                     // Shortest exec time till now.
+    uint32_t usExecMax;                     // Longest exec time till now.
+    uint32_t usSlackMin;                    // Shortest time left before the next period till now (tick resolution, OSAL_SLACK_NONE without a period).
+    uint32_t usExecAvg;                     // Average exec time till now.
+    uint32_t usExecSecond;                  // Average exec time for last second.
+    uint32_t usExecMinute;                  // Average exec time for last minute.
+    uint32_t usExecHour;                    // Average exec time for last hour.
+    uint32_t usExecDay;                     // Average exec time for last day.
 } OsalThreadStats_t;
 
 #endif /* OSAL_TYPES_H */
@@ -47,9 +47,9 @@
  *----------------------------------------------------------*/
 
 #define configUSE_PREEMPTION                    1                               // Using pre-emption is NECESSARY for our use-case.
-#define configUSE_TICKLESS_IDLE                 0                               // TODO: Enabling this feature requires special handling, but will save some MCU power.
+#define configUSE_TICKLESS_IDLE                 0                               // App1-3 run continuously, so the idle task never gets to stop the tick.
 #define configCPU_CLOCK_HZ                      ( SystemCoreClock )             // Make sure this value is matching the actual CPU freq., else you will not get proper timing.
-#define configTICK_RATE_HZ                      ( (TickType_t) 10000UL )        // 10000 Hz == 100 us
+#define configTICK_RATE_HZ                      ( (TickType_t) 1000UL )         // 1000 Hz == 1 ms, application time comes from osal_time_ms.
 #define configMAX_PRIORITIES                    10                              // Number of FreeRTOS task priorities.
 #define configMINIMAL_STACK_SIZE                ( (size_t) 256UL )              // The stack size in words for the idle task (1 word == 4 bytes on 32-bit system).
 #define configMAX_TASK_NAME_LEN                 10                              // Keep the task names shorter than this.
@@ -66,7 +66,7 @@
 /* Memory allocation related definitions. */
 #define configSUPPORT_STATIC_ALLOCATION         1                               // Allows usage of static memory allocation for FreeRTOS primitives - discouraged.
 #define configSUPPORT_DYNAMIC_ALLOCATION        1                               // Allows usage of dynamic memory allocation for FreeRTOS primitives (and in general).
-#define configTOTAL_HEAP_SIZE                   ( (size_t) ( 48UL * 1024UL ) )  // This is the number of **BYTES** reserved for FreeRTOS heap (Not applicable when using heap_5.c)
+#define configTOTAL_HEAP_SIZE                   ( (size_t) ( 49UL * 1024UL ) )  // This is the number of **BYTES** reserved for FreeRTOS heap (Not applicable when using heap_5.c)
 #define configAPPLICATION_ALLOCATED_HEAP        1                               // Allows for user to define 'ucHeap' array to be used by FreeRTOS heap (applicable for heap_1.c to heap_4.c only).
 #define configUSE_HEAP_SCHEME                   4                               // Tells FreeRTOS which one of the 5 heap implementations (heap_1.c to heap_5.c) to use.
 #define configRECORD_STACK_HIGH_ADDRESS         1                               // Adds information (4 bytes) for each that stores where the stack ends. Useful for FreeRTOS TAD.
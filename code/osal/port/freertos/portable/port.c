@@ -31,6 +31,7 @@
 /* Scheduler includes. */
 #include "FreeRTOS.h"
 #include "task.h"
+#include "r_cg_macrodriver.h"
 #include "Config_OSTM0.h"
 
 extern void vPortStart(void);
@@ -52,11 +53,25 @@ extern volatile TCB_t * volatile pxCurrentTCB;
 
 /* Keeps track of the nesting level of critical sections. */
 volatile StackType_t usCriticalNesting = portINITIAL_CRITICAL_NESTING;
+
+/* OSTM0 count clock (CPUCLK_L), the tick period is derived from configTICK_RATE_HZ. */
+#define portTIMER_CLOCK_HZ            ( 60000000UL )
+#define portTIMER_COUNTS_PER_TICK     ( portTIMER_CLOCK_HZ / configTICK_RATE_HZ )
+
+/* The Smart Configurator sets OSTM0 to a 100 us interval from its count clock,
+so a clock change made there shows up in the generated compare value. */
+#if ( ( ( _OSTM0_COMPARING_COUNTER + 1UL ) * 10000UL ) != portTIMER_CLOCK_HZ )
+    #error portTIMER_CLOCK_HZ does not match the OSTM0 count clock of Config_OSTM0.h
+#endif
+
 /*-----------------------------------------------------------*/
 
 /* Sets up the timer to generate the tick interrupt. */
 static void prvSetupTimerInterrupt( void );
 
+/* Sets up the interrupt that switches context on behalf of other interrupts. */
+static void prvSetupYieldInterrupt( void );
+
 /*-----------------------------------------------------------*/
 StackType_t * pxPortInitialiseStack(StackType_t * pxTopOfStack, TaskFunction_t pxCode, void * pvParameters)
 {
@@ -140,6 +155,7 @@ BaseType_t xPortStartScheduler( void )
 	/* Setup the hardware to generate the tick.  Interrupts are disabled when
 	this function is called. */
 	prvSetupTimerInterrupt();
+	prvSetupYieldInterrupt();
 
 	/* Restore the context of the first task that is going to run. */
 	vPortStart();
@@ -162,10 +178,36 @@ void vPortEndScheduler( void )
  */
 static void prvSetupTimerInterrupt( void )
 {
+    R_Config_OSTM0_Set_CompareValue( portTIMER_COUNTS_PER_TICK - 1UL );
     R_Config_OSTM0_Start();
 }
 /*-----------------------------------------------------------*/
 
+/*
+ * Interrupt handlers of this port do not save the task context, so they cannot
+ * switch context themselves.  INTP0 (channel 37) has no pin assigned, its
+ * vector is vPortYield and its request is set by software.  At the lowest
+ * priority it is taken only once every other handler has returned, right
+ * before the interrupted task would resume.
+ */
+static void prvSetupYieldInterrupt( void )
+{
+    INTC2.ICP0.BIT.MKP0 = _INT_PROCESSING_DISABLED;
+    INTC2.ICP0.BIT.RFP0 = _INT_REQUEST_NOT_OCCUR;
+    INTC2.ICP0.BIT.TBP0 = _INT_TABLE_VECTOR;
+    INTC2.ICP0.UINT16 &= _INT_PRIORITY_LOWEST;
+    INTC2.ICP0.BIT.MKP0 = _INT_PROCESSING_ENABLED;
+}
+/*-----------------------------------------------------------*/
+
+void vPortYieldFromISR( void )
+{
+    /* Request flag written by software, the write completes before the caller returns from its interrupt. */
+    INTC2.ICP0.BIT.RFP0 = 1U;
+    __syncp();
+}
+/*-----------------------------------------------------------*/
+
 //=========================================================
 
 
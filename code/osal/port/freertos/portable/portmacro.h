@@ -116,8 +116,8 @@ extern void portRESTORE_CONTEXT( void );
 
 void trap_set(void);
 
-extern void vTaskSwitchContext( void );
-#define portYIELD_FROM_ISR( xHigherPriorityTaskWoken ) if( xHigherPriorityTaskWoken ) vTaskSwitchContext()
+extern void vPortYieldFromISR( void );
+#define portYIELD_FROM_ISR( xHigherPriorityTaskWoken ) if( xHigherPriorityTaskWoken ) vPortYieldFromISR()
 
 /*-----------------------------------------------------------*/
 
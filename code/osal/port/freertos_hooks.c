@@ -16,6 +16,9 @@
 
 #include "FreeRTOS.h"
 #include "task.h"
+#include "hal_util.h"
+
+#define FREERTOS_HOOKS_RUNTIME_SHIFT    ( 6 )       // Run time stats unit is 64 counter clocks, ~1.07 us at 60 MHz.
 
 static StaticTask_t xIdleTaskTCB;
 static StackType_t uxIdleTaskStack[ configMINIMAL_STACK_SIZE ];
@@ -31,18 +34,30 @@ uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
 void FreeRTOS_AppConfigureTimerForRuntimeStats(void);
 void FreeRTOS_AppConfigureTimerForRuntimeStats(void)
 {
+    // Nothing to do, the free running counter (OSTM1) is started by tcu_time_init before the scheduler.
     return;
 }
 
 /**
- * @brief                   Getter function that returns the tick value used for FreeRTOS TAD tracing.
+ * @brief                   Getter function that returns the counter value used for FreeRTOS TAD tracing.
  * @see                     configGENERATE_RUN_TIME_STATS, configUSE_TRACE_FACILITY, configUSE_STATS_FORMATTING_FUNCTIONS, portCONFIGURE_TIMER_FOR_RUN_TIME_STATS
  * @note                    May be exclusively invoked by freertos_kernel/tasks.c
  */
 uint32_t FreeRTOS_AppGetRuntimeCounterValueFromISR(void);
 uint32_t FreeRTOS_AppGetRuntimeCounterValueFromISR(void)
 {
-    return xTaskGetTickCount();
+    // The kernel reads this on every context switch with interrupts disabled, far more often than the 32 bit
+    // counter wraps (~71 seconds), so the wraps are counted here. The prescaled value wraps every ~76 minutes.
+    static uint32_t ulLast = 0;
+    static uint32_t ulWraps = 0;
+    uint32_t ulNow = hal_util_counter();
+
+    if ( ulNow < ulLast )
+    {
+        ulWraps++;
+    }
+    ulLast = ulNow;
+    return ( ulWraps << ( 32 - FREERTOS_HOOKS_RUNTIME_SHIFT ) ) | ( ulNow >> FREERTOS_HOOKS_RUNTIME_SHIFT );
 }
 
 /**
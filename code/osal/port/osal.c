@@ -14,13 +14,20 @@
  * @brief       OSAL abstraction - implementation.
  */
 
+#include <string.h>
+
 #include "osal.h"
 #include "osal_private.h"
 
 #define OSAL_THREAD_COUNT               ( 7UL )
 #define OSAL_LOGGER_DEPTH               ( 16UL )
 #define OSAL_LOGGER_LENGTH              ( 128UL )
+#define OSAL_LOGGER_DEFERRED_DEPTH      ( 32UL )
+#define OSAL_LOGGER_DEFERRED_ARGS       ( 6UL )
+#define OSAL_LOGGER_FORMAT_FLAGS        ( "-+ #0123456789.*hlLjzt" )
 #define OSAL_THREAD_MAX_STACK_SIZE      ( 0xFFFFUL * sizeof(size_t) )
+#define OSAL_COUNTER_PER_US             ( HAL_UTIL_COUNTER_HZ / ( 1000UL * 1000UL ) )
+#define OSAL_US_PER_TICK                ( ( 1000UL * 1000UL ) / configTICK_RATE_HZ )
 
 #define VT100_DEFAULT                   ("\x1B[39m")
 #define VT100_WHITE                     ("\x1B[37m")
@@ -33,24 +40,57 @@
 #define VT100_BLACK                     ("\x1B[30m")
 
 /* Private defines. */
+typedef enum
+{
+    OsalStatsWindowSecond,
+    OsalStatsWindowMinute,
+    OsalStatsWindowHour,
+    OsalStatsWindowDay,
+    OsalStatsWindowMax
+} OsalStatsWindow_n;
+
+typedef struct
+{
+    uint64_t usExec;                        // Exec time accumulated in the open window.
+    uint32_t countLoops;                    // Loops accumulated in the open window.
+    uint32_t countParts;                    // Closed shorter windows accumulated in the open window.
+} OsalStatsWindow_t;
+
+typedef struct
+{
+    const char* fmt;                        // Format string, must outlive the entry.
+    uint32_t args[OSAL_LOGGER_DEFERRED_ARGS];
+} OsalLoggerDeferred_t;
+
 typedef struct
 {
     uint32_t magic;
     TaskHandle_t task;
     QueueHandle_t queue;
+    QueueHandle_t queueDeferred;
     OsalThreadConfig_t config;
     OsalThreadStats_t stats;
+    uint64_t usExecTotal;                   // Exec time till now, msExec and usExecAvg are derived from it.
+    TickType_t tickWindow;                  // Start of the open second window.
+    uint32_t events;                        // Events that woke the thread, not taken yet.
+    OsalStatsWindow_t window[OsalStatsWindowMax];
 } OsalThreadContext_t;
 
 /* Private data. */
 static const char* g_vt100[OSAL_THREAD_COUNT] = {VT100_WHITE, VT100_CYAN, VT100_MAGENTA, VT100_BLUE, VT100_YELLOW, VT100_GREEN, VT100_RED};
 static OsalThreadContext_t g_ctx[OSAL_THREAD_COUNT];
 static OsalGenericLogger_t g_generic_logger;
+static const uint32_t g_windowParts[OsalStatsWindowMax] = {0, 60, 60, 24};     // Shorter windows making up a window.
 
 /* Private functions. */
 static bool verify_config                   (const OsalThreadConfig_t* config);
 static bool get_free_context                (OsalThreadContext_t** ctx);
 static void generic_task                    (void* params);
+static void update_stats                    (OsalThreadContext_t* ctx, uint32_t usExec, uint32_t usSlack);
+#ifdef OSAL_STRESS_EN
+static void stress_load                     (const OsalThreadContext_t* ctx);
+#endif
+static size_t count_args                    (const char* fmt);
 
 OsalErr_n osal_global_init                  (OsalGenericLogger_t system_logger)
 {
@@ -67,6 +107,10 @@ OsalErr_n osal_global_init                  (OsalGenericLogger_t system_logger)
             {
                 err = osal_mutex_global_init();
                 if ( OsalErrOk == err )
+                {
+                    err = osal_timer_global_init();
+                }
+                if ( OsalErrOk == err )
                 {
                     for ( i = 0 ; i < sizeof(g_ctx)/sizeof(g_ctx[0]) ; ++i )
                     {
@@ -157,6 +201,54 @@ OsalErr_n osal_service_execute              (void)
     return err;
 }
 
+OsalErr_n osal_logger_deferred_execute      (void)
+{
+    OsalErr_n err = OsalErrUnexpected;
+    OsalThreadContext_t* ctx;
+    size_t threadNum;
+    size_t qIteration;
+    OsalLoggerDeferred_t entry;
+
+    if ( ( OSAL_FALSE == g_osal_initialized ) || ( OSAL_TRUE == g_osal_initialized ) )
+    {
+        if ( OSAL_TRUE == g_osal_initialized )
+        {
+            if ( ( OSAL_TRUE == g_osal_running ) && g_generic_logger )
+            {
+                for ( threadNum = 0 ; threadNum < sizeof(g_ctx)/sizeof(g_ctx[0]) ; ++threadNum  )
+                {
+                    ctx = &g_ctx[threadNum];
+                    // Formatting happens here, at the priority of the calling thread.
+                    if ( ( OSAL_TRUE == ctx->magic ) && ctx->queueDeferred )
+                    {
+                        for ( qIteration = 0 ; qIteration < OSAL_LOGGER_DEFERRED_DEPTH ; ++qIteration )
+                        {
+                            if ( pdTRUE == xQueueReceive(ctx->queueDeferred, &entry, 0) )
+                            {
+                                g_generic_logger("%s", g_vt100[threadNum]);
+                                g_generic_logger(entry.fmt, entry.args[0], entry.args[1], entry.args[2],
+                                                            entry.args[3], entry.args[4], entry.args[5]);
+                                g_generic_logger("%s", VT100_DEFAULT);
+                            }
+                            else
+                            {
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+            err = OsalErrOk;
+        }
+        else
+        {
+            err = OsalErrForbidden;
+        }
+    }
+
+    return err;
+}
+
 OsalErr_n osal_thread_create                (OsalThread_t* ptrHandle, const OsalThreadConfig_t* config)
 {
     OsalErr_n err = OsalErrUnexpected;
@@ -175,9 +267,14 @@ OsalErr_n osal_thread_create                (OsalThread_t* ptrHandle, const Osal
                     if ( get_free_context(&ctx) )
                     {
                         hal_util_assert ( NULL == ctx->queue );
+                        hal_util_assert ( NULL == ctx->queueDeferred );
                         hal_util_assert ( NULL == ctx->task );
                         hal_util_memcpy(&ctx->config, config, sizeof(ctx->config));
                         hal_util_memset(&ctx->stats, 0, sizeof(ctx->stats));
+                        ctx->stats.usSlackMin = OSAL_SLACK_NONE;
+                        hal_util_memset(ctx->window, 0, sizeof(ctx->window));
+                        ctx->events = 0;
+                        ctx->usExecTotal = 0;
                         taskCreateSuccess = xTaskCreate(generic_task,
                                                         config->name,
                                                         config->stackSize / sizeof(size_t),
@@ -238,8 +335,13 @@ OsalErr_n osal_thread_destroy               (OsalThread_t handle)
                 {
                     vTaskDelete(ctx->task);
                     vQueueDelete(ctx->queue);
+                    if ( ctx->queueDeferred )
+                    {
+                        vQueueDelete(ctx->queueDeferred);
+                    }
                     ctx->task = NULL;
                     ctx->queue = NULL;
+                    ctx->queueDeferred = NULL;
                     ctx->magic = OSAL_FALSE;
                     err = OsalErrOk;
                 }
@@ -278,7 +380,9 @@ OsalErr_n osal_thread_get_stats             (OsalThread_t handle, OsalThreadStat
                 if ( OSAL_TRUE == ctx->magic )
                 {
                     osal_private_lock();
+                    taskENTER_CRITICAL();
                     hal_util_memcpy(stats, &ctx->stats, sizeof(*stats));
+                    taskEXIT_CRITICAL();
                     osal_private_unlock();
                     err = OsalErrOk;
                 }
@@ -349,6 +453,174 @@ OsalErr_n osal_logger                       (OsalThread_t handle, const char* fm
     return err;
 }
 
+OsalErr_n osal_logger_deferred              (OsalThread_t handle, const char* fmt, ...)
+{
+    OsalErr_n err = OsalErrUnexpected;
+    OsalLoggerDeferred_t entry = {0};
+    OsalThreadContext_t* ctx;
+    size_t countArgs;
+    size_t i;
+    va_list args;
+
+    if ( ( OSAL_FALSE == g_osal_initialized ) || ( OSAL_TRUE == g_osal_initialized ) )
+    {
+        if ( OSAL_TRUE == g_osal_initialized )
+        {
+            if ( handle && fmt )
+            {
+                ctx = (OsalThreadContext_t*) handle;
+                countArgs = count_args(fmt);
+                if ( ( OSAL_TRUE == ctx->magic ) && ( countArgs <= OSAL_LOGGER_DEFERRED_ARGS ) )
+                {
+                    // Most threads never defer, their queue is created on first use.
+                    if ( NULL == ctx->queueDeferred )
+                    {
+                        osal_private_lock();
+                        if ( NULL == ctx->queueDeferred )
+                        {
+                            ctx->queueDeferred = xQueueCreate(OSAL_LOGGER_DEFERRED_DEPTH, sizeof(OsalLoggerDeferred_t));
+                        }
+                        osal_private_unlock();
+                    }
+                    // Arguments are 32 bit on this port (int, long, char and pointers alike).
+                    entry.fmt = fmt;
+                    va_start(args, fmt);
+                    for ( i = 0 ; i < countArgs ; ++i )
+                    {
+                        entry.args[i] = va_arg(args, uint32_t);
+                    }
+                    va_end(args);
+                    if ( ctx->queueDeferred && ( pdTRUE == xQueueSend(ctx->queueDeferred, &entry, 0UL) ) )
+                    {
+                        err = OsalErrOk;
+                    }
+                    else
+                    {
+                        err = OsalErrMemory;
+                    }
+                }
+                else
+                {
+                    err = ( OSAL_TRUE == ctx->magic ) ? OsalErrParam : OsalErrUnexpected;
+                }
+            }
+            else
+            {
+                err = OsalErrParam;
+            }
+        }
+        else
+        {
+            err = OsalErrForbidden;
+        }
+    }
+
+    return err;
+}
+
+OsalErr_n osal_event_set                    (OsalThread_t handle, uint32_t events)
+{
+    OsalErr_n err = OsalErrUnexpected;
+    OsalThreadContext_t* ctx;
+
+    if ( ( OSAL_FALSE == g_osal_initialized ) || ( OSAL_TRUE == g_osal_initialized ) )
+    {
+        if ( ( OSAL_TRUE == g_osal_initialized ) && ( OSAL_TRUE == g_osal_running ) )
+        {
+            if ( handle && events )
+            {
+                ctx = (OsalThreadContext_t*) handle;
+                if ( OSAL_TRUE == ctx->magic )
+                {
+                    (void) xTaskNotify(ctx->task, events, eSetBits);
+                    err = OsalErrOk;
+                }
+                else
+                {
+                    err = OsalErrUnexpected;
+                }
+            }
+            else
+            {
+                err = OsalErrParam;
+            }
+        }
+        else
+        {
+            err = OsalErrNotStarted;
+        }
+    }
+
+    return err;
+}
+
+OsalErr_n osal_event_set_from_isr           (OsalThread_t handle, uint32_t events)
+{
+    OsalErr_n err = OsalErrNotStarted;
+    OsalThreadContext_t* ctx = (OsalThreadContext_t*) handle;
+    BaseType_t woken = pdFALSE;
+
+    if ( OSAL_TRUE == g_osal_running )
+    {
+        err = OsalErrParam;
+        if ( ctx && events && ( OSAL_TRUE == ctx->magic ) )
+        {
+            /**
+             * Interrupts of this port run with interrupts enabled and without the kernel entry/exit code, so the
+             * kernel is entered with interrupts disabled. The handler cannot switch context itself, the port takes
+             * its yield interrupt once the handler returned and the woken thread runs right away.
+            */
+            portDISABLE_INTERRUPTS();
+            (void) xTaskNotifyFromISR(ctx->task, events, eSetBits, &woken);
+            portENABLE_INTERRUPTS();
+            portYIELD_FROM_ISR(woken);
+            err = OsalErrOk;
+        }
+    }
+
+    return err;
+}
+
+OsalErr_n osal_event_take                   (OsalThread_t handle, uint32_t* events, uint32_t timeoutMs)
+{
+    OsalErr_n err = OsalErrUnexpected;
+    OsalThreadContext_t* ctx;
+    uint32_t notified = 0;
+
+    if ( ( OSAL_FALSE == g_osal_initialized ) || ( OSAL_TRUE == g_osal_initialized ) )
+    {
+        if ( ( OSAL_TRUE == g_osal_initialized ) && ( OSAL_TRUE == g_osal_running ) )
+        {
+            ctx = (OsalThreadContext_t*) handle;
+            if ( ctx && events )
+            {
+                // Events are per thread, only the thread itself may take them.
+                if ( ( OSAL_TRUE == ctx->magic ) && ( xTaskGetCurrentTaskHandle() == ctx->task ) )
+                {
+                    (void) xTaskNotifyWait(0UL, 0xFFFFFFFFUL, &notified, ctx->events ? 0UL : pdMS_TO_TICKS(timeoutMs));
+                    *events = ctx->events | notified;
+                    ctx->events = 0;
+                    err = ( *events ) ? OsalErrOk : OsalErrTimeout;
+                }
+                else
+                {
+                    err = OsalErrForbidden;
+                }
+            }
+            else
+            {
+                err = OsalErrParam;
+            }
+        }
+        else
+        {
+            err = OsalErrNotStarted;
+        }
+    }
+
+    return err;
+}
+
 OsalErr_n osal_tmr_init                     (uint32_t* currentTick)
 {
     OsalErr_n err = OsalErrParam;
@@ -370,7 +642,7 @@ OsalErr_n osal_tmr_exec                     (OsalProcedure_t execute, uint32_t p
     if ( execute && periodMs && lastTick )
     {
         now = xTaskGetTickCount();
-        if ( now > *lastTick )
+        if ( (int32_t)( now - *lastTick ) > 0 )
         {
             *lastTick += pdMS_TO_TICKS(periodMs);
             execute();
@@ -435,6 +707,43 @@ OsalErr_n osal_tick_get                     (uint32_t* tick)
     return err;
 }
 
+OsalErr_n osal_time_ms                      (uint64_t* ms)
+{
+    OsalErr_n err = OsalErrUnexpected;
+    TimeOut_t timeOut;
+
+    if ( ( OSAL_FALSE == g_osal_initialized ) || ( OSAL_TRUE == g_osal_initialized ) )
+    {
+        if ( OSAL_TRUE == g_osal_initialized )
+        {
+            if ( OSAL_TRUE == g_osal_running )
+            {
+                if ( ms )
+                {
+                    // Tick count and its overflow count, read together by the kernel.
+                    vTaskSetTimeOutState(&timeOut);
+                    *ms = ( ( ( (uint64_t)(uint32_t) timeOut.xOverflowCount ) << 32 ) | timeOut.xTimeOnEntering ) * 1000ULL / configTICK_RATE_HZ;
+                    err = OsalErrOk;
+                }
+                else
+                {
+                    err = OsalErrParam;
+                }
+            }
+            else
+            {
+                err = OsalErrNotStarted;
+            }
+        }
+        else
+        {
+            err = OsalErrForbidden;
+        }
+    }
+
+    return err;
+}
+
 static bool verify_config                   (const OsalThreadConfig_t* config)
 {
     bool valid = false;
@@ -483,6 +792,11 @@ static void generic_task                    (void* params)
 {
     TickType_t tick;
     TickType_t tickExpected;
+    uint32_t counterStart;
+    uint32_t usExec;
+    uint32_t usSlack;
+    uint32_t events = 0;
+    bool periodicRun = true;
     OsalThreadContext_t* ctx = (OsalThreadContext_t*) params;
 
     // Call the init function if it is attached.
@@ -497,21 +811,140 @@ static void generic_task                    (void* params)
         tick = xTaskGetTickCount();
         tickExpected = tick;
     }
+    ctx->tickWindow = xTaskGetTickCount();
 
     for ( ; ; )
     {
-        // Call the poll function.
+        // Call the poll function, timed including any preemption by higher priority threads.
+        counterStart = hal_util_counter();
         ctx->config.fnPoll((OsalThread_t)ctx);
+        usExec = ( hal_util_counter() - counterStart ) / OSAL_COUNTER_PER_US;
+#ifdef OSAL_STRESS_EN
+        stress_load(ctx);
+#endif
+
+        // Periodic runs must end before the next period starts, the time left is the headroom of the thread.
+        usSlack = OSAL_SLACK_NONE;
+        if ( ctx->config.periodicityMs && periodicRun )
+        {
+            tickExpected += pdMS_TO_TICKS(ctx->config.periodicityMs);
+            tick = xTaskGetTickCount();
+            hal_util_assert ( (int32_t)( tickExpected - tick ) >= 0 );      // Wrap safe, the tick count wraps too.
+            usSlack = (uint32_t)( tickExpected - tick ) * OSAL_US_PER_TICK;
+        }
 
         // Update local stats.
-        ctx->stats.countLoops++;
+        update_stats(ctx, usExec, usSlack);
 
         // Handle time-bound threads.
-        if ( ctx->config.periodicityMs )
+        if ( ctx->config.periodicityMs && !ctx->config.wakeOnEvent )
         {
-            tickExpected += pdMS_TO_TICKS(ctx->config.periodicityMs);
-            hal_util_assert ( xTaskGetTickCount() <= tickExpected );
+            tick = tickExpected - pdMS_TO_TICKS(ctx->config.periodicityMs);
             vTaskDelayUntil(&tick, pdMS_TO_TICKS(ctx->config.periodicityMs));
         }
+        else if ( ctx->config.periodicityMs )
+        {
+            // An event run may end after the next period started, it is not bound to the period.
+            tick = xTaskGetTickCount();
+            if ( (int32_t)( tickExpected - tick ) > 0 )
+            {
+                (void) xTaskNotifyWait(0UL, 0xFFFFFFFFUL, &events, tickExpected - tick);
+                ctx->events |= events;
+                events = 0;
+            }
+            periodicRun = ( (int32_t)( xTaskGetTickCount() - tickExpected ) >= 0 );
+        }
     }
 }
+
+static void update_stats                    (OsalThreadContext_t* ctx, uint32_t usExec, uint32_t usSlack)
+{
+    OsalThreadStats_t stats = ctx->stats;
+    OsalStatsWindow_t* window = ctx->window;
+    uint32_t* average[OsalStatsWindowMax] = {&stats.usExecSecond, &stats.usExecMinute, &stats.usExecHour, &stats.usExecDay};
+    TickType_t tickNow = xTaskGetTickCount();
+    size_t i;
+
+    // Loop stats.
+    stats.countLoops++;
+    stats.usExecLast = usExec;
+    stats.usExecMin = ( 1 == stats.countLoops || usExec < stats.usExecMin ) ? usExec : stats.usExecMin;
+    stats.usExecMax = ( usExec > stats.usExecMax ) ? usExec : stats.usExecMax;
+    stats.usSlackMin = ( usSlack < stats.usSlackMin ) ? usSlack : stats.usSlackMin;
+    ctx->usExecTotal += usExec;
+    stats.msExec = (uint32_t)( ctx->usExecTotal / 1000UL );
+    stats.usExecAvg = (uint32_t)( ctx->usExecTotal / stats.countLoops );
+    window[OsalStatsWindowSecond].usExec += usExec;
+    window[OsalStatsWindowSecond].countLoops++;
+
+    // Close the second window once a second has passed, each closed window is folded into the next longer one.
+    if ( ( tickNow - ctx->tickWindow ) >= pdMS_TO_TICKS(1000UL) )
+    {
+        ctx->tickWindow = tickNow;
+        for ( i = 0 ; i < OsalStatsWindowMax ; ++i )
+        {
+            *average[i] = (uint32_t)( window[i].usExec / window[i].countLoops );
+            if ( ( i + 1 ) < OsalStatsWindowMax )
+            {
+                window[i + 1].usExec += window[i].usExec;
+                window[i + 1].countLoops += window[i].countLoops;
+                window[i + 1].countParts++;
+            }
+            hal_util_memset(&window[i], 0x00, sizeof(window[i]));
+            if ( ( ( i + 1 ) >= OsalStatsWindowMax ) || ( window[i + 1].countParts < g_windowParts[i + 1] ) )
+            {
+                break;
+            }
+        }
+    }
+
+    // Readers copy the stats in a critical section too, publish them in one go.
+    taskENTER_CRITICAL();
+    ctx->stats = stats;
+    taskEXIT_CRITICAL();
+}
+
+#ifdef OSAL_STRESS_EN
+static void stress_load                     (const OsalThreadContext_t* ctx)
+{
+    uint32_t counterStart = hal_util_counter();
+    uint32_t counterLoad = ctx->config.periodicityMs * ctx->config.stressLoadPct * ( HAL_UTIL_COUNTER_HZ / ( 1000UL * 100UL ) );
+
+    // Busy on top of the poll function, so the slack shows what is left for growth.
+    while ( ( hal_util_counter() - counterStart ) < counterLoad )
+    {
+        __nop();
+    }
+}
+#endif
+
+static size_t count_args                    (const char* fmt)
+{
+    size_t count = 0;
+
+    while ( *fmt )
+    {
+        if ( '%' != *fmt++ )
+        {
+            continue;
+        }
+        if ( '%' == *fmt )
+        {
+            fmt++;
+            continue;
+        }
+
+        // Skip flags, width, precision and length, a '*' takes an argument of its own.
+        while ( *fmt && strchr(OSAL_LOGGER_FORMAT_FLAGS, *fmt) )
+        {
+            count += ( '*' == *fmt++ ) ? 1 : 0;
+        }
+        if ( *fmt )
+        {
+            count++;
+            fmt++;
+        }
+    }
+
+    return count;
+}
@@ -19,6 +19,7 @@
 
 #include "osal_types.h"
 #include "osal_mutex.h"
+#include "osal_timer.h"
 #include "FreeRTOS.h"
 #include "semphr.h"
 #include "hal_util.h"
@@ -0,0 +1,370 @@
+/**
+ * @file        osal_timer.c
+ *
+ * @copyright   Accolade Electronics Pvt Ltd, 2023-24
+ *              All Rights Reserved
+ *              UNPUBLISHED, LICENSED SOFTWARE.
+ *              Accolade Electronics, Pune
+ *              CONFIDENTIAL AND PROPRIETARY INFORMATION
+ *              WHICH IS THE PROPERTY OF M/s Accolade Electronics.
+ *
+ * @date        19 October 2026
+ * @author      agent <agent@local>
+ *
+ * @brief       OSAL Timer abstraction - hashed timer wheel implementation using FreeRTOS.
+ */
+
+#include "osal.h"
+#include "osal_timer.h"
+#include "osal_private.h"
+#include "task.h"
+
+/* Private defines. */
+#define OSAL_TIMER_COUNT                    ( 32UL )
+#define OSAL_TIMER_WHEEL_SLOTS              ( 64UL )        // Power of two, one slot per milisecond.
+#define OSAL_TIMER_SLOT(ms)                 ( (size_t) ( ( ms ) & ( OSAL_TIMER_WHEEL_SLOTS - 1UL ) ) )
+
+typedef enum
+{
+    OsalTimerStateIdle,
+    OsalTimerStateRunning,
+    OsalTimerStateExpired
+} OsalTimerState_n;
+
+typedef struct OsalTimerContext_t
+{
+    uint32_t magic;
+    OsalTimerConfig_t config;
+    OsalTimerState_n state;
+    uint64_t expiryMs;                      // Deadline in osal_time_ms time.
+    struct OsalTimerContext_t* next;        // Wheel slot list (while running).
+    struct OsalTimerContext_t* prev;
+} OsalTimerContext_t;
+
+/* Private data. */
+static OsalTimerContext_t g_ctx[OSAL_TIMER_COUNT];
+static OsalTimerContext_t* g_wheel[OSAL_TIMER_WHEEL_SLOTS];
+static uint64_t g_processedMs;              // Wheel slots are visited up to this time.
+
+/* Private functions. */
+static bool get_free_context                (OsalTimerContext_t** ctx);
+static void wheel_link                      (OsalTimerContext_t* ctx);
+static void wheel_unlink                    (OsalTimerContext_t* ctx);
+static void expire_slot                     (size_t slot, uint64_t nowMs);
+
+OsalErr_n osal_timer_global_init            (void)
+{
+    OsalErr_n err = OsalErrUnexpected;
+    size_t i;
+
+    if ( ( OSAL_FALSE == g_osal_initialized ) || ( OSAL_TRUE == g_osal_initialized ) )
+    {
+        if ( OSAL_FALSE == g_osal_initialized )
+        {
+            for ( i = 0 ; i < sizeof(g_ctx)/sizeof(g_ctx[0]) ; ++i )
+            {
+                g_ctx[i].magic = OSAL_FALSE;
+            }
+            hal_util_memset(g_wheel, 0, sizeof(g_wheel));
+            g_processedMs = 0;
+            err = OsalErrOk;
+        }
+        else
+        {
+            err = OsalErrForbidden;
+        }
+    }
+
+    return err;
+}
+
+OsalErr_n osal_timer_create                 (OsalTimer_t* ptrTimer, const OsalTimerConfig_t* config)
+{
+    OsalErr_n err = OsalErrUnexpected;
+    OsalTimerContext_t* ctx;
+
+    if ( ( OSAL_FALSE == g_osal_initialized ) || ( OSAL_TRUE == g_osal_initialized ) )
+    {
+        if ( OSAL_TRUE == g_osal_initialized )
+        {
+            osal_private_lock();
+            if ( ptrTimer && !*ptrTimer && config )
+            {
+                if ( get_free_context(&ctx) )
+                {
+                    hal_util_memcpy(&ctx->config, config, sizeof(ctx->config));
+                    ctx->state = OsalTimerStateIdle;
+                    ctx->next = NULL;
+                    ctx->prev = NULL;
+                    ctx->magic = OSAL_TRUE;
+                    *ptrTimer = (OsalTimer_t) ctx;
+                    err = OsalErrOk;
+                }
+                else
+                {
+                    err = OsalErrMemory;
+                }
+            }
+            else
+            {
+                err = OsalErrParam;
+            }
+            osal_private_unlock();
+        }
+        else
+        {
+            err = OsalErrForbidden;
+        }
+    }
+
+    return err;
+}
+
+OsalErr_n osal_timer_destroy                (OsalTimer_t timer)
+{
+    OsalErr_n err = OsalErrUnexpected;
+    OsalTimerContext_t* ctx;
+
+    if ( ( OSAL_FALSE == g_osal_initialized ) || ( OSAL_TRUE == g_osal_initialized ) )
+    {
+        if ( OSAL_TRUE == g_osal_initialized )
+        {
+            osal_private_lock();
+            if ( timer )
+            {
+                ctx = (OsalTimerContext_t*) timer;
+                if ( OSAL_TRUE == ctx->magic )
+                {
+                    taskENTER_CRITICAL();
+                    if ( OsalTimerStateRunning == ctx->state )
+                    {
+                        wheel_unlink(ctx);
+                    }
+                    ctx->state = OsalTimerStateIdle;
+                    ctx->magic = OSAL_FALSE;
+                    taskEXIT_CRITICAL();
+                    err = OsalErrOk;
+                }
+                else
+                {
+                    err = OsalErrForbidden;
+                }
+            }
+            else
+            {
+                err = OsalErrParam;
+            }
+            osal_private_unlock();
+        }
+        else
+        {
+            err = OsalErrForbidden;
+        }
+    }
+
+    return err;
+}
+
+OsalErr_n osal_timer_start                  (OsalTimer_t timer, uint32_t timeoutMs)
+{
+    OsalErr_n err = OsalErrParam;
+    OsalTimerContext_t* ctx = (OsalTimerContext_t*) timer;
+    uint64_t nowMs = 0;
+
+    if ( ctx )
+    {
+        err = osal_time_ms(&nowMs);
+        if ( OsalErrOk == err )
+        {
+            if ( OSAL_TRUE == ctx->magic )
+            {
+                taskENTER_CRITICAL();
+                if ( OsalTimerStateRunning == ctx->state )
+                {
+                    wheel_unlink(ctx);
+                }
+                // A deadline in a slot already visited would wait for the next revolution, take the next slot.
+                ctx->expiryMs = nowMs + timeoutMs;
+                if ( ctx->expiryMs <= g_processedMs )
+                {
+                    ctx->expiryMs = g_processedMs + 1ULL;
+                }
+                wheel_link(ctx);
+                ctx->state = OsalTimerStateRunning;
+                taskEXIT_CRITICAL();
+            }
+            else
+            {
+                err = OsalErrForbidden;
+            }
+        }
+    }
+
+    return err;
+}
+
+OsalErr_n osal_timer_stop                   (OsalTimer_t timer)
+{
+    OsalErr_n err = OsalErrParam;
+    OsalTimerContext_t* ctx = (OsalTimerContext_t*) timer;
+
+    if ( ctx )
+    {
+        if ( OSAL_TRUE == ctx->magic )
+        {
+            taskENTER_CRITICAL();
+            if ( OsalTimerStateRunning == ctx->state )
+            {
+                wheel_unlink(ctx);
+            }
+            ctx->state = OsalTimerStateIdle;
+            taskEXIT_CRITICAL();
+            err = OsalErrOk;
+        }
+        else
+        {
+            err = OsalErrForbidden;
+        }
+    }
+
+    return err;
+}
+
+OsalErr_n osal_timer_expired                (OsalTimer_t timer, bool* expired)
+{
+    OsalErr_n err = OsalErrParam;
+    OsalTimerContext_t* ctx = (OsalTimerContext_t*) timer;
+
+    if ( ctx && expired )
+    {
+        if ( OSAL_TRUE == ctx->magic )
+        {
+            *expired = ( OsalTimerStateExpired == ctx->state );
+            err = OsalErrOk;
+        }
+        else
+        {
+            err = OsalErrForbidden;
+        }
+    }
+
+    return err;
+}
+
+OsalErr_n osal_timer_execute                (void)
+{
+    OsalErr_n err;
+    uint64_t nowMs = 0;
+    size_t steps = 0;
+
+    err = osal_time_ms(&nowMs);
+    if ( OsalErrOk == err )
+    {
+        // Visit the slots of the miliseconds that passed, one revolution covers every running timer.
+        while ( ( g_processedMs < nowMs ) && ( steps < OSAL_TIMER_WHEEL_SLOTS ) )
+        {
+            g_processedMs++;
+            steps++;
+            expire_slot(OSAL_TIMER_SLOT(g_processedMs), nowMs);
+        }
+        if ( g_processedMs < nowMs )
+        {
+            g_processedMs = nowMs;
+        }
+    }
+
+    return err;
+}
+
+static bool get_free_context                (OsalTimerContext_t** ctx)
+{
+    size_t i;
+    bool success = false;
+
+    for ( i = 0 ; i < sizeof(g_ctx)/sizeof(g_ctx[0]) ; ++i )
+    {
+        if ( OSAL_FALSE == g_ctx[i].magic )
+        {
+            *ctx = &g_ctx[i];
+            success = true;
+            break;
+        }
+    }
+
+    return success;
+}
+
+static void wheel_link                      (OsalTimerContext_t* ctx)
+{
+    OsalTimerContext_t** head = &g_wheel[OSAL_TIMER_SLOT(ctx->expiryMs)];
+
+    ctx->prev = NULL;
+    ctx->next = *head;
+    if ( *head )
+    {
+        (*head)->prev = ctx;
+    }
+    *head = ctx;
+}
+
+static void wheel_unlink                    (OsalTimerContext_t* ctx)
+{
+    if ( ctx->prev )
+    {
+        ctx->prev->next = ctx->next;
+    }
+    else
+    {
+        g_wheel[OSAL_TIMER_SLOT(ctx->expiryMs)] = ctx->next;
+    }
+    if ( ctx->next )
+    {
+        ctx->next->prev = ctx->prev;
+    }
+    ctx->next = NULL;
+    ctx->prev = NULL;
+}
+
+static void expire_slot                     (size_t slot, uint64_t nowMs)
+{
+    OsalTimerContext_t* ctx;
+    OsalTimerConfig_t config;
+
+    // Timers of later revolutions share the slot, only the due ones are taken. Actions run outside the lock.
+    for ( ; ; )
+    {
+        taskENTER_CRITICAL();
+        for ( ctx = g_wheel[slot] ; ctx && ( ctx->expiryMs > nowMs ) ; ctx = ctx->next );
+        if ( NULL == ctx )
+        {
+            taskEXIT_CRITICAL();
+            break;
+        }
+        wheel_unlink(ctx);
+        if ( ctx->config.periodMs )
+        {
+            // Periods are kept from the deadline, a late service skips the missed ones instead of bursting.
+            ctx->expiryMs += ctx->config.periodMs;
+            if ( ctx->expiryMs <= nowMs )
+            {
+                ctx->expiryMs = nowMs + ctx->config.periodMs;
+            }
+            wheel_link(ctx);
+        }
+        else
+        {
+            ctx->state = OsalTimerStateExpired;
+        }
+        config = ctx->config;
+        taskEXIT_CRITICAL();
+
+        if ( config.thread && config.events )
+        {
+            (void) osal_event_set(config.thread, config.events);
+        }
+        if ( config.fnExpire )
+        {
+            config.fnExpire();
+        }
+    }
+}
@@ -0,0 +1,319 @@
+/**
+ * @file        can_signal.c
+ *
+ * @copyright   Accolade Electronics Pvt Ltd, 2023-24
+ *              All Rights Reserved
+ *              UNPUBLISHED, LICENSED SOFTWARE.
+ *              Accolade Electronics, Pune
+ *              CONFIDENTIAL AND PROPRIETARY INFORMATION
+ *              WHICH IS THE PROPERTY OF M/s Accolade Electronics.
+ *
+ * @date        19 October 2026
+ * @author      agent <agent@local>
+ *
+ * @brief       Table driven CAN signal decoder
+ */
+
+// Standard includes.
+#include <stddef.h>
+#include <string.h>
+
+// Module includes.
+#include "can_signal.h"
+
+// Dependencies.
+#include "drv_can.h"
+
+#define CAN_SIGNAL_NONE                     ( 0xFFFFU )
+#define CAN_SIGNAL_KEY(id, ide)             ( ( (ide) ? 0x80000000UL : 0UL ) | ( id ) )
+
+typedef struct
+{
+    uint32_t    id;
+    bool        ide;
+    uint8_t     dlc;
+}CanSignalMsg_t;
+
+typedef struct
+{
+    uint16_t            index[CanSignalMsgMax];         /* Messages sorted by ID. */
+    uint16_t            firstSubscribed[CanSignalMsgMax];
+    uint16_t            nextSubscribed[CanSignalMax];
+    bool                subscribed[CanSignalMax];
+    uint16_t            countSubscribed;                /* Frames are left in the driver while 0. */
+    CanSignalValue_t    values[CanSignalMax];
+    CanSignalStats_t    stats;
+}CanSignalCtx_t;
+
+/**
+ * @brief Gives the message of a frame ID.
+ * @return              Message, CanSignalMsgMax if the ID is not in the database.
+ */
+static uint16_t findMessage                 (uint32_t id, bool ide);
+
+/**
+ * @brief Gives the index of the last data byte used by a signal.
+ */
+static uint8_t lastByte                     (const CanSignal_t *signal);
+
+static const CanSignalMsg_t g_messages[CanSignalMsgMax] =
+{
+#define CAN_SIGNAL_MESSAGE(name, id, ide, dlc)  { (id), (ide), (dlc) },
+#define CAN_SIGNAL(name, message, start, length, order, sign, mul, div, offset)
+#include "can_signal_db.h"
+#undef CAN_SIGNAL_MESSAGE
+#undef CAN_SIGNAL
+};
+
+static const CanSignal_t g_signals[CanSignalMax] =
+{
+#define CAN_SIGNAL_MESSAGE(name, id, ide, dlc)
+#define CAN_SIGNAL(name, message, start, length, order, sign, mul, div, offset) \
+    { CanSignalMsg##message, (start), (length), (order), (sign), (mul), (div), (offset) },
+#include "can_signal_db.h"
+#undef CAN_SIGNAL_MESSAGE
+#undef CAN_SIGNAL
+};
+
+static CanSignalCtx_t g_signal;
+
+bool CanSignalInit                          (void)
+{
+    uint32_t key = 0;
+    uint16_t msg = 0;
+    uint16_t i = 0;
+    uint16_t j = 0;
+
+    memset(&g_signal, 0x00, sizeof(g_signal));
+
+    for(i = 0; i < CanSignalMax; i++)
+    {
+        g_signal.nextSubscribed[i] = CAN_SIGNAL_NONE;
+        if(g_signals[i].length == 0 || g_signals[i].length > 32 || g_signals[i].div == 0 ||
+           lastByte(&g_signals[i]) >= g_messages[g_signals[i].message].dlc)
+        {
+            return false;
+        }
+    }
+
+    // insertion sort by ID, the database is small and this runs once
+    for(i = 0; i < CanSignalMsgMax; i++)
+    {
+        if(g_messages[i].dlc > HAL_CAN_MAX_DATA_LEN)
+        {
+            return false;
+        }
+        g_signal.firstSubscribed[i] = CAN_SIGNAL_NONE;
+        key = CAN_SIGNAL_KEY(g_messages[i].id, g_messages[i].ide);
+        for(j = i; j > 0; j--)
+        {
+            msg = g_signal.index[j - 1];
+            if(CAN_SIGNAL_KEY(g_messages[msg].id, g_messages[msg].ide) == key)
+            {
+                return false;
+            }
+            if(CAN_SIGNAL_KEY(g_messages[msg].id, g_messages[msg].ide) < key)
+            {
+                break;
+            }
+            g_signal.index[j] = msg;
+        }
+        g_signal.index[j] = i;
+    }
+    return true;
+}
+
+bool CanSignalSubscribe                     (CanSignal_n signal)
+{
+    CanSignalMsg_n msg = CanSignalMsgMax;
+
+    if(signal >= CanSignalMax)
+    {
+        return false;
+    }
+    if(!g_signal.subscribed[signal])
+    {
+        msg = g_signals[signal].message;
+        g_signal.nextSubscribed[signal] = g_signal.firstSubscribed[msg];
+        g_signal.firstSubscribed[msg] = signal;
+        g_signal.subscribed[signal] = true;
+        g_signal.countSubscribed++;
+    }
+    return true;
+}
+
+void CanSignalUnsubscribe                   (CanSignal_n signal)
+{
+    uint16_t *link = NULL;
+
+    if(signal >= CanSignalMax || !g_signal.subscribed[signal])
+    {
+        return;
+    }
+
+    link = &g_signal.firstSubscribed[g_signals[signal].message];
+    while(*link != signal)
+    {
+        link = &g_signal.nextSubscribed[*link];
+    }
+    *link = g_signal.nextSubscribed[signal];
+    g_signal.nextSubscribed[signal] = CAN_SIGNAL_NONE;
+    g_signal.subscribed[signal] = false;
+    g_signal.countSubscribed--;
+}
+
+void CanSignalProcess                       (const CAN_MSG_T *msg)
+{
+    CanSignalValue_t *value = NULL;
+    uint16_t message = 0;
+    uint16_t signal = CAN_SIGNAL_NONE;
+
+    if(msg == NULL)
+    {
+        return;
+    }
+
+    g_signal.stats.countFrames++;
+    message = findMessage(msg->u32MsgId, msg->bIde ? true : false);
+    if(message >= CanSignalMsgMax || g_signal.firstSubscribed[message] == CAN_SIGNAL_NONE)
+    {
+        return;
+    }
+    g_signal.stats.countMatched++;
+    if(msg->u8Dlc < g_messages[message].dlc)
+    {
+        g_signal.stats.countShort++;
+        return;
+    }
+
+    for(signal = g_signal.firstSubscribed[message]; signal != CAN_SIGNAL_NONE; signal = g_signal.nextSubscribed[signal])
+    {
+        value = &g_signal.values[signal];
+        value->raw = CanSignalExtract(msg->aU8Data, &g_signals[signal]);
+        if(g_signals[signal].sign)
+        {
+            value->value = ((int64_t)(int32_t)value->raw * g_signals[signal].mul) / g_signals[signal].div + g_signals[signal].offset;
+        }
+        else
+        {
+            value->value = ((int64_t)value->raw * g_signals[signal].mul) / g_signals[signal].div + g_signals[signal].offset;
+        }
+        value->timestamp = msg->u32Timestamp;
+        value->count++;
+        g_signal.stats.countDecoded++;
+    }
+}
+
+void CanSignalExe                           (void)
+{
+    CAN_MSG_T msg;
+
+    // nothing to decode, leave the frames to any other reader of the driver
+    if(g_signal.countSubscribed == 0)
+    {
+        return;
+    }
+    while(drv_can_bReadRecvMsg(&msg) == eBUFF_READ_SUCCESS)
+    {
+        CanSignalProcess(&msg);
+    }
+}
+
+bool CanSignalGet                           (CanSignal_n signal, CanSignalValue_t *value)
+{
+    if(signal >= CanSignalMax || value == NULL || g_signal.values[signal].count == 0)
+    {
+        return false;
+    }
+    *value = g_signal.values[signal];
+    return true;
+}
+
+uint32_t CanSignalExtract                   (const uint8_t *data, const CanSignal_t *signal)
+{
+    uint32_t raw = 0;
+    uint16_t bit = signal->start;
+    uint8_t left = signal->length;
+    uint8_t shift = 0;
+    uint8_t take = 0;
+
+    if(signal->order == CanSignalOrderIntel)
+    {
+        // LSB first, each step takes the rest of the current byte
+        while(left > 0)
+        {
+            take = 8 - (bit & 0x07);
+            take = (take < left) ? take : left;
+            raw |= (uint32_t)((data[bit >> 3] >> (bit & 0x07)) & ((1U << take) - 1U)) << shift;
+            shift += take;
+            bit += take;
+            left -= take;
+        }
+    }
+    else
+    {
+        // MSB first, bits run down to bit 0 of a byte then on from bit 7 of the next byte
+        while(left > 0)
+        {
+            take = (bit & 0x07) + 1;
+            take = (take < left) ? take : left;
+            raw = (raw << take) | ((data[bit >> 3] >> ((bit & 0x07) + 1 - take)) & ((1U << take) - 1U));
+            bit = ((bit >> 3) + 1) * 8 + 7;
+            left -= take;
+        }
+    }
+
+    if(signal->sign && signal->length < 32 && (raw & (1UL << (signal->length - 1))) != 0)
+    {
+        raw |= ~((1UL << signal->length) - 1UL);
+    }
+    return raw;
+}
+
+CanSignalStats_t CanSignalGetStats          (void)
+{
+    return g_signal.stats;
+}
+
+static uint16_t findMessage                 (uint32_t id, bool ide)
+{
+    uint32_t key = CAN_SIGNAL_KEY(id, ide);
+    uint32_t midKey = 0;
+    uint16_t low = 0;
+    uint16_t high = CanSignalMsgMax;
+    uint16_t mid = 0;
+
+    while(low < high)
+    {
+        mid = (low + high) / 2;
+        midKey = CAN_SIGNAL_KEY(g_messages[g_signal.index[mid]].id, g_messages[g_signal.index[mid]].ide);
+        if(midKey == key)
+        {
+            return g_signal.index[mid];
+        }
+        if(midKey < key)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return CanSignalMsgMax;
+}
+
+static uint8_t lastByte                     (const CanSignal_t *signal)
+{
+    uint8_t first = (signal->start & 0x07) + 1;
+
+    if(signal->order == CanSignalOrderIntel)
+    {
+        return (uint8_t)((signal->start + signal->length - 1) / 8);
+    }
+    if(signal->length <= first)
+    {
+        return signal->start / 8;
+    }
+    return (uint8_t)((signal->start / 8) + ((signal->length - first + 7) / 8));
+}
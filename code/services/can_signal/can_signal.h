@@ -0,0 +1,140 @@
+/**
+ * @file        can_signal.h
+ *
+ * @copyright   Accolade Electronics Pvt Ltd, 2023-24
+ *              All Rights Reserved
+ *              UNPUBLISHED, LICENSED SOFTWARE.
+ *              Accolade Electronics, Pune
+ *              CONFIDENTIAL AND PROPRIETARY INFORMATION
+ *              WHICH IS THE PROPERTY OF M/s Accolade Electronics.
+ *
+ * @date        19 October 2026
+ * @author      agent <agent@local>
+ *
+ * @brief       Table driven CAN signal decoder - header
+ *
+ * @details     Messages and signals come from can_signal_db.h and are compiled into constant tables.
+ *              A received frame is looked up by ID (binary search) and only the subscribed signals of its message
+ *              are decoded, frames without subscribed signals cost the lookup only.
+ * @note        Frames are processed and values read in the same thread (service thread), no locking is done.
+ *              Once any signal is subscribed, CanSignalExe is the only reader of drv_can_bReadRecvMsg. Other users of
+ *              received frames have to be called from it, a second reader would see only part of the traffic.
+ */
+
+#ifndef CAN_SIGNAL_H
+#define CAN_SIGNAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "hal_can.h"
+
+typedef enum
+{
+    CanSignalOrderIntel,                    /* Little endian. */
+    CanSignalOrderMotorola                  /* Big endian. */
+}CanSignalOrder_n;
+
+typedef enum
+{
+#define CAN_SIGNAL_MESSAGE(name, id, ide, dlc)  CanSignalMsg##name,
+#define CAN_SIGNAL(name, message, start, length, order, sign, mul, div, offset)
+#include "can_signal_db.h"
+#undef CAN_SIGNAL_MESSAGE
+#undef CAN_SIGNAL
+    CanSignalMsgMax
+}CanSignalMsg_n;
+
+typedef enum
+{
+#define CAN_SIGNAL_MESSAGE(name, id, ide, dlc)
+#define CAN_SIGNAL(name, message, start, length, order, sign, mul, div, offset)  CanSignal##name,
+#include "can_signal_db.h"
+#undef CAN_SIGNAL_MESSAGE
+#undef CAN_SIGNAL
+    CanSignalMax
+}CanSignal_n;
+
+typedef struct
+{
+    CanSignalMsg_n      message;
+    uint16_t            start;
+    uint8_t             length;
+    CanSignalOrder_n    order;
+    bool                sign;
+    int32_t             mul;
+    int32_t             div;
+    int32_t             offset;
+}CanSignal_t;
+
+typedef struct
+{
+    uint32_t    raw;                        /* Raw bits, sign extended for signed signals. */
+    int64_t     value;                      /* raw * mul / div + offset, 64 bit so unsigned 32 bit signals stay positive. */
+    uint32_t    timestamp;                  /* CAN_MSG_T u32Timestamp of the frame. */
+    uint32_t    count;                      /* Frames decoded, 0 until the first one. */
+}CanSignalValue_t;
+
+typedef struct
+{
+    uint32_t    countFrames;                /* Frames processed. */
+    uint32_t    countMatched;               /* Frames with subscribed signals. */
+    uint32_t    countShort;                 /* Frames with subscribed signals shorter than their message. */
+    uint32_t    countDecoded;               /* Signal values decoded. */
+}CanSignalStats_t;
+
+/**
+ * @brief                                   Builds the ID index and clears the subscriptions and values.
+ * @return                                  false if a signal does not fit its message or an ID is listed twice.
+ */
+bool CanSignalInit                          (void);
+
+/**
+ * @brief                                   Starts decoding a signal.
+ * @param   signal                          Signal to decode.
+ * @return                                  false if the signal is invalid.
+ */
+bool CanSignalSubscribe                     (CanSignal_n signal);
+
+/**
+ * @brief                                   Stops decoding a signal, its last value is kept.
+ * @param   signal                          Signal to stop.
+ */
+void CanSignalUnsubscribe                   (CanSignal_n signal);
+
+/**
+ * @brief                                   Decodes the subscribed signals of a frame.
+ * @param   msg                             Received frame.
+ */
+void CanSignalProcess                       (const CAN_MSG_T *msg);
+
+/**
+ * @brief                                   Reads all frames of the CAN driver receive buffer and processes them.
+ * @note                                    While a signal is subscribed this is the only reader of drv_can_bReadRecvMsg,
+ *                                          frames are not read at all while nothing is subscribed.
+ */
+void CanSignalExe                           (void);
+
+/**
+ * @brief                                   Gives the last value of a signal.
+ * @param   signal                          Signal to read.
+ * @param   value                           Last value.
+ * @return                                  false if the signal is invalid or was not received yet.
+ */
+bool CanSignalGet                           (CanSignal_n signal, CanSignalValue_t *value);
+
+/**
+ * @brief                                   Extracts the raw bits of a signal from frame data.
+ * @param   data                            Frame data, at least as long as the message of the signal.
+ * @param   signal                          Signal description.
+ * @return                                  Raw value, sign extended for signed signals.
+ */
+uint32_t CanSignalExtract                   (const uint8_t *data, const CanSignal_t *signal);
+
+/**
+ * @brief                                   Gives the decoder statistics.
+ * @return                                  Copy of the statistics.
+ */
+CanSignalStats_t CanSignalGetStats          (void);
+
+#endif /* CAN_SIGNAL_H */
@@ -0,0 +1,41 @@
+/**
+ * @file        can_signal_db.h
+ *
+ * @copyright   Accolade Electronics Pvt Ltd, 2023-24
+ *              All Rights Reserved
+ *              UNPUBLISHED, LICENSED SOFTWARE.
+ *              Accolade Electronics, Pune
+ *              CONFIDENTIAL AND PROPRIETARY INFORMATION
+ *              WHICH IS THE PROPERTY OF M/s Accolade Electronics.
+ *
+ * @date        19 October 2026
+ * @author      agent <agent@local>
+ *
+ * @brief       CAN signal database
+ *
+ * @details     DBC like description expanded by can_signal.h and can_signal.c, no include guard on purpose.
+ *              CAN_SIGNAL_MESSAGE(name, id, ide, dlc)
+ *                  ide             true for a 29 bit ID.
+ *                  dlc             Frame length in bytes, shorter frames are not decoded.
+ *              CAN_SIGNAL(name, message, start, length, order, sign, mul, div, offset)
+ *                  start, length   Bit position and size as in a DBC file, length 1 to 32. Intel signals start at the LSB,
+ *                                  Motorola signals at the MSB (byte * 8 + bit, bit 7 is the MSB of the byte).
+ *                  order           CanSignalOrderIntel or CanSignalOrderMotorola.
+ *                  sign            true for two's complement signals.
+ *                  mul, div, offset Value = raw * mul / div + offset, integers in the unit given in the comment.
+ *              Vehicle frames received by the TCU (the IDs of the former drv_can receive list). Their signal layout
+ *              is not part of this tree, so each frame is described by its first 16 bit word until the vehicle DBC is
+ *              converted into this list.
+ */
+
+/*                  name                id          ide     dlc */
+CAN_SIGNAL_MESSAGE( Veh09A,             0x09A,      false,  2   )
+CAN_SIGNAL_MESSAGE( Veh30E,             0x30E,      false,  2   )
+CAN_SIGNAL_MESSAGE( Veh310,             0x310,      false,  2   )
+CAN_SIGNAL_MESSAGE( Veh600,             0x600,      false,  2   )
+
+/*                  name                message     start   length  order                   sign    mul     div     offset */
+CAN_SIGNAL(         Veh09AWord0,        Veh09A,     7,      16,     CanSignalOrderMotorola, false,  1,      1,      0       )   /* Raw. */
+CAN_SIGNAL(         Veh30EWord0,        Veh30E,     7,      16,     CanSignalOrderMotorola, false,  1,      1,      0       )   /* Raw. */
+CAN_SIGNAL(         Veh310Word0,        Veh310,     7,      16,     CanSignalOrderMotorola, false,  1,      1,      0       )   /* Raw. */
+CAN_SIGNAL(         Veh600Word0,        Veh600,     7,      16,     CanSignalOrderMotorola, false,  1,      1,      0       )   /* Raw. */
@@ -0,0 +1,490 @@
+/**
+ * @file        can_trace.c
+ *
+ * @copyright   Accolade Electronics Pvt Ltd, 2023-24
+ *              All Rights Reserved
+ *              UNPUBLISHED, LICENSED SOFTWARE.
+ *              Accolade Electronics, Pune
+ *              CONFIDENTIAL AND PROPRIETARY INFORMATION
+ *              WHICH IS THE PROPERTY OF M/s Accolade Electronics.
+ *
+ * @date        19 October 2026
+ * @author      agent <agent@local>
+ *
+ * @brief       CAN trace to the raw flash partition
+ */
+
+// Standard includes.
+#include <stddef.h>
+#include <string.h>
+
+// Module includes.
+#include "can_trace.h"
+
+// Dependencies.
+#include "drv_can.h"
+#include "hal_util.h"
+#include "nor_flash.h"
+#include "r_cg_macrodriver.h"
+
+#define CAN_TRACE_SECTORS_PER_BLOCK         ( NOR_FLASH_BLOCK_SIZE / NOR_FLASH_SECTOR_SIZE )
+#define CAN_TRACE_SECTOR_COUNT              ( CAN_TRACE_BLOCK_COUNT * CAN_TRACE_SECTORS_PER_BLOCK )
+#define CAN_TRACE_SECTOR_ADDRESS(n)         ( ( ( CAN_TRACE_FIRST_BLOCK * CAN_TRACE_SECTORS_PER_BLOCK ) + ( n ) ) * NOR_FLASH_SECTOR_SIZE )
+#define CAN_TRACE_TICKS_PER_US              ( HAL_CAN_TIMESTAMP_HZ / 1000000UL )
+#define CAN_TRACE_FLAGS_VALID               ( 0x3F )
+#define CAN_TRACE_TIME_RECORD_TICKS         ( CAN_TRACE_TIME_RECORD_US * CAN_TRACE_TICKS_PER_US )
+
+typedef struct
+{
+    volatile uint32_t   stagingHead;        /* Bytes staged, written by the CAN interrupt. */
+    volatile uint32_t   stagingTail;        /* Bytes moved to the sector buffer, written by CanTraceExe. */
+    volatile bool       enabled;
+    bool                traceTx;
+    bool                hasLast;
+    uint32_t            lastTimestamp;      /* CAN timestamp the last staged delta ends at. */
+    uint32_t            stagedUs;           /* Trace time of the last staged record. */
+    CanTraceFilter_t    filters[CAN_TRACE_MAX_FILTERS];
+    uint8_t             countFilters;
+    bool                sectorOpen;
+    uint32_t            sectorIndex;        /* Sector of the trace area being filled. */
+    uint16_t            sectorFill;         /* Bytes used in the sector buffer. */
+    uint16_t            sectorFlushed;      /* Bytes of the sector buffer programmed, page aligned. */
+    uint32_t            seq;                /* Sequence number of the next sector. */
+    uint32_t            session;            /* Sequence number of the first sector of this boot. */
+    uint32_t            timeUs;             /* Trace time of the last record moved to the sector buffer. */
+    CanTraceStats_t     stats;
+}CanTrace_t;
+
+/**
+ * @brief Encodes a frame into the staging ring, called by the CAN driver.
+ */
+static void traceFrame                      (const CAN_MSG_T *psMsg, BOOL_T bTx);
+
+/**
+ * @brief Appends the record of a frame to the staging ring.
+ */
+static void stageFrame                      (const CAN_MSG_T *psMsg, BOOL_T bTx);
+
+/**
+ * @brief Stages a time record when no record was staged for CAN_TRACE_TIME_RECORD_US.
+ */
+static void stageTime                       (void);
+
+/**
+ * @brief Copies an encoded record into the staging ring.
+ * @return              false if the ring is full, the record is dropped.
+ */
+static bool stageRecord                     (const uint8_t *record, uint8_t len);
+
+/**
+ * @brief Tells whether a frame passes the filters.
+ */
+static bool isTraced                        (const CAN_MSG_T *psMsg);
+
+/**
+ * @brief Starts the next sector, erasing its block first when it is the first sector of the block.
+ */
+static void openSector                      (void);
+
+/**
+ * @brief Programs the pages of the sector buffer not programmed yet.
+ * @param all           false: whole pages only. true: also the last partial page, the sector is complete.
+ */
+static void flushSector                     (bool all);
+
+static uint8_t stagingByte                  (uint32_t offset);
+static uint8_t putLe                        (uint8_t *buff, uint32_t value, uint8_t len);
+static uint32_t getLe                       (const uint8_t *buff, uint8_t len);
+
+#pragma section GRAMB
+static uint8_t                              g_staging[CAN_TRACE_STAGING_SIZE];
+static uint8_t                              g_sector[NOR_FLASH_SECTOR_SIZE];
+#pragma section default
+static CanTrace_t                           g_trace;
+
+void CanTraceInit                           (void)
+{
+    uint8_t header[CAN_TRACE_HEADER_SIZE];
+    uint32_t newest = 0;
+    uint32_t seq = 0;
+    uint32_t i = 0;
+    bool found = false;
+
+    memset(&g_trace, 0x00, sizeof(g_trace));
+
+    // continue after the newest sector, the rest of its block is still erased
+    for(i = 0; i < CAN_TRACE_SECTOR_COUNT; i++)
+    {
+        if(NorFlashErrOk != nor_flash_read(CAN_TRACE_SECTOR_ADDRESS(i), header, sizeof(header)))
+        {
+            g_trace.stats.countFlashErrors++;
+            continue;
+        }
+        if(getLe(&header[0], 4) != CAN_TRACE_MAGIC)
+        {
+            continue;
+        }
+        seq = getLe(&header[4], 4);
+        if(!found || (int32_t)(seq - g_trace.seq) > 0)
+        {
+            g_trace.seq = seq;
+            newest = i;
+            found = true;
+        }
+    }
+    if(found)
+    {
+        g_trace.seq++;
+        g_trace.sectorIndex = newest;
+    }
+    else
+    {
+        g_trace.sectorIndex = CAN_TRACE_SECTOR_COUNT - 1;
+    }
+    g_trace.session = g_trace.seq;
+
+    drv_can_vSetTraceCallback(traceFrame);
+}
+
+bool CanTraceStart                          (const CanTraceFilter_t *filters, uint8_t count, bool traceTx)
+{
+    if(count > CAN_TRACE_MAX_FILTERS || (filters == NULL && count > 0))
+    {
+        return false;
+    }
+
+    g_trace.enabled = false;
+    if(count > 0)
+    {
+        memcpy(g_trace.filters, filters, count * sizeof(filters[0]));
+    }
+    g_trace.countFilters = count;
+    g_trace.traceTx = traceTx;
+    g_trace.enabled = true;
+    return true;
+}
+
+void CanTraceStop                           (void)
+{
+    g_trace.enabled = false;
+}
+
+void CanTraceExe                            (void)
+{
+    uint32_t tail = g_trace.stagingTail;
+    uint8_t flags = 0;
+    uint8_t deltaLen = 0;
+    uint8_t idLen = 0;
+    uint8_t delta[4];
+    uint16_t recordLen = 0;
+    uint16_t i = 0;
+
+    DI();
+    stageTime();
+    EI();
+
+    // records are staged whole, so a record is complete as soon as its first byte is there
+    while(tail != g_trace.stagingHead)
+    {
+        flags = stagingByte(tail);
+        deltaLen = (flags & CAN_TRACE_FLAG_LONG_DELTA) ? 4 : 2;
+        idLen = (flags & CAN_TRACE_FLAG_IDE) ? 4 : 2;
+        if(flags & CAN_TRACE_FLAG_TIME)
+        {
+            recordLen = CAN_TRACE_TIME_RECORD_LEN;
+        }
+        else
+        {
+            recordLen = 1 + deltaLen + idLen + 1 + stagingByte(tail + 1 + deltaLen + idLen);
+        }
+
+        // records do not cross sectors so each sector decodes on its own
+        if(!g_trace.sectorOpen || (g_trace.sectorFill + recordLen) > NOR_FLASH_SECTOR_SIZE)
+        {
+            if(g_trace.sectorOpen)
+            {
+                flushSector(true);
+            }
+            openSector();
+        }
+
+        for(i = 0; i < recordLen; i++)
+        {
+            g_sector[g_trace.sectorFill + i] = stagingByte(tail + i);
+        }
+        if(flags & CAN_TRACE_FLAG_TIME)
+        {
+            g_trace.timeUs = getLe(&g_sector[g_trace.sectorFill + 1], 4);
+        }
+        else
+        {
+            for(i = 0; i < deltaLen; i++)
+            {
+                delta[i] = g_sector[g_trace.sectorFill + 1 + i];
+            }
+            g_trace.timeUs += getLe(delta, deltaLen);
+        }
+        g_trace.sectorFill += recordLen;
+        tail += recordLen;
+        g_trace.stagingTail = tail;
+    }
+
+    // the last partial page stays in RAM until it is full
+    if(g_trace.sectorOpen)
+    {
+        flushSector(false);
+    }
+}
+
+uint16_t CanTraceDecode                     (const uint8_t *buff, uint16_t len, CanTraceRecord_t *record)
+{
+    uint8_t deltaLen = 0;
+    uint8_t idLen = 0;
+    uint16_t used = 0;
+
+    if(buff == NULL || record == NULL || len == 0 || (buff[0] & ~CAN_TRACE_FLAGS_VALID) != 0)
+    {
+        return 0;
+    }
+
+    record->flags = buff[used++];
+    if(record->flags & CAN_TRACE_FLAG_TIME)
+    {
+        if(len < CAN_TRACE_TIME_RECORD_LEN)
+        {
+            return 0;
+        }
+        record->timeUs = getLe(&buff[used], 4);
+        record->id = 0;
+        record->len = 0;
+        return CAN_TRACE_TIME_RECORD_LEN;
+    }
+    deltaLen = (record->flags & CAN_TRACE_FLAG_LONG_DELTA) ? 4 : 2;
+    idLen = (record->flags & CAN_TRACE_FLAG_IDE) ? 4 : 2;
+    if(len < (uint16_t)(1 + deltaLen + idLen + 1))
+    {
+        return 0;
+    }
+    record->timeUs += getLe(&buff[used], deltaLen);
+    used += deltaLen;
+    record->id = getLe(&buff[used], idLen);
+    used += idLen;
+    record->len = buff[used++];
+    if(record->len > sizeof(record->data) || (used + record->len) > len)
+    {
+        return 0;
+    }
+    memcpy(record->data, &buff[used], record->len);
+    return used + record->len;
+}
+
+CanTraceStats_t CanTraceGetStats            (void)
+{
+    return g_trace.stats;
+}
+
+static void traceFrame                      (const CAN_MSG_T *psMsg, BOOL_T bTx)
+{
+    if(!g_trace.enabled || (bTx && !g_trace.traceTx) || !isTraced(psMsg))
+    {
+        return;
+    }
+
+    // transmitted frames come from the driver task, keep the receive interrupt out of the ring while one is staged
+    if(bTx)
+    {
+        DI();
+        stageFrame(psMsg, bTx);
+        EI();
+    }
+    else
+    {
+        stageFrame(psMsg, bTx);
+    }
+}
+
+static void stageFrame                      (const CAN_MSG_T *psMsg, BOOL_T bTx)
+{
+    uint8_t record[CAN_TRACE_MAX_RECORD_LEN];
+    uint32_t deltaTicks = 0;
+    uint32_t deltaUs = 0;
+    uint8_t dataLen = (psMsg->u8Dlc > HAL_CAN_MAX_DATA_LEN) ? HAL_CAN_MAX_DATA_LEN : psMsg->u8Dlc;
+    uint8_t flags = 0;
+    uint8_t len = 1;
+
+    if(g_trace.hasLast && (int32_t)(psMsg->u32Timestamp - g_trace.lastTimestamp) > 0)
+    {
+        deltaTicks = psMsg->u32Timestamp - g_trace.lastTimestamp;
+    }
+    deltaUs = deltaTicks / CAN_TRACE_TICKS_PER_US;
+
+    flags |= psMsg->bIde ? CAN_TRACE_FLAG_IDE : 0;
+    flags |= psMsg->bFdf ? CAN_TRACE_FLAG_FDF : 0;
+    flags |= psMsg->bBrs ? CAN_TRACE_FLAG_BRS : 0;
+    flags |= bTx ? CAN_TRACE_FLAG_TX : 0;
+    flags |= (deltaUs > 0xFFFFUL) ? CAN_TRACE_FLAG_LONG_DELTA : 0;
+    record[0] = flags;
+    len += putLe(&record[len], deltaUs, (flags & CAN_TRACE_FLAG_LONG_DELTA) ? 4 : 2);
+    len += putLe(&record[len], psMsg->u32MsgId, psMsg->bIde ? 4 : 2);
+    record[len++] = dataLen;
+    memcpy(&record[len], psMsg->aU8Data, dataLen);
+    len += dataLen;
+
+    // dropped, the next delta still counts from the last staged record
+    if(!stageRecord(record, len))
+    {
+        return;
+    }
+    g_trace.stagedUs += deltaUs;
+
+    // keep the sub us rest so the trace time does not drift
+    if(g_trace.hasLast)
+    {
+        g_trace.lastTimestamp += deltaUs * CAN_TRACE_TICKS_PER_US;
+    }
+    else
+    {
+        g_trace.lastTimestamp = psMsg->u32Timestamp;
+        g_trace.hasLast = true;
+    }
+}
+
+static void stageTime                       (void)
+{
+    uint8_t record[CAN_TRACE_TIME_RECORD_LEN];
+    uint32_t deltaUs = 0;
+
+    // also while stopped, a later start must not see a delta that wrapped
+    if(!g_trace.hasLast || (hal_util_counter() - g_trace.lastTimestamp) < CAN_TRACE_TIME_RECORD_TICKS)
+    {
+        return;
+    }
+
+    deltaUs = (hal_util_counter() - g_trace.lastTimestamp) / CAN_TRACE_TICKS_PER_US;
+    record[0] = CAN_TRACE_FLAG_TIME;
+    (void)putLe(&record[1], g_trace.stagedUs + deltaUs, 4);
+    if(stageRecord(record, sizeof(record)))
+    {
+        g_trace.stagedUs += deltaUs;
+        g_trace.lastTimestamp += deltaUs * CAN_TRACE_TICKS_PER_US;
+    }
+}
+
+static bool stageRecord                     (const uint8_t *record, uint8_t len)
+{
+    uint32_t head = g_trace.stagingHead;
+    uint32_t used = head - g_trace.stagingTail;
+    uint8_t i = 0;
+
+    if((CAN_TRACE_STAGING_SIZE - used) < len)
+    {
+        g_trace.stats.countDropped++;
+        return false;
+    }
+    for(i = 0; i < len; i++)
+    {
+        g_staging[(head + i) % CAN_TRACE_STAGING_SIZE] = record[i];
+    }
+    g_trace.stagingHead = head + len;
+
+    g_trace.stats.countRecords++;
+    if((used + len) > g_trace.stats.stagingPeak)
+    {
+        g_trace.stats.stagingPeak = used + len;
+    }
+    return true;
+}
+
+static bool isTraced                        (const CAN_MSG_T *psMsg)
+{
+    uint8_t i = 0;
+
+    if(g_trace.countFilters == 0)
+    {
+        return true;
+    }
+    for(i = 0; i < g_trace.countFilters; i++)
+    {
+        if(((psMsg->bIde ? true : false) == g_trace.filters[i].ide) &&
+           (((psMsg->u32MsgId ^ g_trace.filters[i].id) & g_trace.filters[i].mask) == 0))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void openSector                      (void)
+{
+    g_trace.sectorIndex = (g_trace.sectorIndex + 1) % CAN_TRACE_SECTOR_COUNT;
+    if((g_trace.sectorIndex % CAN_TRACE_SECTORS_PER_BLOCK) == 0)
+    {
+        // trace wrapped into the oldest block
+        if(NorFlashErrOk != nor_flash_erase_block(CAN_TRACE_FIRST_BLOCK + (g_trace.sectorIndex / CAN_TRACE_SECTORS_PER_BLOCK)))
+        {
+            g_trace.stats.countFlashErrors++;
+        }
+    }
+
+    memset(g_sector, 0xFF, sizeof(g_sector));
+    putLe(&g_sector[0], CAN_TRACE_MAGIC, 4);
+    putLe(&g_sector[4], g_trace.seq, 4);
+    putLe(&g_sector[8], g_trace.session, 4);
+    putLe(&g_sector[12], g_trace.timeUs, 4);
+    g_trace.seq++;
+    g_trace.sectorFill = CAN_TRACE_HEADER_SIZE;
+    g_trace.sectorFlushed = 0;
+    g_trace.sectorOpen = true;
+    g_trace.stats.countSectors++;
+}
+
+static void flushSector                     (bool all)
+{
+    uint16_t end = all ? (uint16_t)(((g_trace.sectorFill + NOR_FLASH_PAGE_SIZE - 1) / NOR_FLASH_PAGE_SIZE) * NOR_FLASH_PAGE_SIZE)
+                       : (uint16_t)((g_trace.sectorFill / NOR_FLASH_PAGE_SIZE) * NOR_FLASH_PAGE_SIZE);
+
+    if(end <= g_trace.sectorFlushed)
+    {
+        return;
+    }
+
+    // one write for all pages completed since the last call
+    if(NorFlashErrOk == nor_flash_write(CAN_TRACE_SECTOR_ADDRESS(g_trace.sectorIndex) + g_trace.sectorFlushed,
+                                        &g_sector[g_trace.sectorFlushed], end - g_trace.sectorFlushed))
+    {
+        g_trace.stats.bytesWritten += end - g_trace.sectorFlushed;
+    }
+    else
+    {
+        g_trace.stats.countFlashErrors++;
+    }
+    g_trace.sectorFlushed = end;
+}
+
+static uint8_t stagingByte                  (uint32_t offset)
+{
+    return g_staging[offset % CAN_TRACE_STAGING_SIZE];
+}
+
+static uint8_t putLe                        (uint8_t *buff, uint32_t value, uint8_t len)
+{
+    uint8_t i = 0;
+
+    for(i = 0; i < len; i++)
+    {
+        buff[i] = (uint8_t)(value >> (8 * i));
+    }
+    return len;
+}
+
+static uint32_t getLe                       (const uint8_t *buff, uint8_t len)
+{
+    uint32_t value = 0;
+    uint8_t i = 0;
+
+    for(i = 0; i < len; i++)
+    {
+        value |= (uint32_t)buff[i] << (8 * i);
+    }
+    return value;
+}
@@ -0,0 +1,122 @@
+/**
+ * @file        can_trace.h
+ *
+ * @copyright   Accolade Electronics Pvt Ltd, 2023-24
+ *              All Rights Reserved
+ *              UNPUBLISHED, LICENSED SOFTWARE.
+ *              Accolade Electronics, Pune
+ *              CONFIDENTIAL AND PROPRIETARY INFORMATION
+ *              WHICH IS THE PROPERTY OF M/s Accolade Electronics.
+ *
+ * @date        19 October 2026
+ * @author      agent <agent@local>
+ *
+ * @brief       CAN trace to the raw flash partition - header
+ *
+ * @details     Frames are encoded in the CAN interrupt into a RAM staging ring, CanTraceExe moves them into
+ *              4KB flash sectors and programs whole pages only. The trace area is used as a ring of 64KB blocks,
+ *              the oldest block is erased when the trace wraps.
+ *
+ *              Sector:     16 byte header, then records, unused tail left erased (0xFF).
+ *              Header:     magic "CTR1", sector sequence number, sequence number of the first sector of this boot,
+ *                          trace time in us at the start of the sector. All fields uint32_t little endian.
+ *              Record:     flags (uint8_t, see CAN_TRACE_FLAG_*), time since the previous record in us
+ *                          (uint16_t, uint32_t with CAN_TRACE_FLAG_LONG_DELTA), ID (uint16_t, uint32_t with
+ *                          CAN_TRACE_FLAG_IDE), data length (uint8_t), data. Multi byte fields are little endian.
+ *              A classic 8 byte frame with a standard ID takes 14 bytes.
+ *              Time record: flags CAN_TRACE_FLAG_TIME, then the trace time in us (uint32_t). Staged when no frame
+ *                          came for CAN_TRACE_TIME_RECORD_US, so deltas stay below half the timestamp counter range.
+ */
+
+#ifndef CAN_TRACE_H
+#define CAN_TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//#define CAN_TRACE_EN                              /* Trace all frames from boot. Off by default, a continuous trace wears the partition. */
+#define CAN_TRACE_FIRST_BLOCK               ( 240UL )       /* Start of the raw partition, sector 3840. */
+#define CAN_TRACE_BLOCK_COUNT               ( 15UL )        /* Last sectors of the partition are left to the flash self test. */
+#define CAN_TRACE_STAGING_SIZE              ( 16UL * 1024UL )   /* About 280 ms of a fully loaded 500 kbps bus. */
+#define CAN_TRACE_MAX_FILTERS               ( 8 )
+#define CAN_TRACE_HEADER_SIZE               ( 16 )
+#define CAN_TRACE_MAGIC                     ( 0x31525443UL )    /* "CTR1" */
+#define CAN_TRACE_MAX_RECORD_LEN            ( 1 + 4 + 4 + 1 + 64 )
+#define CAN_TRACE_TIME_RECORD_LEN           ( 1 + 4 )
+#define CAN_TRACE_TIME_RECORD_US            ( 10UL * 1000UL * 1000UL )  /* Timestamps alias after 35.8 s of silence. */
+
+#define CAN_TRACE_FLAG_IDE                  ( 0x01 )        /* 29 bit ID. */
+#define CAN_TRACE_FLAG_FDF                  ( 0x02 )        /* CAN FD frame. */
+#define CAN_TRACE_FLAG_BRS                  ( 0x04 )        /* CAN FD bit rate switch. */
+#define CAN_TRACE_FLAG_TX                   ( 0x08 )        /* Frame sent by this unit. */
+#define CAN_TRACE_FLAG_LONG_DELTA           ( 0x10 )        /* Time delta is 4 bytes. */
+#define CAN_TRACE_FLAG_TIME                 ( 0x20 )        /* Time record, no frame. */
+
+typedef struct
+{
+    uint32_t    id;
+    uint32_t    mask;                       /* Frame matches when (ID & mask) == (id & mask). */
+    bool        ide;                        /* true for extended ID frames, false for standard ID frames. */
+}CanTraceFilter_t;
+
+typedef struct
+{
+    uint32_t    timeUs;                     /* Trace time, wraps after 71 minutes. */
+    uint32_t    id;
+    uint8_t     flags;                      /* CAN_TRACE_FLAG_*, only timeUs is valid with CAN_TRACE_FLAG_TIME. */
+    uint8_t     len;
+    uint8_t     data[64];
+}CanTraceRecord_t;
+
+typedef struct
+{
+    uint32_t    countRecords;               /* Records staged. */
+    uint32_t    countDropped;               /* Records lost because the staging ring was full. */
+    uint32_t    countFlashErrors;           /* Failed flash read, erase or program. */
+    uint32_t    countSectors;               /* Sectors started. */
+    uint32_t    bytesWritten;               /* Bytes programmed, headers and padding included. */
+    uint32_t    stagingPeak;                /* Highest use of the staging ring in bytes. */
+}CanTraceStats_t;
+
+/**
+ * @brief                                   Finds the newest sector of the trace area and hooks into the CAN driver.
+ * @note                                    NOR flash must be initialized. Tracing starts with CanTraceStart.
+ */
+void CanTraceInit                           (void);
+
+/**
+ * @brief                                   Starts tracing.
+ * @param   filters                         Frames to trace, any frame when NULL or count is 0.
+ * @param   count                           Number of filters, up to CAN_TRACE_MAX_FILTERS.
+ * @param   traceTx                         Also trace frames sent by this unit.
+ * @return                                  false if the filters are invalid.
+ */
+bool CanTraceStart                          (const CanTraceFilter_t *filters, uint8_t count, bool traceTx);
+
+/**
+ * @brief                                   Stops tracing, staged records are still written.
+ */
+void CanTraceStop                           (void);
+
+/**
+ * @brief                                   Writes staged records to flash, run from a thread that can block on flash.
+ *                                          Also stages a time record after a long silence, call at least every few seconds.
+ */
+void CanTraceExe                            (void);
+
+/**
+ * @brief                                   Decodes one record of a sector.
+ * @param   buff                            Encoded record.
+ * @param   len                             Bytes left in the sector.
+ * @param   record                          In: previous record, timeUs from the header for the first one. Out: decoded record.
+ * @return                                  Bytes used by the record, 0 at the end of the sector or on a truncated record.
+ */
+uint16_t CanTraceDecode                     (const uint8_t *buff, uint16_t len, CanTraceRecord_t *record);
+
+/**
+ * @brief                                   Gives the trace statistics.
+ * @return                                  Copy of the statistics.
+ */
+CanTraceStats_t CanTraceGetStats            (void);
+
+#endif /* CAN_TRACE_H */
@@ -29,10 +29,12 @@
 #define SPI_Ch                              ( 3 )
 #define TIMEOUT_MS_WRITE                    ( 3 )
 #define TIMEOUT_MS_ERASE                    ( 400 )
+#define TIMEOUT_MS_ERASE_BLOCK              ( 2000 )
 #define REG_CHIP_ID                         ( 0x90 )
 #define REG_READ                            ( 0x03 )
 #define REG_PROGRAM                         ( 0x02 )
 #define REG_ERASE                           ( 0x20 )
+#define REG_ERASE_BLOCK                     ( 0xD8 )
 #define REG_STATUS                          ( 0x05 )
 #define REG_WREN                            ( 0x06 )
 #define NOR_FLASH_LOCK()                    if ( g_ctx.mutex.lock )     { g_ctx.mutex.lock();   }
@@ -58,6 +60,7 @@ static NorFlashErr_n read_status_register   (uint8_t* status);
 static NorFlashErr_n write_enable           (void);
 static NorFlashErr_n wait_complete          (uint32_t timeoutMs);
 static NorFlashErr_n page_write             (const uint32_t address, const uint8_t* const writeBuf, const size_t writeLen);
+static NorFlashErr_n erase                  (const uint8_t cmd, const uint32_t address, const uint32_t timeoutMs);
 
 NorFlashErr_n nor_flash_init                (HalSpiHandle_t halSpiHandle, iface_v_oaf_32_t fnDelayMs, iface_mutex_t mutex)
 {
@@ -187,34 +190,39 @@ NorFlashErr_n nor_flash_erase               (const uint32_t sector)
 {
     NorFlashErr_n err = NorFlashErrLowLevel;
     NorFlashCtx_t* ctx = &g_ctx;
-    uint32_t address = 0;
-    uint8_t cmdErase[4] = {REG_ERASE, 0, 0, 0};
-    HalBuffer_t buffer = {0};
     
     NOR_FLASH_LOCK();
     if ( true == ctx->isInit )
     {
         if ( sector < NOR_FLASH_SECTOR_COUNT )
         {
-            if ( NorFlashErrOk == write_enable() )
-            {
-                chip_select_activate();
-                address = sector << 12;
-                cmdErase[1] = (uint8_t) ( address >> 16 );
-                cmdErase[2] = (uint8_t) ( address >> 8  );
-                cmdErase[3] = (uint8_t) ( address >> 0  );
-                buffer.mem = cmdErase;
-                buffer.sizeMem = sizeof(cmdErase);
-                if ( HalSpiErrOk == hal_spi_write(ctx->handle, buffer, buffer.sizeMem) )
-                {
-                    err = NorFlashErrOk;
-                }
-                chip_select_deactivate();
-            }
-            if ( NorFlashErrOk == err )
-            {
-                err = wait_complete(TIMEOUT_MS_ERASE);
-            }
+            err = erase(REG_ERASE, sector * NOR_FLASH_SECTOR_SIZE, TIMEOUT_MS_ERASE);
+        }
+        else
+        {
+            err = NorFlashErrParam;
+        }
+    }
+    else
+    {
+        err = NorFlashErrForbidden;
+    }
+    NOR_FLASH_UNLOCK();
+
+    return err;
+}
+
+NorFlashErr_n nor_flash_erase_block         (const uint32_t block)
+{
+    NorFlashErr_n err = NorFlashErrLowLevel;
+    NorFlashCtx_t* ctx = &g_ctx;
+    
+    NOR_FLASH_LOCK();
+    if ( true == ctx->isInit )
+    {
+        if ( block < NOR_FLASH_BLOCK_COUNT )
+        {
+            err = erase(REG_ERASE_BLOCK, block * NOR_FLASH_BLOCK_SIZE, TIMEOUT_MS_ERASE_BLOCK);
         }
         else
         {
@@ -369,3 +377,32 @@ static NorFlashErr_n page_write             (const uint32_t address, const uint8
 
     return err;
 }
+
+static NorFlashErr_n erase                  (const uint8_t cmd, const uint32_t address, const uint32_t timeoutMs)
+{
+    NorFlashErr_n err = NorFlashErrLowLevel;
+    NorFlashCtx_t* ctx = &g_ctx;
+    uint8_t cmdErase[4] = {cmd, 0, 0, 0};
+    HalBuffer_t buffer = {0};
+
+    if ( NorFlashErrOk == write_enable() )
+    {
+        chip_select_activate();
+        cmdErase[1] = (uint8_t) ( address >> 16 );
+        cmdErase[2] = (uint8_t) ( address >> 8  );
+        cmdErase[3] = (uint8_t) ( address >> 0  );
+        buffer.mem = cmdErase;
+        buffer.sizeMem = sizeof(cmdErase);
+        if ( HalSpiErrOk == hal_spi_write(ctx->handle, buffer, buffer.sizeMem) )
+        {
+            err = NorFlashErrOk;
+        }
+        chip_select_deactivate();
+    }
+    if ( NorFlashErrOk == err )
+    {
+        err = wait_complete(timeoutMs);
+    }
+
+    return err;
+}
@@ -31,6 +31,10 @@
 #define NOR_FLASH_SECTOR_SIZE               ( 4096UL )
 #define NOR_FLASH_SECTOR_COUNT              ( 4096UL )
 
+// Block is the large 'erase' unit, faster per byte than sectors.
+#define NOR_FLASH_BLOCK_SIZE                ( 65536UL )
+#define NOR_FLASH_BLOCK_COUNT               ( 256UL )
+
 // Capacity.
 #define NOR_FLASH_CAPACITY_BYTES            ( NOR_FLASH_SECTOR_SIZE * NOR_FLASH_SECTOR_COUNT )
 
@@ -88,4 +92,14 @@ NorFlashErr_n nor_flash_write               (const uint32_t address, const uint8
 */
 NorFlashErr_n nor_flash_erase               (const uint32_t sector);
 
+/**
+ * @brief                                   Erases a 64KB block.
+ * @param       block                       A valid block number.
+ * @return                                  HalSpiErrOk:                Success.
+ *                                          NorFlashErrLowLevel:        If any SPI low-level error.
+ *                                          NorFlashErrParam            Invalid parameter value.
+ *                                          NorFlashErrForbidden:       If trying to use without initialization.
+*/
+NorFlashErr_n nor_flash_erase_block         (const uint32_t block);
+
 #endif /* NOR_FLASH_H */
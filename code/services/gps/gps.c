@@ -17,19 +17,32 @@
 
 // Standard includes.
 #include <stddef.h>
-#include <stdlib.h>
+#include <stdbool.h>
 #include <string.h>
 
 // Module includes.
 #include "gps.h"
+#include "gps_track.h"
 #include "tcu_board.h"
+#include "tcu_time.h"
 #include "hal_util.h"
 #include "logger_can.h"
 
 // Private defines.
 #define RX_BUFF_MAX_LEN     (1024)
 #define SENTENCE_MAX_LEN    (200)
-#define FIELD_MAX_CHARS     (15)
+#define NMEA_MAX_FIELDS     (24)
+#define COORD_SCALE         (10000000L)     // 1e-7 degrees per LSB
+
+#define UBX_SYNC_1          (0xB5)
+#define UBX_SYNC_2          (0x62)
+#define UBX_CLASS_NAV       (0x01)
+#define UBX_ID_NAV_PVT      (0x07)
+#define UBX_CLASS_CFG       (0x06)
+#define UBX_ID_CFG_MSG      (0x01)
+#define UBX_ID_CFG_RATE     (0x08)
+#define UBX_NAV_PVT_LEN     (92)
+#define UBX_MAX_PAYLOAD     (UBX_NAV_PVT_LEN)   // Longer frames are checked and skipped, not stored.
 
 typedef enum
 {
@@ -51,14 +64,64 @@ typedef enum
 {
     FIX_STATUS = 6,
     NUM_OF_SATELLITES = 7,
-    ALTITUDE = 8,
+    HDOP = 8,
+    ALTITUDE = 9,
 }GgaField_n;
 
 typedef enum
 {
-    SPEED_KMPH = 8
+    SPEED_KMPH = 7
 }VtgField_n;
 
+typedef enum
+{
+    NMEA_STATE_WAIT_SOF,                    /* Waiting for '$'. */
+    NMEA_STATE_BODY,                        /* Collecting fields until '*'. */
+    NMEA_STATE_CHECKSUM_HI,                 /* First hex digit of the checksum. */
+    NMEA_STATE_CHECKSUM_LO,                 /* Second hex digit of the checksum. */
+}NmeaState_n;
+
+typedef struct
+{
+    NmeaState_n state;
+    uint8_t     checksum;                   /* XOR of the bytes between '$' and '*', updated per byte. */
+    uint8_t     rxChecksum;                 /* Checksum received after '*'. */
+    uint8_t     len;                        /* Bytes stored in sentence. */
+    uint8_t     fieldCount;                 /* Fields recorded in fieldOffset. */
+    uint8_t     fieldOffset[NMEA_MAX_FIELDS]; /* Start of each field in sentence, field 0 is the sentence id. */
+    char        sentence[SENTENCE_MAX_LEN]; /* Sentence without '$', each ',' replaced by a terminator. */
+    uint32_t    countSentences;             /* Sentences received with a valid checksum. */
+    uint32_t    countCrcErrors;             /* Sentences dropped on checksum mismatch. */
+    uint32_t    countDropped;               /* Sentences dropped on length or invalid chars. */
+}NmeaParser_t;
+
+typedef enum
+{
+    UBX_STATE_SYNC_1,
+    UBX_STATE_SYNC_2,
+    UBX_STATE_CLASS,
+    UBX_STATE_ID,
+    UBX_STATE_LEN_LO,
+    UBX_STATE_LEN_HI,
+    UBX_STATE_PAYLOAD,
+    UBX_STATE_CK_A,
+    UBX_STATE_CK_B,
+}UbxState_n;
+
+typedef struct
+{
+    UbxState_n  state;
+    uint8_t     msgClass;
+    uint8_t     msgId;
+    uint16_t    len;                        /* Payload length from the header. */
+    uint16_t    idx;                        /* Payload bytes received. */
+    uint8_t     ckA;                        /* Fletcher checksum over class, id, length and payload, updated per byte. */
+    uint8_t     ckB;
+    uint8_t     payload[UBX_MAX_PAYLOAD];
+    uint32_t    countFrames;                /* Frames received with a valid checksum. */
+    uint32_t    countCrcErrors;             /* Frames dropped on checksum mismatch. */
+}UbxParser_t;
+
 /**
  * @brief Reads characters from the GPS UART into the provided buffer.
  * @param rxBuff        Pointer to the buffer to store received characters.
@@ -81,27 +144,88 @@ static uint32_t gpsUartWrite                (uint8_t *txBuff, uint32_t txLen);
 static void parseGpsPacket                  ( char *rxBuff, uint16_t rxLen);
 
 /**
- * @brief This is a generic function to parse a single NMEA sentence and update the internal GpsInfo structure.
- * @param fieldNum      Field index corresponding to the enumerator RmcField_n or GgaField_n.
- * @param inputStr      Pointer to the buffer containing a single complete NMEA sentence.
- * @param len           Length of the passed buffer.
+ * @brief Feeds one byte to the NMEA state machine. Checksum and field offsets are updated as the byte arrives.
+ * @param parser        Parser state.
+ * @param ch            Received byte.
+ */
+static void parseNmeaByte                   (NmeaParser_t *parser, char ch);
+
+/**
+ * @brief Feeds one byte to the UBX frame state machine.
+ * @param parser        Parser state.
+ * @param ch            Received byte.
+ * @return              true if the byte belongs to a UBX frame, false if it is to be given to the NMEA parser.
+ */
+static bool parseUbxByte                    (UbxParser_t *parser, uint8_t ch);
+
+/**
+ * @brief Updates the internal GpsInfo structure from a NAV-PVT payload, one frame holds the full solution.
+ * @param payload       NAV-PVT payload of UBX_NAV_PVT_LEN bytes.
  */
-static void parseNmeaSentence               (uint8_t fieldNum, char *inputStr, uint32_t len);
+static void processUbxNavPvt                (const uint8_t *payload);
 
+#ifdef GPS_UBX_EN
 /**
- * @brief This is a function for calculating string CRC and comparing received CRC
- * @param date      NMEA String for calculating CRC. Multiple NMEA strings are not allowed in the input buffer
- * @param len      	String length of the NMEA sentence
- * @return          Returns 1 if CRC is correct and 0 if CRC is incorrect
+ * @brief Sends a UBX frame to the receiver, checksum is added here.
+ * @param msgClass      Message class.
+ * @param msgId         Message id.
+ * @param payload       Payload of the message.
+ * @param len           Length of the payload.
  */
-static uint8_t isCrcValid                   (char *sentence, uint8_t len);
+static void sendUbxFrame                    (uint8_t msgClass, uint8_t msgId, const uint8_t *payload, uint16_t len);
 
 /**
- * @brief This is a function for converting string hex value to the decimal . e.g char array "0E" will return 14
- * @param date      Hex value in string
- * @return          Returns the decimal equivalent of the hex string
+ * @brief Sets the receiver rate to GPS_FIX_RATE_HZ and enables NAV-PVT output.
  */
-static int hexStringToDec                   (char *hexStr, uint8_t len);
+static void configureUbx                    (void);
+#endif
+
+/**
+ * @brief Reads a little endian 32 bit value.
+ */
+static uint32_t readLe32                    (const uint8_t *buff);
+
+/**
+ * @brief Updates the internal GpsInfo structure from a complete sentence with a valid checksum.
+ * @param parser        Parser holding the sentence and its field offsets.
+ */
+static void processNmeaSentence             (NmeaParser_t *parser);
+
+/**
+ * @brief Returns a field of the parsed sentence.
+ * @param parser        Parser holding the sentence.
+ * @param fieldNum      Field index corresponding to the enumerator RmcField_n, GgaField_n or VtgField_n.
+ * @return              Pointer to the terminated field, NULL if the field is missing or empty.
+ */
+static const char *getField                 (NmeaParser_t *parser, uint8_t fieldNum);
+
+/**
+ * @brief Converts a decimal field to integer and fraction parts without floating point.
+ * @param field         Field holding an optional '-', digits and an optional decimal point.
+ * @param fracDigits    Number of fraction digits to keep, extra digits are truncated and missing ones are zero.
+ * @param negative      Set to true if the field starts with '-'.
+ * @param intPart       Digits before the decimal point.
+ * @param fracPart      Fraction scaled by 10^fracDigits.
+ * @return              true if the field is a valid number.
+ */
+static bool parseDecimal                    (const char *field, uint8_t fracDigits, bool *negative, uint32_t *intPart, uint32_t *fracPart);
+
+/**
+ * @brief Converts a NMEA ddmm.mmmm or dddmm.mmmm coordinate and its direction to 1e-7 degrees.
+ * @param parser        Parser holding the sentence.
+ * @param fieldNum      Field of the coordinate, the direction is the next field.
+ * @param negativeDir   Direction letter giving a negative value, 'S' or 'W'.
+ * @param value         Output coordinate.
+ * @return              true if the coordinate is valid.
+ */
+static bool parseCoordinate                 (NmeaParser_t *parser, uint8_t fieldNum, char negativeDir, int32_t *value);
+
+/**
+ * @brief Converts one hex digit.
+ * @param ch            Hex digit, upper or lower case.
+ * @return              Value of the digit, -1 if it is not a hex digit.
+ */
+static int8_t hexCharToDec                  (char ch);
 
 /**
  * @brief Dummy function which ignores arguments.
@@ -115,6 +239,12 @@ static uint32_t gpsDataReady(void);
 
 // Private variables. 
 static GpsInfo_t g_gpsInfo;
+static NmeaParser_t g_nmeaParser;
+static UbxParser_t g_ubxParser;
+static uint8_t g_newSolution = 0;          // Set when the last sentence of an epoch or a NAV-PVT is parsed.
+#ifdef GPS_UBX_EN
+static uint8_t g_ubxConfigured = 0;
+#endif
 static logger_gps_t g_logger = logger_dummy;
 
 void GpsInit                                (logger_gps_t logger)
@@ -123,6 +253,7 @@ void GpsInit                                (logger_gps_t logger)
     {
         g_logger = logger;
     }
+    GpsTrackInit();
 }
 
 static uint32_t gpsUartRead                 (uint8_t *rxBuff, uint32_t maxBuffSize)
@@ -138,7 +269,7 @@ static uint32_t gpsUartRead                 (uint8_t *rxBuff, uint32_t maxBuffSi
             {
                 readByte = buf.sizeMem;
             }
-            if ( HalUartErrOk == hal_uart_read(g_UartGps, buf, readByte) )
+            if ( HalUartErrOk != hal_uart_read(g_UartGps, buf, readByte) )
             {
                 readByte = 0;
             }
@@ -161,7 +292,7 @@ static uint32_t gpsUartWrite                (uint8_t *txBuff, uint32_t txLen)
             {
                 writeByte = buf.sizeMem;
             }
-            if ( HalUartErrOk == hal_uart_write(g_UartGps, buf, writeByte) )
+            if ( HalUartErrOk != hal_uart_write(g_UartGps, buf, writeByte) )
             {
                 writeByte = 0;
             }
@@ -195,251 +326,515 @@ void GpsExe                                 (void)
         rxLen = gpsUartRead(rxBuff, RX_BUFF_MAX_LEN);
 
         parseGpsPacket((char*)rxBuff, rxLen);
+#ifdef GPS_UBX_EN
+        // receiver is up once it talks, configure it once
+        if ( !g_ubxConfigured && rxLen )
+        {
+            g_ubxConfigured = 1;
+            configureUbx();
+        }
+#endif
+    }
+
+    // one history entry per solution with a fix
+    if ( g_newSolution )
+    {
+        g_newSolution = 0;
+        if ( g_gpsInfo.fixStatus )
+        {
+            TcuTime_t uptime = tcu_time_uptime();
+            GpsTrackFix_t fix = { uptime.seconds * 1000UL + uptime.fractional / 1000UL, g_gpsInfo.latitude, g_gpsInfo.longitude,
+                                  g_gpsInfo.altitude, g_gpsInfo.speed };
+            GpsTrackAdd(&fix);
+        }
     }
     // assuming 20ms pooling, print every 2 sec
     if ( printTmr == 100 )
     {
         printTmr = 0;
-        g_logger("gps utc_time %d date %u fix %d lat %f long %f speed_kph %.2f num_sat %d alt %.2f\n\r", \
-        g_gpsInfo.utcTime, g_gpsInfo.date, g_gpsInfo.fixStatus, g_gpsInfo.latitude , g_gpsInfo.longitude , g_gpsInfo.speed , g_gpsInfo.numOfSatellites , g_gpsInfo.altitude);
+        g_logger("gps utc_time %d date %u fix %d lat_e7 %ld long_e7 %ld speed_cms %lu num_sat %d alt_mm %ld\n\r", \
+        g_gpsInfo.utcTime, g_gpsInfo.date, g_gpsInfo.fixStatus, (long)g_gpsInfo.latitude , (long)g_gpsInfo.longitude , (unsigned long)g_gpsInfo.speed , g_gpsInfo.numOfSatellites , (long)g_gpsInfo.altitude);
+        g_logger("gps nmea ok %u crc_err %u dropped %u ubx ok %u crc_err %u\n\r", g_nmeaParser.countSentences, g_nmeaParser.countCrcErrors, g_nmeaParser.countDropped,
+        g_ubxParser.countFrames, g_ubxParser.countCrcErrors);
     }
     printTmr++;
 
     LoggerCan_u sysGpsA = {0};
     sysGpsA.gpsA.latitude = g_gpsInfo.latitude; 
     sysGpsA.gpsA.longitude = g_gpsInfo.longitude; 
-    logger_can_set(LoggerCan000_SysA, sysGpsA);
+    logger_can_set(LoggerCan008_GpsA, sysGpsA);
 }
 
 static void parseGpsPacket                  (char *rxBuff, uint16_t rxLen)
 {
-    char *startPtr = NULL;
-    char *endPtr = NULL;
     uint32_t idx = 0;
-    char sentence[SENTENCE_MAX_LEN] = {0};
-    uint8_t validSof = 0;
 
     if(rxBuff == NULL || rxLen == 0)
     {
         return;
     }
-    
-    hal_util_memset(sentence, 0x00, sizeof(sentence));
-    
-    while(idx < rxLen)
+
+    // parser state persists, a sentence split across two reads is completed by the next chunk
+    for(idx = 0; idx < rxLen; idx++)
     {
-        // start of the NMEA sentence found
-        if( rxBuff[idx] == '$' )
+        if(!parseUbxByte(&g_ubxParser, (uint8_t)rxBuff[idx]))
         {
-            startPtr = (char*)rxBuff+idx;
-            validSof = 1;
+            parseNmeaByte(&g_nmeaParser, rxBuff[idx]);
         }
-        // end of the sentence found
-        if(rxBuff[idx] == '\n' && validSof)
+    }
+}
+
+static bool parseUbxByte                    (UbxParser_t *parser, uint8_t ch)
+{
+    switch(parser->state)
+    {
+        case UBX_STATE_SYNC_1:
         {
-            endPtr = (char*)rxBuff+idx;
+            if(ch != UBX_SYNC_1)
+            {
+                return false;
+            }
+            parser->state = UBX_STATE_SYNC_2;
+            return true;
+        }
+        case UBX_STATE_SYNC_2:
+        {
+            if(ch != UBX_SYNC_2)
+            {
+                parser->state = UBX_STATE_SYNC_1;
+                return false;
+            }
+            parser->ckA = 0;
+            parser->ckB = 0;
+            parser->state = UBX_STATE_CLASS;
+            return true;
+        }
+        case UBX_STATE_CK_A:
+        {
+            parser->state = (ch == parser->ckA) ? UBX_STATE_CK_B : UBX_STATE_SYNC_1;
+            if(parser->state == UBX_STATE_SYNC_1)
+            {
+                parser->countCrcErrors++;
+            }
+            return true;
+        }
+        case UBX_STATE_CK_B:
+        {
+            parser->state = UBX_STATE_SYNC_1;
+            if(ch != parser->ckB)
+            {
+                parser->countCrcErrors++;
+                return true;
+            }
+            parser->countFrames++;
+            if(parser->msgClass == UBX_CLASS_NAV && parser->msgId == UBX_ID_NAV_PVT && parser->len == UBX_NAV_PVT_LEN)
+            {
+                processUbxNavPvt(parser->payload);
+            }
+            return true;
+        }
+        default:
+        {
+            break;
+        }
+    }
 
-            // complete sentence found, copy to temporary buffer for parsing
-            strncpy(sentence, startPtr, endPtr-startPtr);
+    // class, id, length and payload are covered by the checksum
+    parser->ckA += ch;
+    parser->ckB += parser->ckA;
 
-            // parse the sentence and update various results
-            parseNmeaSentence(UTC_TIME, sentence, strlen(sentence));
-            parseNmeaSentence(LATITUDE, sentence, strlen(sentence));
-            parseNmeaSentence(LONGITUDE, sentence, strlen(sentence));
-            parseNmeaSentence(SPEED_KMPH, sentence, strlen(sentence));
-            parseNmeaSentence(DATE, sentence, strlen(sentence));
-            parseNmeaSentence(FIX_STATUS, sentence, strlen(sentence));
-            parseNmeaSentence(NUM_OF_SATELLITES, sentence, strlen(sentence));
-            parseNmeaSentence(ALTITUDE, sentence, strlen(sentence));
+    switch(parser->state)
+    {
+        case UBX_STATE_CLASS:
+        {
+            parser->msgClass = ch;
+            parser->state = UBX_STATE_ID;
+            break;
+        }
+        case UBX_STATE_ID:
+        {
+            parser->msgId = ch;
+            parser->state = UBX_STATE_LEN_LO;
+            break;
+        }
+        case UBX_STATE_LEN_LO:
+        {
+            parser->len = ch;
+            parser->state = UBX_STATE_LEN_HI;
+            break;
         }
-        idx++;
+        case UBX_STATE_LEN_HI:
+        {
+            parser->len |= (uint16_t)ch << 8;
+            parser->idx = 0;
+            parser->state = (parser->len > 0) ? UBX_STATE_PAYLOAD : UBX_STATE_CK_A;
+            break;
+        }
+        case UBX_STATE_PAYLOAD:
+        {
+            if(parser->idx < UBX_MAX_PAYLOAD)
+            {
+                parser->payload[parser->idx] = ch;
+            }
+            if(++parser->idx >= parser->len)
+            {
+                parser->state = UBX_STATE_CK_A;
+            }
+            break;
+        }
+        default:
+        {
+            parser->state = UBX_STATE_SYNC_1;
+            break;
+        }
+    }
+    return true;
+}
+
+static void processUbxNavPvt                (const uint8_t *payload)
+{
+    uint8_t fixType = payload[20];
+    uint8_t flags = payload[21];
+    uint32_t year = (uint32_t)payload[4] | ((uint32_t)payload[5] << 8);
+
+    // same encoding as the NMEA path, hhmmss and ddmmyy
+    g_gpsInfo.utcTime = (uint32_t)payload[8] * 10000UL + (uint32_t)payload[9] * 100UL + payload[10];
+    g_gpsInfo.date = (uint32_t)payload[7] * 10000UL + (uint32_t)payload[6] * 100UL + (year % 100);
+
+    // GGA quality: 0 no fix, 1 fix, 2 differential
+    if((flags & 0x01) && fixType >= 2 && fixType <= 4)
+    {
+        g_gpsInfo.fixStatus = (flags & 0x02) ? 2 : 1;
     }
+    else
+    {
+        g_gpsInfo.fixStatus = 0;
+    }
+    g_gpsInfo.numOfSatellites = payload[23];
+
+    // NAV-PVT is already 1e-7 degrees and mm, ground speed is mm/s
+    g_gpsInfo.longitude = (int32_t)readLe32(&payload[24]);
+    g_gpsInfo.latitude = (int32_t)readLe32(&payload[28]);
+    g_gpsInfo.altitude = (int32_t)readLe32(&payload[36]);
+    g_gpsInfo.speed = ((uint32_t)readLe32(&payload[60]) + 5UL) / 10UL;
+    g_newSolution = 1;
 }
 
-static void parseNmeaSentence               (uint8_t fieldNum, char *inputStr, uint32_t len)
+#ifdef GPS_UBX_EN
+static void sendUbxFrame                    (uint8_t msgClass, uint8_t msgId, const uint8_t *payload, uint16_t len)
 {
-    char resultStr[FIELD_MAX_CHARS] = {0};
-    uint32_t startIdx = 0;
-    uint32_t endIdx = 0;
-    int skipCount = 0;
-    uint8_t resultLen = 0;
+    uint8_t frame[6 + 8 + 2];
+    uint16_t idx = 0;
+    uint8_t ckA = 0;
+    uint8_t ckB = 0;
 
-    if(inputStr == NULL || len == 0)
+    if(len > 8)
     {
         return;
     }
 
-    // find the start index
-    for(; startIdx < len; startIdx++)
+    frame[0] = UBX_SYNC_1;
+    frame[1] = UBX_SYNC_2;
+    frame[2] = msgClass;
+    frame[3] = msgId;
+    frame[4] = (uint8_t)len;
+    frame[5] = (uint8_t)(len >> 8);
+    memcpy(&frame[6], payload, len);
+    for(idx = 2; idx < 6 + len; idx++)
     {
-        if(inputStr[startIdx] == ',')
+        ckA += frame[idx];
+        ckB += ckA;
+    }
+    frame[idx++] = ckA;
+    frame[idx++] = ckB;
+    gpsUartWrite(frame, idx);
+}
+
+static void configureUbx                    (void)
+{
+    uint16_t measRateMs = 1000 / GPS_FIX_RATE_HZ;
+    // CFG-RATE: measurement rate, one solution per measurement, UTC time reference
+    const uint8_t cfgRate[6] = { (uint8_t)measRateMs, (uint8_t)(measRateMs >> 8), 1, 0, 0, 0 };
+    // CFG-MSG: NAV-PVT on every solution on the current port
+    const uint8_t cfgMsg[3] = { UBX_CLASS_NAV, UBX_ID_NAV_PVT, 1 };
+
+    sendUbxFrame(UBX_CLASS_CFG, UBX_ID_CFG_RATE, cfgRate, sizeof(cfgRate));
+    sendUbxFrame(UBX_CLASS_CFG, UBX_ID_CFG_MSG, cfgMsg, sizeof(cfgMsg));
+}
+#endif
+
+static uint32_t readLe32                    (const uint8_t *buff)
+{
+    return (uint32_t)buff[0] | ((uint32_t)buff[1] << 8) | ((uint32_t)buff[2] << 16) | ((uint32_t)buff[3] << 24);
+}
+
+static void parseNmeaByte                   (NmeaParser_t *parser, char ch)
+{
+    int8_t nibble = 0;
+
+    // '$' always starts a new sentence, whatever was pending is dropped
+    if(ch == '$')
+    {
+        if(parser->state != NMEA_STATE_WAIT_SOF)
         {
-            skipCount++;
-            if(skipCount == fieldNum)
-            {
-                // delimiter was found at exact this index, to skip it during string copy, increment by 1
-                startIdx++;
-                break;
-            }
+            parser->countDropped++;
         }
+        parser->state = NMEA_STATE_BODY;
+        parser->checksum = 0;
+        parser->rxChecksum = 0;
+        parser->len = 0;
+        parser->fieldCount = 1;
+        parser->fieldOffset[0] = 0;
+        return;
     }
 
-    // find the end index
-    for(endIdx = startIdx + 1; endIdx < len; endIdx++)
+    switch(parser->state)
     {
-        if(inputStr[endIdx] == ',')
+        case NMEA_STATE_BODY:
+        {
+            if(ch == '*')
+            {
+                parser->sentence[parser->len] = '\0';
+                parser->state = NMEA_STATE_CHECKSUM_HI;
+            }
+            // sentence too long or broken by a line end or binary data
+            else if((parser->len >= (SENTENCE_MAX_LEN - 1)) || (ch < ' ') || (ch > '~'))
+            {
+                parser->countDropped++;
+                parser->state = NMEA_STATE_WAIT_SOF;
+            }
+            else
+            {
+                parser->checksum ^= (uint8_t)ch;
+                if(ch == ',')
+                {
+                    // terminate the field in place and record where the next one starts
+                    parser->sentence[parser->len++] = '\0';
+                    if(parser->fieldCount < NMEA_MAX_FIELDS)
+                    {
+                        parser->fieldOffset[parser->fieldCount++] = parser->len;
+                    }
+                }
+                else
+                {
+                    parser->sentence[parser->len++] = ch;
+                }
+            }
+            break;
+        }
+        case NMEA_STATE_CHECKSUM_HI:
+        case NMEA_STATE_CHECKSUM_LO:
+        {
+            nibble = hexCharToDec(ch);
+            if(nibble < 0)
+            {
+                parser->countDropped++;
+                parser->state = NMEA_STATE_WAIT_SOF;
+                break;
+            }
+            parser->rxChecksum = (uint8_t)((parser->rxChecksum << 4) | nibble);
+            if(parser->state == NMEA_STATE_CHECKSUM_HI)
+            {
+                parser->state = NMEA_STATE_CHECKSUM_LO;
+                break;
+            }
+            if(parser->rxChecksum == parser->checksum)
+            {
+                parser->countSentences++;
+                processNmeaSentence(parser);
+            }
+            else
+            {
+                parser->countCrcErrors++;
+            }
+            parser->state = NMEA_STATE_WAIT_SOF;
+            break;
+        }
+        case NMEA_STATE_WAIT_SOF:
+        default:
         {
             break;
         }
     }
+}
 
-    // copy chars which occur between the start and end from the offset w.r.t original string
-    hal_util_memset(resultStr, 0x00, FIELD_MAX_CHARS);
-    strncpy(resultStr, inputStr+startIdx, endIdx-startIdx);
-
-    resultLen = strlen(resultStr);
+static void processNmeaSentence             (NmeaParser_t *parser)
+{
+    const char *id = parser->sentence;
+    bool negative = false;
+    uint32_t intPart = 0;
+    uint32_t fracPart = 0;
+    int32_t value = 0;
 
-    // quick validate for invalid chars in the result string. Only digits and decimal allowed. It also rejects empty data (eg. ,,,)
-    for(int i=0; i<resultLen; i++)
+    if(strcmp(id, "GNRMC") == 0)
     {
-        if( (resultStr[i] >= '0' && resultStr[i] <= '9') || resultStr[i] == '.')
+        if(parseDecimal(getField(parser, UTC_TIME), 0, &negative, &intPart, &fracPart))
         {
-            continue;
+            g_gpsInfo.utcTime = intPart;
         }
-        else
+        if(parseCoordinate(parser, LATITUDE, 'S', &value))
         {
-            return;     // unwanted char found
+            g_gpsInfo.latitude = value;
         }
-    }
-
-    // save the requested field to global stuct
-    if((strstr(inputStr, "$GNRMC,")) && isCrcValid(inputStr, strlen(inputStr)))
-    {
-        switch(fieldNum)
+        if(parseCoordinate(parser, LONGITUDE, 'W', &value))
+        {
+            g_gpsInfo.longitude = value;
+        }
+        if(parseDecimal(getField(parser, DATE), 0, &negative, &intPart, &fracPart))
         {
-            case UTC_TIME           : {g_gpsInfo.utcTime         = atof(resultStr);  break; }
-            case LATITUDE           : {g_gpsInfo.latitude        = atof(resultStr);  break; }
-            case LONGITUDE          : {g_gpsInfo.longitude       = atof(resultStr);  break; }
-            case DATE               : {g_gpsInfo.date            = atoi(resultStr);  break; }
-            
+            g_gpsInfo.date = intPart;
         }
     }
-    if((strstr(inputStr, "$GNGGA,")) && isCrcValid(inputStr, strlen(inputStr)))
+    else if(strcmp(id, "GNGGA") == 0)
     {
-        switch(fieldNum)
+        if(parseDecimal(getField(parser, FIX_STATUS), 0, &negative, &intPart, &fracPart))
+        {
+            g_gpsInfo.fixStatus = (uint8_t)intPart;
+        }
+        if(parseDecimal(getField(parser, NUM_OF_SATELLITES), 0, &negative, &intPart, &fracPart))
+        {
+            g_gpsInfo.numOfSatellites = (uint8_t)intPart;
+        }
+        // metres with 3 fraction digits is mm
+        if(parseDecimal(getField(parser, ALTITUDE), 3, &negative, &intPart, &fracPart))
         {
-            case FIX_STATUS         : {g_gpsInfo.fixStatus       = atoi(resultStr);  break; }
-            case NUM_OF_SATELLITES  : {g_gpsInfo.numOfSatellites = atoi(resultStr);  break; }
-            case ALTITUDE           : {g_gpsInfo.altitude        = atof(resultStr);  break; }
+            value = (int32_t)(intPart * 1000UL + fracPart);
+            g_gpsInfo.altitude = negative ? -value : value;
         }
+        // receiver sends RMC, VTG then GGA, the epoch is complete here
+        g_newSolution = 1;
     }
-    if((strstr(inputStr, "$GNVTG,")) && isCrcValid(inputStr, strlen(inputStr)))
+    else if(strcmp(id, "GNVTG") == 0)
     {
-        switch(fieldNum)
+        // km/h in 1e-3 to cm/s, 1 km/h = 250/9 cm/s, rounded
+        if(parseDecimal(getField(parser, SPEED_KMPH), 3, &negative, &intPart, &fracPart) && !negative)
         {
-            case SPEED_KMPH         : {g_gpsInfo.speed           = atof(resultStr);  break; }
+            g_gpsInfo.speed = ((intPart * 1000UL + fracPart) * 25UL + 450UL) / 900UL;
         }
     }
 }
 
-GpsInfo_t GpsGetInfo                        (void)
+static const char *getField                 (NmeaParser_t *parser, uint8_t fieldNum)
 {
-    GpsInfo_t tmpStruct = g_gpsInfo;
-    return tmpStruct;
+    const char *field = NULL;
+
+    if(fieldNum >= parser->fieldCount)
+    {
+        return NULL;
+    }
+    field = &parser->sentence[parser->fieldOffset[fieldNum]];
+
+    // rejects empty data (eg. ,,,)
+    return (field[0] != '\0') ? field : NULL;
 }
 
-static uint8_t isCrcValid                   (char *sentence, uint8_t len)
+static bool parseDecimal                    (const char *field, uint8_t fracDigits, bool *negative, uint32_t *intPart, uint32_t *fracPart)
 {
-    char *startPtr = NULL;
-    char *endPtr = NULL;
-    char payload[SENTENCE_MAX_LEN] = {0};
-    char rxCrcStr[3] = {0};
-    int calCrc = 0, rxCrc = 0;
-    uint8_t validSof = 0;
-    uint8_t retVal = 0;
-    
-    if(sentence == NULL || len == 0)
+    uint32_t intValue = 0;
+    uint32_t fracValue = 0;
+    uint8_t intCount = 0;
+    uint8_t fracCount = 0;
+    bool inFraction = false;
+
+    if(field == NULL)
     {
-        return 0;
+        return false;
     }
 
-    hal_util_memset(payload, 0x00, sizeof(payload));
-    hal_util_memset(rxCrcStr, 0x00, sizeof(rxCrcStr));
+    *negative = (*field == '-');
+    if(*negative)
+    {
+        field++;
+    }
 
-    for(int itr=0; itr < len; itr++)
+    // Only digits and one decimal allowed, at most 9 integer digits so the value fits 32 bits
+    for(; *field != '\0'; field++)
     {
-        // find the SOF
-        if( *(sentence + itr) == '$')
+        if(*field == '.' && !inFraction)
         {
-            startPtr = (sentence + itr);
-            // CRC must be calculated on the data excluding the $ and *
-            startPtr++;
-            validSof = 1;
+            inFraction = true;
         }
-        if( *(sentence + itr) == '*' && validSof == 1)
+        else if(*field < '0' || *field > '9')
         {
-            endPtr = (sentence + itr);
-            
-            // extract the payload excluding $ and *
-            strncpy(payload, startPtr, endPtr-startPtr);
-            
-            // extract the CRC string from the NMEA string
-            // endPtr is now at * so increment by 1 for pointing to CRC
-            strncpy(rxCrcStr, ++endPtr, 2);
-            
-            // calculate the CRC of the payload
-            for(int itr=0; itr < strlen(payload); itr++)
-            {
-                calCrc ^= payload[itr];
-            }
-            
-            // convert hex in format of ascii string to decimal 
-            rxCrc = hexStringToDec(rxCrcStr, strlen(rxCrcStr));
-            
-            if(rxCrc == calCrc)
-            {
-                retVal = 1;
-            }
-            else
+            return false;
+        }
+        else if(!inFraction)
+        {
+            if(++intCount > 9)
             {
-                retVal = 0;
+                return false;
             }
+            intValue = intValue * 10 + (uint32_t)(*field - '0');
         }
+        else if(fracCount < fracDigits)
+        {
+            fracValue = fracValue * 10 + (uint32_t)(*field - '0');
+            fracCount++;
+        }
+    }
+
+    if(intCount == 0 && fracCount == 0)
+    {
+        return false;
+    }
+    for(; fracCount < fracDigits; fracCount++)
+    {
+        fracValue *= 10;
     }
-    return retVal;
+
+    *intPart = intValue;
+    *fracPart = fracValue;
+    return true;
 }
 
-static int hexStringToDec                   (char *hexStr, uint8_t len)
+static bool parseCoordinate                 (NmeaParser_t *parser, uint8_t fieldNum, char negativeDir, int32_t *value)
 {
-    int base = 1;
-    int decimal = 0;
+    const char *dir = getField(parser, fieldNum + 1);
+    bool negative = false;
+    uint32_t intPart = 0;
+    uint32_t fracPart = 0;
+    uint32_t minutes = 0;
+
+    // fraction of minutes kept with 7 digits, minutes / 60 then gives 1e-7 degrees
+    if(dir == NULL || !parseDecimal(getField(parser, fieldNum), 7, &negative, &intPart, &fracPart) || negative)
+    {
+        return false;
+    }
+    if((intPart % 100) >= 60 || (intPart / 100) > 180)
+    {
+        return false;
+    }
 
-    if(hexStr == NULL || len == 0)
+    minutes = (intPart % 100) * (uint32_t)COORD_SCALE + fracPart;
+    *value = (int32_t)((intPart / 100) * (uint32_t)COORD_SCALE + (minutes + 30) / 60);
+    if(*dir == negativeDir)
     {
-        return 0;
+        *value = -*value;
     }
- 
-    // Instead of reading characters from Right-To-Left we can also read character from Left-To-Right
-    // We just have to initialize p with strlen(c) - 1 and decrement p in each iteration
-    for ( int i = len - 1 ; i >= 0 ; --i )
+    return true;
+}
+
+GpsInfo_t GpsGetInfo                        (void)
+{
+    GpsInfo_t tmpStruct = g_gpsInfo;
+    return tmpStruct;
+}
+
+static int8_t hexCharToDec                  (char ch)
+{
+    if ( ch >= '0' && ch <= '9' )
     {
-        if ( hexStr[i] >= '0' && hexStr[i] <= '9' )
-        {
-            decimal += (hexStr[i] - 48) * base;
-            base *= 16;
-        }
-        else if ( hexStr[i] >= 'A' && hexStr[i] <= 'F' )
-        {
-            decimal += (hexStr[i] - 55) * base;
-            base *= 16;
-        }
-        else if ( hexStr[i] >= 'a' && hexStr[i] <= 'f' )
-        {
-            decimal += (hexStr[i] - 87) * base;
-            base *= 16;
-        }
+        return ch - '0';
+    }
+    if ( ch >= 'A' && ch <= 'F' )
+    {
+        return ch - 'A' + 10;
+    }
+    if ( ch >= 'a' && ch <= 'f' )
+    {
+        return ch - 'a' + 10;
     }
-    return decimal;
+    return -1;
 }
 
 static void logger_dummy                    (char* fmt, ...)
@@ -20,18 +20,21 @@
 #include <stdint.h>
 #include <stdarg.h>
 
+#define GPS_FIX_RATE_HZ                     (10)    /* Position output rate, 1, 2, 5 or 10 Hz. */
+//#define GPS_UBX_EN                                /* u-blox receiver on the GPS UART, configured for UBX NAV-PVT output. */
+
 typedef void (*logger_gps_t)(char* fmt, ...);
 
 typedef struct
 {
-    uint32_t    utcTime;
-    uint32_t    date;
-    float       latitude;
-    float       longitude;
+    uint32_t    utcTime;                    /* hhmmss */
+    uint32_t    date;                       /* ddmmyy */
+    int32_t     latitude;                   /* Degrees * 1e7, south is negative. */
+    int32_t     longitude;                  /* Degrees * 1e7, west is negative. */
     uint8_t     fixStatus;
     uint8_t     numOfSatellites;
-    float       altitude;
-    float       speed;
+    int32_t     altitude;                   /* mm above mean sea level. */
+    uint32_t    speed;                      /* cm/s over ground. */
 }GpsInfo_t;
 
 /**
@@ -0,0 +1,296 @@
+/**
+ * @file        gps_track.c
+ *
+ * @copyright   Accolade Electronics Pvt Ltd, 2023-24
+ *              All Rights Reserved
+ *              UNPUBLISHED, LICENSED SOFTWARE.
+ *              Accolade Electronics, Pune
+ *              CONFIDENTIAL AND PROPRIETARY INFORMATION
+ *              WHICH IS THE PROPERTY OF M/s Accolade Electronics.
+ *
+ * @date        19 October 2026
+ * @author      agent <agent@local>
+ *
+ * @brief       RAM history of timestamped GPS fixes
+ */
+
+// Standard includes.
+#include <stddef.h>
+#include <string.h>
+
+// Module includes.
+#include "gps_track.h"
+
+typedef struct
+{
+    uint8_t         mem[GPS_TRACK_BUFF_SIZE];
+    uint16_t        head;                   /* Next byte to write. */
+    uint16_t        tail;                   /* First byte of the oldest record. */
+    uint16_t        used;
+    GpsTrackFix_t   headFix;                /* Last stored fix, base of the next record. */
+    int32_t         headStepMs;
+    GpsTrackFix_t   tailFix;                /* Last removed fix, base of the oldest record. */
+    int32_t         tailStepMs;
+    GpsTrackStats_t stats;
+}GpsTrack_t;
+
+/**
+ * @brief Encodes a fix as a record relative to a base fix.
+ * @param buff          Output of at least GPS_TRACK_MAX_RECORD_LEN bytes.
+ * @param fix           Fix to encode.
+ * @param base          Previous fix.
+ * @param stepMs        In: previous time step. Out: time step of this fix.
+ * @return              Length of the record.
+ */
+static uint16_t encodeRecord                (uint8_t *buff, const GpsTrackFix_t *fix, const GpsTrackFix_t *base, int32_t *stepMs);
+
+/**
+ * @brief Decodes the oldest record without removing it.
+ * @param fix           Decoded fix.
+ * @param stepMs        Time step of the decoded fix.
+ * @return              Length of the record, 0 if the ring is empty.
+ */
+static uint16_t peekRecord                  (GpsTrackFix_t *fix, int32_t *stepMs);
+
+/**
+ * @brief Removes the oldest record after it was peeked.
+ */
+static void dropRecord                      (uint16_t len, const GpsTrackFix_t *fix, int32_t stepMs);
+
+static uint8_t putVarint                    (uint8_t *buff, int32_t value);
+static uint8_t getVarint                    (const uint8_t *buff, uint16_t len, int32_t *value);
+
+static GpsTrack_t g_track;
+
+void GpsTrackInit                           (void)
+{
+    memset(&g_track, 0x00, sizeof(g_track));
+}
+
+void GpsTrackAdd                            (const GpsTrackFix_t *fix)
+{
+    uint8_t record[GPS_TRACK_MAX_RECORD_LEN];
+    GpsTrackFix_t oldFix;
+    int32_t oldStepMs = 0;
+    int32_t stepMs = g_track.headStepMs;
+    uint16_t len = 0;
+    uint16_t oldLen = 0;
+    uint16_t i = 0;
+
+    if(fix == NULL)
+    {
+        return;
+    }
+
+    len = encodeRecord(record, fix, &g_track.headFix, &stepMs);
+
+    // make room, dropped records are folded into the tail base so the next one still decodes
+    while((GPS_TRACK_BUFF_SIZE - g_track.used) < len)
+    {
+        oldLen = peekRecord(&oldFix, &oldStepMs);
+        if(oldLen == 0)
+        {
+            // not expected, restart the history rather than loop
+            g_track.stats.countDropped += g_track.stats.countFixes;
+            g_track.head = g_track.tail = g_track.used = 0;
+            g_track.stats.countFixes = 0;
+            g_track.tailFix = g_track.headFix;
+            g_track.tailStepMs = g_track.headStepMs;
+            break;
+        }
+        dropRecord(oldLen, &oldFix, oldStepMs);
+        g_track.stats.countDropped++;
+    }
+
+    for(i = 0; i < len; i++)
+    {
+        g_track.mem[g_track.head] = record[i];
+        g_track.head = (g_track.head + 1) % GPS_TRACK_BUFF_SIZE;
+    }
+    g_track.used += len;
+    g_track.headFix = *fix;
+    g_track.headStepMs = stepMs;
+    g_track.stats.countStored++;
+    g_track.stats.countFixes++;
+}
+
+uint16_t GpsTrackRead                       (GpsTrackFix_t *fixes, uint16_t maxFixes)
+{
+    uint16_t count = 0;
+    uint16_t len = 0;
+    int32_t stepMs = 0;
+
+    if(fixes == NULL)
+    {
+        return 0;
+    }
+
+    while(count < maxFixes && (len = peekRecord(&fixes[count], &stepMs)) != 0)
+    {
+        dropRecord(len, &fixes[count], stepMs);
+        count++;
+    }
+    return count;
+}
+
+uint16_t GpsTrackReadEncoded                (uint8_t *buff, uint16_t maxLen, uint16_t *count)
+{
+    GpsTrackFix_t batchBase = {0};
+    int32_t batchStepMs = 0;
+    GpsTrackFix_t fix;
+    int32_t stepMs = 0;
+    int32_t newStepMs = 0;
+    uint8_t record[GPS_TRACK_MAX_RECORD_LEN];
+    uint16_t len = 0;
+    uint16_t recordLen = 0;
+    uint16_t written = 0;
+    uint16_t fixes = 0;
+
+    if(buff == NULL)
+    {
+        return 0;
+    }
+
+    // re-encode against the batch base, stop before the first record that does not fit
+    while((len = peekRecord(&fix, &stepMs)) != 0)
+    {
+        newStepMs = batchStepMs;
+        recordLen = encodeRecord(record, &fix, &batchBase, &newStepMs);
+        if((written + recordLen) > maxLen)
+        {
+            break;
+        }
+        memcpy(&buff[written], record, recordLen);
+        written += recordLen;
+        fixes++;
+        batchBase = fix;
+        batchStepMs = newStepMs;
+        dropRecord(len, &fix, stepMs);
+    }
+
+    if(count != NULL)
+    {
+        *count = fixes;
+    }
+    return written;
+}
+
+uint16_t GpsTrackDecode                     (const uint8_t *buff, uint16_t len, GpsTrackFix_t *fix, int32_t *prevStepMs)
+{
+    int32_t delta[5];
+    uint16_t used = 0;
+    uint8_t n = 0;
+    uint8_t i = 0;
+
+    if(buff == NULL || fix == NULL || prevStepMs == NULL)
+    {
+        return 0;
+    }
+
+    for(i = 0; i < 5; i++)
+    {
+        n = getVarint(&buff[used], len - used, &delta[i]);
+        if(n == 0)
+        {
+            return 0;
+        }
+        used += n;
+    }
+
+    // deltas are applied with wrap around, same as they were taken
+    *prevStepMs = (int32_t)((uint32_t)*prevStepMs + (uint32_t)delta[0]);
+    fix->uptimeMs += (uint32_t)*prevStepMs;
+    fix->latitude = (int32_t)((uint32_t)fix->latitude + (uint32_t)delta[1]);
+    fix->longitude = (int32_t)((uint32_t)fix->longitude + (uint32_t)delta[2]);
+    fix->altitude = (int32_t)((uint32_t)fix->altitude + (uint32_t)delta[3]);
+    fix->speed += (uint32_t)delta[4];
+    return used;
+}
+
+GpsTrackStats_t GpsTrackGetStats            (void)
+{
+    GpsTrackStats_t stats = g_track.stats;
+
+    stats.bytesUsed = g_track.used;
+    return stats;
+}
+
+static uint16_t encodeRecord                (uint8_t *buff, const GpsTrackFix_t *fix, const GpsTrackFix_t *base, int32_t *stepMs)
+{
+    int32_t newStepMs = (int32_t)(fix->uptimeMs - base->uptimeMs);
+    uint16_t len = 0;
+
+    // fixes come at a steady rate, the change of the step is usually 0
+    len += putVarint(&buff[len], (int32_t)((uint32_t)newStepMs - (uint32_t)*stepMs));
+    len += putVarint(&buff[len], (int32_t)((uint32_t)fix->latitude - (uint32_t)base->latitude));
+    len += putVarint(&buff[len], (int32_t)((uint32_t)fix->longitude - (uint32_t)base->longitude));
+    len += putVarint(&buff[len], (int32_t)((uint32_t)fix->altitude - (uint32_t)base->altitude));
+    len += putVarint(&buff[len], (int32_t)(fix->speed - base->speed));
+    *stepMs = newStepMs;
+    return len;
+}
+
+static uint16_t peekRecord                  (GpsTrackFix_t *fix, int32_t *stepMs)
+{
+    uint8_t record[GPS_TRACK_MAX_RECORD_LEN];
+    uint16_t len = (g_track.used < sizeof(record)) ? g_track.used : sizeof(record);
+    uint16_t idx = g_track.tail;
+    uint16_t i = 0;
+
+    if(g_track.used == 0)
+    {
+        return 0;
+    }
+
+    // record can wrap the end of the ring, decode from a linear copy
+    for(i = 0; i < len; i++)
+    {
+        record[i] = g_track.mem[idx];
+        idx = (idx + 1) % GPS_TRACK_BUFF_SIZE;
+    }
+
+    *fix = g_track.tailFix;
+    *stepMs = g_track.tailStepMs;
+    return GpsTrackDecode(record, len, fix, stepMs);
+}
+
+static void dropRecord                      (uint16_t len, const GpsTrackFix_t *fix, int32_t stepMs)
+{
+    g_track.tail = (g_track.tail + len) % GPS_TRACK_BUFF_SIZE;
+    g_track.used -= len;
+    g_track.tailFix = *fix;
+    g_track.tailStepMs = stepMs;
+    g_track.stats.countFixes--;
+}
+
+static uint8_t putVarint                    (uint8_t *buff, int32_t value)
+{
+    // zigzag keeps small negative deltas short
+    uint32_t zigzag = ((uint32_t)value << 1) ^ (uint32_t)(0 - ((uint32_t)value >> 31));
+    uint8_t len = 0;
+
+    while(zigzag >= 0x80)
+    {
+        buff[len++] = (uint8_t)(zigzag | 0x80);
+        zigzag >>= 7;
+    }
+    buff[len++] = (uint8_t)zigzag;
+    return len;
+}
+
+static uint8_t getVarint                    (const uint8_t *buff, uint16_t len, int32_t *value)
+{
+    uint32_t zigzag = 0;
+    uint8_t i = 0;
+
+    for(i = 0; i < len && i < 5; i++)
+    {
+        zigzag |= (uint32_t)(buff[i] & 0x7F) << (7 * i);
+        if((buff[i] & 0x80) == 0)
+        {
+            *value = (int32_t)((zigzag >> 1) ^ (0 - (zigzag & 1)));
+            return i + 1;
+        }
+    }
+    return 0;
+}
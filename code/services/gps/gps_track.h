@@ -0,0 +1,93 @@
+/**
+ * @file        gps_track.h
+ *
+ * @copyright   Accolade Electronics Pvt Ltd, 2023-24
+ *              All Rights Reserved
+ *              UNPUBLISHED, LICENSED SOFTWARE.
+ *              Accolade Electronics, Pune
+ *              CONFIDENTIAL AND PROPRIETARY INFORMATION
+ *              WHICH IS THE PROPERTY OF M/s Accolade Electronics.
+ *
+ * @date        19 October 2026
+ * @author      agent <agent@local>
+ *
+ * @brief       RAM history of timestamped GPS fixes - header
+ *
+ * @details     Fixes are stored delta encoded in a byte ring, oldest fixes are dropped when it is full.
+ *              A record is 5 zigzag varints (LEB128, 7 bits per byte, MSB set on all but the last byte):
+ *              change of the time step in ms, then latitude, longitude, altitude and speed deltas to the
+ *              previous record. At 10 Hz a record is about 8 bytes, a minute of history is under 5 KB.
+ *              An encoded batch starts from a zero base, so its first record holds absolute values.
+ * @note        Writer and readers are expected in the same thread (service thread), no locking is done.
+ */
+
+#ifndef GPS_TRACK_H
+#define GPS_TRACK_H
+
+#include <stdint.h>
+
+#define GPS_TRACK_BUFF_SIZE                 (6 * 1024)
+#define GPS_TRACK_MAX_RECORD_LEN            (5 * 5)     /* 5 varints of at most 5 bytes each. */
+
+typedef struct
+{
+    uint32_t    uptimeMs;                   /* Uptime when the fix was stored. */
+    int32_t     latitude;                   /* Degrees * 1e7. */
+    int32_t     longitude;                  /* Degrees * 1e7. */
+    int32_t     altitude;                   /* mm above mean sea level. */
+    uint32_t    speed;                      /* cm/s over ground. */
+}GpsTrackFix_t;
+
+typedef struct
+{
+    uint32_t    countStored;                /* Fixes added. */
+    uint32_t    countDropped;               /* Fixes dropped unread to make room. */
+    uint16_t    countFixes;                 /* Fixes currently held. */
+    uint16_t    bytesUsed;                  /* Bytes currently used in the ring. */
+}GpsTrackStats_t;
+
+/**
+ * @brief                                   Empties the history.
+ */
+void GpsTrackInit                           (void);
+
+/**
+ * @brief                                   Appends a fix, dropping the oldest ones if needed.
+ * @param   fix                             Fix to store.
+ */
+void GpsTrackAdd                            (const GpsTrackFix_t *fix);
+
+/**
+ * @brief                                   Reads and removes the oldest fixes.
+ * @param   fixes                           Output array.
+ * @param   maxFixes                        Size of the output array.
+ * @return                                  Number of fixes read.
+ */
+uint16_t GpsTrackRead                       (GpsTrackFix_t *fixes, uint16_t maxFixes);
+
+/**
+ * @brief                                   Reads and removes the oldest fixes as a self contained encoded batch.
+ * @param   buff                            Output buffer, encoded as described above.
+ * @param   maxLen                          Size of the output buffer, only whole records are written.
+ * @param   count                           Number of fixes written, can be NULL.
+ * @return                                  Number of bytes written.
+ */
+uint16_t GpsTrackReadEncoded                (uint8_t *buff, uint16_t maxLen, uint16_t *count);
+
+/**
+ * @brief                                   Decodes one record of an encoded batch.
+ * @param   buff                            Encoded record.
+ * @param   len                             Bytes left in the batch.
+ * @param   fix                             In: previous fix of the batch, zeroed for the first record. Out: decoded fix.
+ * @param   prevStepMs                      In: previous time step, 0 for the first record. Out: time step of this record.
+ * @return                                  Bytes used by the record, 0 if the record is truncated.
+ */
+uint16_t GpsTrackDecode                     (const uint8_t *buff, uint16_t len, GpsTrackFix_t *fix, int32_t *prevStepMs);
+
+/**
+ * @brief                                   Gives the history statistics.
+ * @return                                  Copy of the statistics.
+ */
+GpsTrackStats_t GpsTrackGetStats            (void);
+
+#endif /* GPS_TRACK_H */
@@ -24,32 +24,51 @@
 #include "modem_port.h"
 
 #define MAX_URC_MODULES 24
+#define MAX_RAW_URC_MODULES 2
 #define MAX_RECOVERY_TIME 60 * 60 * 1000 //  don't reboot the system within MAX_RECOVERY_TIME
 #define MAX_APPEDED_COUNT 20             //  don't reboot the system until reached to max count
 #define MAX_REBOOT_TIME_PUB 60 * 1000    //  modem reboot after MAX_RECOVERY_TIME_PWR, if modem power off during publish
 #define MAX_TOKEN_LIMIT 50
+#define AT_CLIENT_AGING_MS (10 * 1000)   //  client waiting longer than this is served before any priority
 
 // forward declared
 typedef uint32_t (*fnPtrSerialRead)(uint8_t *rxBuff, uint32_t maxBuffSize);
-typedef uint32_t (*fnPtrSerialWrite)(uint8_t *txBuff, uint32_t txLen);
+typedef int32_t (*fnPtrSerialWrite)(uint8_t *txBuff, uint32_t txLen);
 
 typedef struct
 {
-    uint8_t state;                      /* state is used to store the current state of the at module. */
-    uint8_t respRetryCount;             /* respRetryCount is used to store the retry count of the response. */
-    uint8_t notificationRetryCount;     /* notificationRetryCount is used to store the retry count of the notification. */
-    uint32_t timer;                     /* timer is used to wait a perticuler time for either response or notification. */
+    const char *name;                   /* name is used to identify the client in the statistics print. */
+    bool busy;                          /* busy is true from AtStartClient until the table is over or stopped. */
+    uint8_t priority;                   /* priority is used to pick the next command between clients, AtPriority_n. */
     int8_t currentCmdIndex;             /* currentCmdIndex is used to store the command index which is running. */
     uint8_t maxCmd;                     /* maxCmd is used to store the max command count, which is fire on gsm uart. */
-    uint32_t waitTimerForNxtCmd;        /* waitTimerForNxtCmd is used to store timer to fire next command*/
     const AtCommands_t *cmdTable;       /* cmdTable is used to at command table, which we have to fire. */
     fnPtrFillCmd fillCmdCallBack;       /* fill_cmd_ptr is used to store the adress of the function, which is used to fill the at command. */
     fnPtrEventCallBack eventCallBack;   /* call_back_ptr is used to store the adress of the function, which is used to give callback the parent. */
     funPtrStoreResp storeDataCallBack;  /* call_back_ptr is used to store the adress of the function, which is used to store the data */
+    uint32_t readyTick;                 /* readyTick is the time since the client is waiting for the modem link. */
+    AtClientStats_t stats;              /* stats is used to store queueing delay of the client. */
+} AtClientContext_t;
+
+typedef struct
+{
+    uint8_t state;                      /* state is used to store the current state of the at module. */
+    uint8_t respRetryCount;             /* respRetryCount is used to store the retry count of the response. */
+    uint8_t notificationRetryCount;     /* notificationRetryCount is used to store the retry count of the notification. */
+    ModemTimer_t timer;                 /* timer is used to wait a perticuler time for either response or notification. */
+    ModemTimer_t waitTimerForNxtCmd;    /* waitTimerForNxtCmd is used to store timer to fire next command*/
+    uint32_t txPendingLen;              /* txPendingLen is the length of a filled command the busy modem link did not take yet. */
+    AtClientContext_t *client;          /* client owns the command on the modem link, or the last one that did. */
     fnPtrSerialRead uartRead;           /*  */
     fnPtrSerialWrite uartWrite;
 } AtContext_t;
 
+typedef struct
+{
+    const char *string;
+    fnPtrRawCallBack rawHandler;
+} RawUrcTable_t;
+
 uint16_t g_appendLength = 0;
 
 /**
@@ -59,6 +78,13 @@ uint16_t g_appendLength = 0;
  */
 uint16_t modemURCHandler(uint8_t *buffer, uint16_t len);
 
+/**
+ * @brief   extractRawData, Hands the raw data of registered responses to their handler and removes it from the buffer.
+ * @param   buffer, len (updated with the remaining length)
+ * @return  false if a raw response is not received completely yet.
+ */
+static bool extractRawData(uint8_t *buffer, uint16_t *len);
+
 /**
  * @brief   handleErrForOtherResp, used to handle error responses.
  * @param   None.
@@ -87,13 +113,31 @@ static int8_t readModemData(void); // Returned minus value for errors
  */
 static uint16_t trimString(uint8_t *string, uint16_t stringLen);
 
+/*
+ * @brief   selectNextClient, Arbitrates between busy clients at a command boundary.
+ * @param   -
+ * @return  Client whose next command is fired, NULL if no client is busy.
+ */
+static AtClientContext_t *selectNextClient(void);
+
+/*
+ * @brief   stopActiveClient, Drops the table of the client owning the link and gives it the callback.
+ * @param   status, buffer length and buffer passed to the callback.
+ * @return  Return value of the callback.
+ */
+static int16_t stopActiveClient(AtCallBack_n status, uint32_t bufferLen, void *buffer);
+
 UrcTable_t g_extraTable[MAX_URC_MODULES];
+static RawUrcTable_t g_rawTable[MAX_RAW_URC_MODULES];
+static int16_t g_rawTbleCnt = 0;
 static uint8_t g_cmdTxBuff[MAX_AT_BUFF_SIZE];
 static uint8_t g_cmdRxBuff[MAX_AT_BUFF_SIZE];
 static uint8_t g_outBuffer[MAX_RCVD_BUF_LEN];
 
 AtContext_t g_atContext;
 static int16_t g_extraTbleCnt = 0;
+static AtClientContext_t g_atClients[MAX_AT_CLIENTS];
+static int8_t g_atClientCount = 0;
 
 AtError_n AtRegisterUrc(UrcTable_t *extraTableEntries, int count)
 {
@@ -116,17 +160,51 @@ AtError_n AtRegisterUrc(UrcTable_t *extraTableEntries, int count)
     return AT_SUCCESS;
 }
 
+AtError_n AtRegisterRawUrc(const char *string, fnPtrRawCallBack rawHandler)
+{
+    if ((NULL == string) || (NULL == rawHandler))
+    {
+        return AT_INVALID_MEMORY;
+    }
+
+    if (g_rawTbleCnt >= MAX_RAW_URC_MODULES)
+    {
+        NETWORK_PRINT_ERROR("Failed to register raw URC %s\r\n", string);
+        return AT_INVALID_MEMORY;
+    }
+
+    g_rawTable[g_rawTbleCnt].string = string;
+    g_rawTable[g_rawTbleCnt].rawHandler = rawHandler;
+    g_rawTbleCnt++;
+    return AT_SUCCESS;
+}
+
 int16_t AtInit(void)
 {
+    ModemTimer_t timer;
+    ModemTimer_t waitTimer;
+
     memset(g_extraTable, 0x00, sizeof(g_extraTable));
+    memset(g_rawTable, 0x00, sizeof(g_rawTable));
     memset(g_cmdTxBuff, 0x00, MAX_AT_BUFF_SIZE);
     memset(g_cmdRxBuff, 0x00, MAX_AT_BUFF_SIZE);
     memset(g_outBuffer, 0x00, MAX_RCVD_BUF_LEN);
+    timer = g_atContext.timer;          /* Timers survive a re-init, the OSAL timer pool is not freed. */
+    waitTimer = g_atContext.waitTimerForNxtCmd;
     memset(&g_atContext, 0, sizeof(g_atContext));
+    g_atContext.timer = timer;
+    g_atContext.waitTimerForNxtCmd = waitTimer;
+    ModemTimerCreate(&g_atContext.timer);
+    ModemTimerCreate(&g_atContext.waitTimerForNxtCmd);
+    ModemTimerStart(g_atContext.waitTimerForNxtCmd, 0);
+    memset(g_atClients, 0x00, sizeof(g_atClients));
     ModemInit();
     g_extraTbleCnt = 0;
+    g_rawTbleCnt = 0;
+    g_atClientCount = 0;
     g_atContext.uartRead = ModemRead;
     g_atContext.uartWrite = ModemWrite;
+    AtRegisterClient("default");
     AtForceStop();
 
     return 0xAA; // Putting fixed val as GsmHandle. This is legacy code requirement. Previously this was obtained from uart_init in legacy code
@@ -134,37 +212,118 @@ int16_t AtInit(void)
 
 void AtForceStop(void)
 {
+    for (int iterator = 0; iterator < g_atClientCount; iterator++)
+    {
+        g_atClients[iterator].busy = false;
+    }
+    g_atContext.txPendingLen = 0;
     g_atContext.state = AT_STATE_IDLE;
 }
 
+AtError_n AtStopClient(AtClientId_t client)
+{
+    if (0 > client || client >= g_atClientCount)
+    {
+        return AT_INVALID_MEMORY;
+    }
+    g_atClients[client].busy = false;
+
+    /* The link is released at once, a late answer to the dropped command is seen by the next client. */
+    if ((&g_atClients[client] == g_atContext.client) && (AT_STATE_IDLE != g_atContext.state))
+    {
+        g_atContext.txPendingLen = 0;
+        g_atContext.state = AT_STATE_SELECT_COMMAND;
+    }
+    return AT_SUCCESS;
+}
+
+AtClientId_t AtRegisterClient(const char *name)
+{
+    if (g_atClientCount >= MAX_AT_CLIENTS)
+    {
+        NETWORK_PRINT_ERROR("Failed to register AT client %s\r\n", name);
+        return AT_FAILED;
+    }
+
+    memset(&g_atClients[g_atClientCount], 0x00, sizeof(g_atClients[g_atClientCount]));
+    g_atClients[g_atClientCount].name = name;
+    return g_atClientCount++;
+}
+
 AtError_n AtStart(const AtCommands_t *atTable, uint8_t maxCmd, fnPtrFillCmd fillCmdFuncPtr, funPtrStoreResp storeDataFuncPtr, fnPtrEventCallBack callBackFuncPtr)
 {
+    return AtStartClient(AT_CLIENT_DEFAULT, AT_PRIORITY_NORMAL, atTable, maxCmd, fillCmdFuncPtr, storeDataFuncPtr, callBackFuncPtr);
+}
+
+AtError_n AtStartClient(AtClientId_t client, AtPriority_n priority, const AtCommands_t *atTable, uint8_t maxCmd,
+                        fnPtrFillCmd fillCmdFuncPtr, funPtrStoreResp storeDataFuncPtr, fnPtrEventCallBack callBackFuncPtr)
+{
+    AtClientContext_t *clientCtx = NULL;
+
     /* If received parameter are invalid then return error. */
-    if (NULL == atTable || NULL == fillCmdFuncPtr || NULL == callBackFuncPtr || NULL == storeDataFuncPtr || 0 == maxCmd)
+    if (NULL == atTable || NULL == fillCmdFuncPtr || NULL == callBackFuncPtr || NULL == storeDataFuncPtr || 0 == maxCmd ||
+        0 > client || client >= g_atClientCount || priority >= AT_PRIORITY_MAX)
     {
         return AT_INVALID_MEMORY;
     }
-    if (AtGetState() != AT_STATE_IDLE)
+    clientCtx = &g_atClients[client];
+    if (clientCtx->busy)
     {
         return AT_FAILED;
     }
 
     /* Assign all necessary parameters to the corresponding valued before doing a work. */
-    g_atContext.respRetryCount = 0;
-    g_atContext.notificationRetryCount = 0;
-    g_atContext.timer = 0L;
-    g_atContext.currentCmdIndex = -1;
-    g_atContext.fillCmdCallBack = fillCmdFuncPtr;
-    g_atContext.cmdTable = atTable; // TODO:Need to remove warning.
-    g_atContext.eventCallBack = callBackFuncPtr;
-    g_atContext.maxCmd = maxCmd;
-    g_atContext.storeDataCallBack = storeDataFuncPtr;
-    g_atContext.state = AT_STATE_SELECT_COMMAND;
+    clientCtx->currentCmdIndex = -1;
+    clientCtx->fillCmdCallBack = fillCmdFuncPtr;
+    clientCtx->cmdTable = atTable;
+    clientCtx->eventCallBack = callBackFuncPtr;
+    clientCtx->maxCmd = maxCmd;
+    clientCtx->storeDataCallBack = storeDataFuncPtr;
+    clientCtx->priority = (uint8_t)priority;
+    clientCtx->readyTick = g_var_sys;
+    clientCtx->stats.countTables++;
+    clientCtx->busy = true;
+
+    /* If another client owns the link, this table is picked up at its next command boundary. */
+    if (AT_STATE_IDLE == g_atContext.state)
+    {
+        g_atContext.state = AT_STATE_SELECT_COMMAND;
+    }
 
-    NETWORK_PRINT_DEBUG("start AT\r\n");
+    NETWORK_PRINT_DEBUG("start AT %s\r\n", clientCtx->name);
     return AT_SUCCESS;
 }
 
+bool AtIsClientBusy(AtClientId_t client)
+{
+    if (0 > client || client >= g_atClientCount)
+    {
+        return false;
+    }
+    return g_atClients[client].busy;
+}
+
+AtError_n AtGetClientStats(AtClientId_t client, AtClientStats_t *stats)
+{
+    if (NULL == stats || 0 > client || client >= g_atClientCount)
+    {
+        return AT_INVALID_MEMORY;
+    }
+    *stats = g_atClients[client].stats;
+    return AT_SUCCESS;
+}
+
+void AtPrintClientStats(void)
+{
+    for (int iterator = 0; iterator < g_atClientCount; iterator++)
+    {
+        AtClientStats_t *stats = &g_atClients[iterator].stats;
+        NETWORK_PRINT_INFO("[AT] %s tables: %lu cmds: %lu wait ms last: %lu max: %lu avg: %lu\r\n",
+                           g_atClients[iterator].name, stats->countTables, stats->countCmds, stats->queueDelayLastMs,
+                           stats->queueDelayMaxMs, (stats->countCmds ? (stats->queueDelayTotalMs / stats->countCmds) : 0));
+    }
+}
+
 int8_t AtExe(void)
 {
     uint32_t offset;                         /* offset is used to indicate the valid fill length in the cmd_buffer.  */
@@ -182,67 +341,103 @@ int8_t AtExe(void)
 
     case AT_STATE_SELECT_COMMAND:
     {
-        /* Set wait for response timer and increment retry count. */
-        /* Select command. */
-        g_atContext.currentCmdIndex++;
+        AtClientContext_t *client = g_atContext.client;
+        uint32_t queueDelay = 0;
 
-        /* If command is over then tell to the caller function that all command over. */
-        if (g_atContext.currentCmdIndex >= g_atContext.maxCmd)
+        /* Command boundary, the command of the client owning the link is over. */
+        if ((NULL != client) && client->busy)
+        {
+            /* If command is over then tell to the caller function that all command over. */
+            if ((client->currentCmdIndex + 1) >= client->maxCmd)
+            {
+                NETWORK_PRINT_DEBUG("CMD OVR,GV CB\n\r");
+                client->busy = false;
+                client->eventCallBack(client->maxCmd, AT_CB_ALL_CMD_OVR, 0, NULL);
+            }
+            else
+            {
+                client->readyTick = g_var_sys;
+            }
+        }
+
+        /* Select client and its command. */
+        client = selectNextClient();
+        if (NULL == client)
         {
-            NETWORK_PRINT_DEBUG("CMD OVR,GV CB\n\r");
             g_atContext.state = AT_STATE_IDLE;
-            g_atContext.eventCallBack(g_atContext.currentCmdIndex, AT_CB_ALL_CMD_OVR, 0, NULL);
             break;
         }
-
-        /* Point to the command which is fire. */
-        atCmdTable = &(g_atContext.cmdTable[g_atContext.currentCmdIndex]);
+        if (client != g_atContext.client)
+        {
+            NETWORK_PRINT_TRACE("AT link to %s\r\n", client->name);
+        }
+        g_atContext.client = client;
+        client->currentCmdIndex++;
+
+        queueDelay = g_var_sys - client->readyTick;
+        client->stats.countCmds++;
+        client->stats.queueDelayLastMs = queueDelay;
+        client->stats.queueDelayTotalMs += queueDelay;
+        if (queueDelay > client->stats.queueDelayMaxMs)
+        {
+            client->stats.queueDelayMaxMs = queueDelay;
+        }
 
         /* Clear required variables.  */
         g_atContext.respRetryCount = 0;
         g_atContext.notificationRetryCount = 0;
+        g_atContext.txPendingLen = 0;
         g_atContext.state = AT_STATE_FILL_N_SND_CMD;
     }
     break;
 
     case AT_STATE_FILL_N_SND_CMD:
     {
-        /* Point to the command which is fire. */
-        atCmdTable = &(g_atContext.cmdTable[g_atContext.currentCmdIndex]);
-
-        if (NULL == atCmdTable)
+        if (NULL == g_atContext.client)
         {
             break;
         }
 
-        /* Wait timer for next timer. */
-        if (!IS_TIMER_ELAPSED(g_atContext.waitTimerForNxtCmd))
-        {
-            break;
-        }
-        RESET_TIMER(g_atContext.waitTimerForNxtCmd, atCmdTable->waitTimerForNextCmd);
+        /* Point to the command which is fire. */
+        atCmdTable = &(g_atContext.client->cmdTable[g_atContext.client->currentCmdIndex]);
 
-        offset = 0;
-        memset(g_cmdTxBuff, 0x00, MAX_AT_BUFF_SIZE);
-        if (NULL != g_atContext.fillCmdCallBack)
+        /* A command the modem link was too busy to take is already filled, only its write is repeated. */
+        if (0 == g_atContext.txPendingLen)
         {
-            /* Fill remaing comand which is change at runtime hence we have to fill at run time. */
-            offset += g_atContext.fillCmdCallBack(g_cmdTxBuff, offset, &(g_atContext.cmdTable[g_atContext.currentCmdIndex]), g_atContext.currentCmdIndex);
-        }
+            /* Wait timer for next timer. */
+            if (!ModemTimerExpired(g_atContext.waitTimerForNxtCmd))
+            {
+                break;
+            }
+            ModemTimerStart(g_atContext.waitTimerForNxtCmd, atCmdTable->waitTimerForNextCmd);
 
-        // To print packet less than 100 bytes
-        if (offset < 100)
-        {
-            NETWORK_PRINT_DEBUG("GSM_TX(%ld): |%s|\r\n", offset, g_cmdTxBuff);
-        }
-        else
-        {
-            NETWORK_PRINT_DEBUG("GSM_TX(%ld):Length is greater than 100 Byte, data will not be printed\r\n", offset);
+            offset = 0;
+            memset(g_cmdTxBuff, 0x00, MAX_AT_BUFF_SIZE);
+            if (NULL != g_atContext.client->fillCmdCallBack)
+            {
+                /* Fill remaing comand which is change at runtime hence we have to fill at run time. */
+                offset += g_atContext.client->fillCmdCallBack(g_cmdTxBuff, offset, atCmdTable, g_atContext.client->currentCmdIndex);
+            }
+
+            // To print packet less than 100 bytes
+            if (offset < 100)
+            {
+                NETWORK_PRINT_DEBUG("GSM_TX(%ld): |%s|\r\n", offset, g_cmdTxBuff);
+            }
+            else
+            {
+                NETWORK_PRINT_DEBUG("GSM_TX(%ld):Length is greater than 100 Byte, data will not be printed\r\n", offset);
+            }
+            g_atContext.txPendingLen = offset;
         }
 
         /***** Write data on uart.**********/
-        ModemWrite(g_cmdTxBuff, offset);
-        RESET_TIMER(g_atContext.timer, atCmdTable->timeOutMs);
+        if (MODEM_BUSY == g_atContext.uartWrite(g_cmdTxBuff, g_atContext.txPendingLen))
+        {
+            break;
+        }
+        g_atContext.txPendingLen = 0;
+        ModemTimerStart(g_atContext.timer, atCmdTable->timeOutMs);
         g_atContext.respRetryCount++;
 
         if (atCmdTable->successResponse != NULL)
@@ -259,13 +454,13 @@ int8_t AtExe(void)
     case AT_STATE_WAIT_FOR_RSP:
     {
 
-        if (!IS_TIMER_ELAPSED(g_atContext.timer))
+        if (!ModemTimerExpired(g_atContext.timer))
         {
             break;
         }
 
         /* Point to the command which is fire. */
-        atCmdTable = &(g_atContext.cmdTable[g_atContext.currentCmdIndex]);
+        atCmdTable = &(g_atContext.client->cmdTable[g_atContext.client->currentCmdIndex]);
 
         /* Device is wating for gsm response. Check response retry is over or not after a perticuler time. */
         if (atCmdTable->maxRetry <= g_atContext.respRetryCount)
@@ -283,13 +478,13 @@ int8_t AtExe(void)
 
     case AT_STATE_WAIT_FOR_NTFN:
     {
-        if (!IS_TIMER_ELAPSED(g_atContext.timer))
+        if (!ModemTimerExpired(g_atContext.timer))
         {
             break;
         }
 
         /* Point to the command which is fire. */
-        atCmdTable = &(g_atContext.cmdTable[g_atContext.currentCmdIndex]);
+        atCmdTable = &(g_atContext.client->cmdTable[g_atContext.client->currentCmdIndex]);
 
         /* Until notification is not received, so increment notification retry count. */
         g_atContext.notificationRetryCount++;
@@ -316,12 +511,11 @@ static void checkStopFlag(const AtCommands_t *commandTable)
     /* If errorStopFlg is set the give call back to the caller so caller can handle this and at go in IDLE state. */
     if (1 == commandTable->errorStopFlg)
     {
-        g_atContext.state = AT_STATE_IDLE;
-        g_atContext.eventCallBack(g_atContext.currentCmdIndex, AT_CB_ERROR_STOP, 0, NULL);
+        stopActiveClient(AT_CB_ERROR_STOP, 0, NULL);
     }
     else
     {
-        g_atContext.eventCallBack(g_atContext.currentCmdIndex, AT_CB_ERROR_NO_STOP, 0, NULL);
+        g_atContext.client->eventCallBack(g_atContext.client->currentCmdIndex, AT_CB_ERROR_NO_STOP, 0, NULL);
         /* If errorStopFlg is not set then give callback to the caller and fire next command because there is no need to stop. */
         g_atContext.state = AT_STATE_SELECT_COMMAND;
     }
@@ -332,7 +526,8 @@ static int8_t readModemData(void) // Minus value retruned
     uint8_t *rcvdBuffer = g_cmdRxBuff;
     uint16_t rcvdLength = 0; /* rcvdLength is used to stored the received number of bytes on gsm uart. */
 
-    const AtCommands_t *atCmdTable = &(g_atContext.cmdTable[g_atContext.currentCmdIndex]);
+    AtClientContext_t *client = g_atContext.client;
+    const AtCommands_t *atCmdTable = NULL;
     uint8_t *tokens[MAX_TOKEN_LIMIT];
     AtCallBack_n status = AT_CB_ERROR_STOP;
     int i = 0;
@@ -368,6 +563,18 @@ static int8_t readModemData(void) // Minus value retruned
                            ((rcvdLength > 100) ? "Length is greater than 100 Byte, data will not be printed\r\n" : (char *)rcvdBuffer));
     }
 
+    /* Raw data can end in anything, wait for all of it before looking at line endings. */
+    if (false == extractRawData(rcvdBuffer, &rcvdLength))
+    {
+        g_appendLength = rcvdLength;
+        return 0;
+    }
+    if (0 == rcvdLength)
+    {
+        g_appendLength = 0;
+        return 0;
+    }
+
     if (rcvdBuffer[rcvdLength - 2] == '\r' && rcvdBuffer[rcvdLength - 1] == '\n')
     {
         /* Rare condition, if \r\n of next URC is found at the end of GSM_RX data, so \r\n stored and
@@ -434,6 +641,16 @@ static int8_t readModemData(void) // Minus value retruned
         return AT_FAILED;
     }
 
+    /* Responses belong to the client owning the link, with no client there is nobody to give them. */
+    if (NULL == client)
+    {
+        return 0;
+    }
+    if (0 <= client->currentCmdIndex)
+    {
+        atCmdTable = &(client->cmdTable[client->currentCmdIndex]);
+    }
+
     do
     {
         tokenLength = strlen((char *)tokens[i]);
@@ -445,14 +662,14 @@ static int8_t readModemData(void) // Minus value retruned
          * error, success, other response hence only check extra response is received and take action accordingly.
          */
 
-        if (AT_STATE_WAIT_FOR_RSP == g_atContext.state || AT_STATE_WAIT_FOR_NTFN == g_atContext.state)
+        if ((NULL != atCmdTable) && (AT_STATE_WAIT_FOR_RSP == g_atContext.state || AT_STATE_WAIT_FOR_NTFN == g_atContext.state))
         {
             /* Check received response is success response. */
             if (0 == strncmp((char *)tokens[i], atCmdTable->successResponse, strlen((char *)atCmdTable->successResponse)))
             {
-                if (NULL != g_atContext.storeDataCallBack)
+                if (NULL != client->storeDataCallBack)
                 {
-                    g_atContext.storeDataCallBack(g_atContext.cmdTable, g_atContext.currentCmdIndex, tokenLength, (uint8_t *)tokens[i], AT_CB_SUCCESS_SINGLE_CMD);
+                    client->storeDataCallBack(client->cmdTable, client->currentCmdIndex, tokenLength, (uint8_t *)tokens[i], AT_CB_SUCCESS_SINGLE_CMD);
                 }
 
                 if (multiStepResponseError == 0)
@@ -465,7 +682,7 @@ static int8_t readModemData(void) // Minus value retruned
                         if (1 == atCmdTable->notificationFlag)
                         {
                             g_atContext.state = AT_STATE_WAIT_FOR_NTFN;
-                            RESET_TIMER(g_atContext.timer, atCmdTable->timeOutMs);
+                            ModemTimerStart(g_atContext.timer, atCmdTable->timeOutMs);
                         }
                         else
                         {
@@ -496,16 +713,16 @@ static int8_t readModemData(void) // Minus value retruned
             else if ((atCmdTable->notificationFlag) && (strstr((char *)tokens[i], atCmdTable->otherResponse)))
             {
                 g_atContext.state = AT_STATE_SELECT_COMMAND;
-                if (NULL != g_atContext.storeDataCallBack)
+                if (NULL != client->storeDataCallBack)
                 {
-                    g_atContext.storeDataCallBack(g_atContext.cmdTable, g_atContext.currentCmdIndex, tokenLength, tokens[i], AT_CB_OTHER_RSP);
+                    client->storeDataCallBack(client->cmdTable, client->currentCmdIndex, tokenLength, tokens[i], AT_CB_OTHER_RSP);
                 }
             }
             else if (0 == (strncmp(atCmdTable->otherResponse, "*", 1)))
             {
-                if (NULL != g_atContext.storeDataCallBack)
+                if (NULL != client->storeDataCallBack)
                 {
-                    retVal = g_atContext.storeDataCallBack(g_atContext.cmdTable, g_atContext.currentCmdIndex, tokenLength, (uint8_t *)tokens[i], AT_CB_ACCEPT_ALL);
+                    retVal = client->storeDataCallBack(client->cmdTable, client->currentCmdIndex, tokenLength, (uint8_t *)tokens[i], AT_CB_ACCEPT_ALL);
                 }
 
                 if (0 == retVal)
@@ -514,9 +731,8 @@ static int8_t readModemData(void) // Minus value retruned
                 }
                 else if (0 > retVal)
                 {
-                    /* If fail response is received then go IDLE. */
-                    retVal = g_atContext.eventCallBack(g_atContext.currentCmdIndex, AT_CB_OTHER_RSP, tokenLength, tokens[i]);
-                    g_atContext.state = AT_STATE_IDLE;
+                    /* If fail response is received then stop this client's table. */
+                    retVal = stopActiveClient(AT_CB_OTHER_RSP, tokenLength, tokens[i]);
                 }
                 else
                 {
@@ -534,9 +750,9 @@ static int8_t readModemData(void) // Minus value retruned
         if (AT_CB_NOT_IN_LIST == status)
         {
             /* Now it is comfirm not in list response. */
-            if (NULL != g_atContext.storeDataCallBack)
+            if (NULL != client->storeDataCallBack)
             {
-                g_atContext.storeDataCallBack(g_atContext.cmdTable, g_atContext.currentCmdIndex, tokenLength, (uint8_t *)tokens[i], AT_CB_NOT_IN_LIST);
+                client->storeDataCallBack(client->cmdTable, client->currentCmdIndex, tokenLength, (uint8_t *)tokens[i], AT_CB_NOT_IN_LIST);
             }
         }
         i++;
@@ -632,16 +848,131 @@ uint16_t modemURCHandler(uint8_t *buffer, uint16_t len)
     return len;
 }
 
+static bool extractRawData(uint8_t *buffer, uint16_t *len)
+{
+    uint16_t iterator = 0;
+    uint16_t stringLen = 0;
+    uint16_t position = 0;
+    uint16_t dataPos = 0;
+    uint16_t dataLen = 0;
+    uint16_t consumed = 0;
+    bool found = false;
+
+    for (iterator = 0; iterator < g_rawTbleCnt; iterator++)
+    {
+        stringLen = (uint16_t)strlen(g_rawTable[iterator].string);
+        position = 0;
+        while ((position + stringLen) <= *len)
+        {
+            /* Search by length, earlier raw data may have left zero bytes in the buffer. */
+            found = (0 == memcmp(&buffer[position], g_rawTable[iterator].string, stringLen)) &&
+                    ((position < 2) || (('\r' == buffer[position - 2]) && ('\n' == buffer[position - 1])));
+            if (false == found)
+            {
+                position++;
+                continue;
+            }
+
+            dataPos = position + stringLen;
+            dataLen = 0;
+            while ((dataPos < *len) && (buffer[dataPos] >= '0') && (buffer[dataPos] <= '9'))
+            {
+                dataLen = (uint16_t)((dataLen * 10) + (buffer[dataPos] - '0'));
+                dataPos++;
+            }
+            if ((dataPos + 2) > *len)
+            {
+                return false;
+            }
+            dataPos += 2;
+            if (((uint32_t)dataPos + dataLen) > *len)
+            {
+                if (((uint32_t)dataPos + dataLen) < MAX_AT_BUFF_SIZE)
+                {
+                    return false;
+                }
+                NETWORK_PRINT_ERROR("Raw data %u does not fit the buffer, dropped\r\n", dataLen);
+                dataLen = 0;
+            }
+            else
+            {
+                g_rawTable[iterator].rawHandler(&buffer[dataPos], dataLen);
+            }
+
+            consumed = (uint16_t)((dataPos + dataLen) - position);
+            memmove(&buffer[position], &buffer[position + consumed], *len - (position + consumed));
+            *len -= consumed;
+            memset(&buffer[*len], 0x00, consumed);
+        }
+    }
+    return true;
+}
+
 uint8_t AtGetState(void)
 {
     return g_atContext.state;
 }
 
+static AtClientContext_t *selectNextClient(void)
+{
+    AtClientContext_t *active = g_atContext.client;
+    AtClientContext_t *candidate = NULL;
+    AtClientContext_t *best = NULL;
+    uint8_t bestPriority = 0;
+    uint8_t priority = 0;
+    int8_t start = 0;
+
+    /* A command answered with a data prompt must be followed by its data, keep the link. */
+    if ((NULL != active) && active->busy && (0 <= active->currentCmdIndex))
+    {
+        const char *response = active->cmdTable[active->currentCmdIndex].successResponse;
+        if ((NULL != response) && ((0 == strcmp(response, ">")) || (0 == strcmp(response, "CONNECT"))))
+        {
+            return active;
+        }
+    }
+
+    /* Highest priority wins, equal priorities take turns starting after the last owner. */
+    if (NULL != active)
+    {
+        start = (int8_t)((active - g_atClients) + 1);
+    }
+    for (int8_t iterator = 0; iterator < g_atClientCount; iterator++)
+    {
+        candidate = &g_atClients[(start + iterator) % g_atClientCount];
+        if (!candidate->busy)
+        {
+            continue;
+        }
+        priority = candidate->priority;
+        if ((g_var_sys - candidate->readyTick) > AT_CLIENT_AGING_MS)
+        {
+            priority = AT_PRIORITY_MAX;
+        }
+        if ((NULL == best) || (priority > bestPriority))
+        {
+            best = candidate;
+            bestPriority = priority;
+        }
+    }
+    return best;
+}
+
+static int16_t stopActiveClient(AtCallBack_n status, uint32_t bufferLen, void *buffer)
+{
+    AtClientContext_t *client = g_atContext.client;
+
+    /* Other clients may still be waiting, go back to arbitration instead of IDLE. */
+    client->busy = false;
+    g_atContext.state = AT_STATE_SELECT_COMMAND;
+    return client->eventCallBack(client->currentCmdIndex, status, bufferLen, buffer);
+}
+
 void handleErrForOtherResp(void)
 {
     NETWORK_PRINT_DEBUG("handle error, At state, %d \r\n", __func__, g_atContext.state);
     if (AT_STATE_WAIT_FOR_NTFN == g_atContext.state)
     {
-        RESET_TIMER(g_atContext.timer, 0);
+        ModemTimerStart(g_atContext.timer, 0);
     }
 }
@@ -23,14 +23,18 @@
 
 #include <stdio.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
 #include <stdlib.h>
 
 #define MAX_AT_BUFF_SIZE ((uint16_t)(16 * 1024))
 #define MAX_RCVD_BUF_LEN (16 * 1024)
+#define MAX_AT_CLIENTS 6
+#define AT_CLIENT_DEFAULT 0 /* Client used by the legacy AtStart API, registered by AtInit. */
 
 // forward declare
 typedef uint16_t (*fnPtrUrcCallBack)(uint8_t *buffer, uint16_t len, uint8_t *outBuff, uint16_t *outLen);
+typedef void (*fnPtrRawCallBack)(const uint8_t *data, uint16_t len);
 
 typedef enum
 {
@@ -79,19 +83,78 @@ typedef enum
     AT_SUCCESS,
 } AtError_n;
 
+typedef enum
+{
+    AT_PRIORITY_LOW,
+    AT_PRIORITY_NORMAL,
+    AT_PRIORITY_HIGH,
+    AT_PRIORITY_MAX,
+} AtPriority_n;
+
+typedef int8_t AtClientId_t;
+
+typedef struct
+{
+    uint32_t countTables;             /* countTables is the number of tables accepted for this client. */
+    uint32_t countCmds;               /* countCmds is the number of commands sent for this client. */
+    uint32_t queueDelayLastMs;        /* queueDelayLastMs is the time the last command waited for the modem link. */
+    uint32_t queueDelayMaxMs;         /* queueDelayMaxMs is the worst wait seen for the modem link. */
+    uint32_t queueDelayTotalMs;       /* queueDelayTotalMs is the sum of all waits, divide by countCmds for average. */
+} AtClientStats_t;
+
 typedef uint16_t (*fnPtrFillCmd)(uint8_t *cmdBuffer, int16_t offset, const AtCommands_t *atCmdTable, int8_t current_cmd_idx);
 typedef int16_t (*fnPtrEventCallBack)(uint8_t commandIdx, uint8_t status, uint32_t buffLen, void *buffer);
 typedef int8_t (*funPtrStoreResp)(const AtCommands_t *atCmdTable, uint8_t commandIdx, uint32_t buffLen, uint8_t *buffer, int8_t status);
 
 /**
- * @brief   StartAT, maps the AT Command table and respective function pointers.
+ * @brief   StartAT, maps the AT Command table and respective function pointers on the default client.
  * @param   atTable Pointer to the AT Commands table.
  * @param   maxCmd Maximum GSM commands count.
- * @return  Error code define in AtError_n
+ * @return  Error code define in AtError_n, AT_FAILED if the default client already has a table running.
  */
 AtError_n AtStart(const AtCommands_t *atTable, uint8_t maxCmd, fnPtrFillCmd fnPtrFill,
                   funPtrStoreResp fnPtrStore, fnPtrEventCallBack fnPtrCb);
 
+/**
+ * @brief   Register a client of the AT executor. Each client can have one table in progress, tables of
+ *          different clients are interleaved at command boundaries by priority.
+ * @param   name Client name used in the statistics print.
+ * @return  Client id, or AT_FAILED if no client slot is left.
+ */
+AtClientId_t AtRegisterClient(const char *name);
+
+/**
+ * @brief   Queue an AT Command table on a client.
+ * @param   client Client id returned by AtRegisterClient.
+ * @param   priority Priority used when the executor picks the next command, AtPriority_n.
+ * @param   atTable Pointer to the AT Commands table.
+ * @param   maxCmd Maximum GSM commands count.
+ * @return  Error code define in AtError_n, AT_FAILED if this client already has a table running.
+ */
+AtError_n AtStartClient(AtClientId_t client, AtPriority_n priority, const AtCommands_t *atTable, uint8_t maxCmd,
+                        fnPtrFillCmd fnPtrFill, funPtrStoreResp fnPtrStore, fnPtrEventCallBack fnPtrCb);
+
+/**
+ * @brief   Check whether a client still has a table queued or running.
+ * @param   client Client id returned by AtRegisterClient.
+ * @return  true if busy.
+ */
+bool AtIsClientBusy(AtClientId_t client);
+
+/**
+ * @brief   Read the queueing statistics of a client.
+ * @param   client Client id returned by AtRegisterClient.
+ * @param   stats Output statistics.
+ * @return  Error code define in AtError_n
+ */
+AtError_n AtGetClientStats(AtClientId_t client, AtClientStats_t *stats);
+
+/**
+ * @brief   Print the queueing statistics of all clients.
+ * @return  None.
+ */
+void AtPrintClientStats(void);
+
 /**
  * @brief   Init AT, helps configure GSM UART for Modem Communication.
  * @return  GsmHandle (Port Number).
@@ -120,9 +183,24 @@ uint8_t AtGetState(void);
 AtError_n AtRegisterUrc(UrcTable_t *ExtraTableEntries, int count);
 
 /**
- * @brief   Set AT State to IDLE.
+ * @brief   Used to register a response carrying raw data, "<string><length>\r\n" followed by length bytes.
+ *          The data is counted by length and never parsed as AT text, the reader waits until all of it is received.
+ * @param   string Response prefix, rawHandler Called with the data.
+ * @return  Error code define in AtError_n
+ */
+AtError_n AtRegisterRawUrc(const char *string, fnPtrRawCallBack rawHandler);
+
+/**
+ * @brief   Set AT State to IDLE and drop the tables of all clients.
  * @return  None.
  */
 void AtForceStop(void);
 
+/**
+ * @brief   Drop the table of one client without calling its callback, other clients keep their tables.
+ * @param   client Client id returned by AtRegisterClient.
+ * @return  Error code define in AtError_n
+ */
+AtError_n AtStopClient(AtClientId_t client);
+
 #endif /*AT_COMMAND_HANDLER*/
@@ -22,8 +22,15 @@
 #include "net_utility.h"
 
 #include "logger_can.h"
+#include "gps.h"
 
 #define MAX_NETWORK_REG_WAIT_TIME_SEC       (5 * 60 * 1000)
+#define CONN_STATUS_WATCHDOG_MS             (15 * 60 * 1000)    // Slow poll, registration and PDP state are URC driven.
+#define CONN_PDP_RETRY_MS                   (10 * 1000)         // Back-off between PDP re-activation attempts.
+#define CONN_PDP_ACT_TIMEOUT_MS             (4 * 60 * 1000)     // Longer than QIDEACT and QIACT with their retries.
+
+#define CONN_EVENT_REG_CHANGED              (0x01)              // Registration state changed, refresh operator/IP.
+#define CONN_EVENT_PDP_DEACT                (0x02)              // PDP context lost, re-activate once registered.
 
 typedef enum
 {
@@ -35,25 +42,39 @@ typedef enum
     CONNECTION_MGR_STATE_WAIT_FOR_NW_INIT,
     CONNECTION_MGR_STATE_NW_REG,
     CONNECTION_MGR_STATE_WAIT_FOR_NW_REG,
+    CONNECTION_MGR_STATE_PDP_ACT,
+    CONNECTION_MGR_STATE_WAIT_FOR_PDP_ACT,
     CONNECTION_MGR_STATE_MAX
 } ConnectionMgrStates_n;
 
 typedef struct
 {
     ConnectionMgrStates_n state;
-    uint32_t timer;
+    ModemTimer_t timer;
+    ModemTimer_t pdpRetryTimer;
+    uint8_t events;
     ConnectionMgrConfig_t config;
 } ConnectionMgrContext_t;
 typedef enum
 {
     NET_INIT_DIS_ECHO,
+#ifdef CMUX_EN
+    NET_INIT_CMUX,
+    NET_INIT_DIS_ECHO_MUX,
+#endif
     NET_INIT_CPIN_QRY,
     NET_INIT_CONFIG_URC_PORT,
     NET_INIT_CONFIG_ALL_URC,
     NET_INIT_CONFIG_CSQ_URC,
+#ifndef GPS_UBX_EN
+    NET_INIT_GNSS_OUTPORT,
+    NET_INIT_GNSS_FIX_RATE,
+    NET_INIT_GNSS_ON,
+#endif
     NET_INIT_GET_ICCID,
     NET_INIT_CREG_URC_EN,
     NET_INIT_CGREG_URC_EN,
+    NET_INIT_CEREG_URC_EN,
     NET_INIT_CONFIG_APN,
     NET_INIT_ACT_PDP,
     NET_INIT_MAX_CMD
@@ -63,13 +84,23 @@ const AtCommands_t g_netInitTable[NET_INIT_MAX_CMD] =
 {
     /* COMMAND                          SUCCESS_RSP    ERROR_RSP     OTHRRSP   NTFN FLG  TMOUT  MAXRTRYCNT  MAXNTFNRTRYCNT  STOPONERROR  WAITTIMER */
     {"E0",                              "OK",           "+CME ERROR",  "\0",    0,      3000,  1,        0,              0,              10},
+#ifdef CMUX_EN
+    {"+CMUX=0",                         "OK",           "+CME ERROR",  "\0",    0,      3000,  1,        0,              0,              1000}, /*Enter mux mode, time to open DLCs */
+    {"E0",                              "OK",           "+CME ERROR",  "\0",    0,      3000,  1,        0,              0,              10},   /*Echo is per channel, disable on DLC 1 */
+#endif
     {"+CPIN?",                          "OK",           "+CME ERROR",  "\0",    0,      3000,  1,        0,              0,              10},
     {"+QURCCFG=\"urcport\",\"uart1\"",  "\0",           "+CME ERROR",  "\0",    0,      300,   5,        0,              0,              10}, /*Enable URC PORT */
     {"+QINDCFG=\"all\",1,1",            "OK",           "+CME ERROR",  "\0",    0,      300,   5,        0,              0,              10}, /*Enable All URC */
     {"+QINDCFG=\"csq\",1,1",            "OK",           "+CME ERROR",  "\0",    0,      300,   5,        0,              0,              10}, /*Enable CSQ URC */
+#ifndef GPS_UBX_EN
+    {"+QGPSCFG=\"outport\",\"uart5\"",  "OK",           "+CME ERROR",  "\0",    0,      300,   1,        0,              0,              10}, /*NMEA on the GPS UART */
+    {"+QGPSCFG=\"fixfreq\",",           "OK",           "+CME ERROR",  "\0",    0,      300,   1,        0,              0,              10}, /*NMEA rate, GPS_FIX_RATE_HZ */
+    {"+QGPS=1",                         "OK",           "+CME ERROR",  "\0",    0,      3000,  1,        0,              0,              10}, /*Error 504 if already on */
+#endif
     {"+QCCID",                          "OK",           "+CME ERROR",  "*",     0,      300,   5,        0,              0,              10},
     {"+CREG=1",                         "OK",           "+CME ERROR",  "\0",    0,      300,   1,        0,              0,              10},
     {"+CGREG=1",                        "OK",           "+CME ERROR",  "\0",    0,      300,   1,        0,              0,              10},
+    {"+CEREG=1",                        "OK",           "+CME ERROR",  "\0",    0,      300,   1,        0,              0,              10}, /*Enable LTE registration URC */
     {"+QICSGP=",                        "OK",           "ERROR",       "\0",    0,      300,   1,        0,              0,              10},
     {"+QIACT=1",                        "OK",           "+CME ERROR",  "\0",    0,      150000,1,        0,              0,              10},
 };
@@ -91,6 +122,7 @@ typedef enum
 {
     CONN_STATUS_CREG_QRY,
     CONN_STATUS_CGREG_QRY,
+    CONN_STATUS_CEREG_QRY,
     CONN_STATUS_COPS_QRY,
     CONN_STATUS_PDP_ACT_QRY,
     CONN_STATUS_MAX_CMD
@@ -101,6 +133,7 @@ const AtCommands_t g_connStatusTable[CONN_STATUS_MAX_CMD] =
     /* COMMAND    SUCCESS_RSP  ERROR_RSP      OTHRRSP  NTFN FLG TMOUT    MAXRTRYCNT   MAXNTFNRTRYCNT  STOPONERROR   WAITTIMER */
     {"+CREG?",    "+CREG:",    "+CME ERROR",  "\0",    0,       3000,    1,           0,              0,            10},
     {"+CGREG?",   "+CGREG:",   "+CME ERROR",  "\0",    0,       3000,    1,           0,              0,            10},
+    {"+CEREG?",   "+CEREG:",   "+CME ERROR",  "\0",    0,       3000,    1,           0,              0,            10},
     {"+COPS?",    "OK",        "+CME ERROR",  "*",     0,       180000,  1,           0,              0,            10},
     {"+QIACT?",   "OK",        "+CME ERROR",  "*",     0,       150000,  1,           0,              0,            10},
 };
@@ -118,6 +151,33 @@ static int8_t storeConnStatusResponse(const AtCommands_t *cmdTbl, uint8_t comman
  */
 static int16_t connStatusCallBack(uint8_t commandIdx, uint8_t status, uint32_t bufferLen, void *buffer);
 
+typedef enum
+{
+    PDP_ACT_DEACT,
+    PDP_ACT_ACT,
+    PDP_ACT_MAX_CMD
+} PdpActCmd_n;
+
+const AtCommands_t g_pdpActTable[PDP_ACT_MAX_CMD] =
+{
+    /* COMMAND    SUCCESS_RSP  ERROR_RSP      OTHRRSP  NTFN FLG TMOUT    MAXRTRYCNT   MAXNTFNRTRYCNT  STOPONERROR   WAITTIMER */
+    {"+QIDEACT=1","OK",        "ERROR",       "\0",    0,       40000,   1,           0,              0,            10},
+    {"+QIACT=1",  "OK",        "ERROR",       "\0",    0,       150000,  1,           0,              0,            10},
+};
+
+/**
+ * @brief   The group of functions fill, store and call back is helping function for PDP re-activation table.
+ */
+static uint16_t fillPdpActCommand(uint8_t *buffer, int16_t offset, const AtCommands_t *aTCmdTble, int8_t commandIdx);
+/**
+ * @brief   The group of functions fill, store and call back is helping function for PDP re-activation table.
+ */
+static int8_t storePdpActResponse(const AtCommands_t *cmdTbl, uint8_t commandIdx, uint32_t bufferLen, uint8_t *buffer, int8_t status);
+/**
+ * @brief   The group of functions fill, store and call back is helping function for PDP re-activation table.
+ */
+static int16_t pdpActCallBack(uint8_t commandIdx, uint8_t status, uint32_t bufferLen, void *buffer);
+
 /**
  * @brief   Handle the control Urc by this function. This is call back function.
  */
@@ -130,6 +190,23 @@ static uint16_t cregUrcParser(uint8_t *buffer, uint16_t len, uint8_t *outBuff, u
  * @brief   Handle the CGREG URC by this function. This is call back function.
  */
 static uint16_t cgregUrcParser(uint8_t *buffer, uint16_t len, uint8_t *outBuff, uint16_t *outLen);
+/**
+ * @brief   Handle the CEREG URC by this function. This is call back function.
+ */
+static uint16_t ceregUrcParser(uint8_t *buffer, uint16_t len, uint8_t *outBuff, uint16_t *outLen);
+/**
+ * @brief   Handle the PDP deactivation URC by this function. This is call back function.
+ */
+static uint16_t pdpDeactUrcParser(uint8_t *buffer, uint16_t len, uint8_t *outBuff, uint16_t *outLen);
+
+/**
+ * @brief   Check whether a CREG/CGREG/CEREG stat value means registered (home or roaming).
+ */
+static bool isRegistered(uint8_t stat);
+/**
+ * @brief   Re-evaluate network status from CREG/CGREG/CEREG and raise an event on change.
+ */
+static void updateNetworkStatus(void);
 
 /**
  * @brief   Clear the connection manager info sturct and set to default state.
@@ -138,12 +215,15 @@ static void clearConnection(void);
 
 ConnectionMgrContext_t g_connectionMgrContext;
 ConnectionMgrInfo_t g_connectionMgrInfo;
+static AtClientId_t g_atClient;
 
 UrcTable_t g_connMgrUrcTable[] =
 {
     {"+QIND: ",     &controlUrcParser}, // Received URC for csq, PB DONE etc
     {"+CREG: ",     &cregUrcParser},    // Received URC for creg
     {"+CGREG: ",    &cgregUrcParser},  // Received URC for cgreg
+    {"+CEREG: ",    &ceregUrcParser},  // Received URC for cereg
+    {"+QIURC: \"pdpdeact\"", &pdpDeactUrcParser}, // PDP context deactivated by network
 };
 
 
@@ -152,7 +232,12 @@ ConnMgrErrorCode_n ConnectionMgrInit(void)
     memset((void *)&g_connectionMgrInfo, 0x00, sizeof(g_connectionMgrInfo));
     sprintf((char *)g_connectionMgrInfo.operatorName, "DEFAULT");
     g_connectionMgrContext.state = CONNECTION_MGR_STATE_SWITCH_OFF_DEVICE;
+    g_connectionMgrContext.events = 0;
+    ModemTimerCreate(&g_connectionMgrContext.timer);
+    ModemTimerCreate(&g_connectionMgrContext.pdpRetryTimer);
+    ModemTimerStart(g_connectionMgrContext.pdpRetryTimer, 0); // First deactivation is retried without back-off.
     AtRegisterUrc(g_connMgrUrcTable, sizeof(g_connMgrUrcTable) / sizeof(g_connMgrUrcTable[0]));
+    g_atClient = AtRegisterClient("connmgr");
     sprintf((char *)g_connectionMgrContext.config.apnName, "sensem2m2"); 
     return CONN_MGR_SUCCESS;
 }
@@ -177,14 +262,15 @@ ConnMgrErrorCode_n ConnectionMgrExe(void)
         break;
 
     case CONNECTION_MGR_STATE_SWITCH_OFF_DEVICE:
+        ModemCmuxStop(false);
         ModemRstKeyHigh();
         NETWORK_PRINT_DEBUG("power down\r\n");
-        RESET_TIMER(g_connectionMgrContext.timer, 1 * 1000);
+        ModemTimerStart(g_connectionMgrContext.timer, 1 * 1000);
         g_connectionMgrContext.state = CONNECTION_MGR_STATE_SWITCH_ON_DEVICE;
         break;
 
     case CONNECTION_MGR_STATE_SWITCH_ON_DEVICE:
-        if (!IS_TIMER_ELAPSED(g_connectionMgrContext.timer))
+        if (!ModemTimerExpired(g_connectionMgrContext.timer))
         {
             break;
         }
@@ -194,49 +280,85 @@ ConnMgrErrorCode_n ConnectionMgrExe(void)
         break;
 
     case CONNECTION_MGR_STATE_STATUS:
-        if (!IS_TIMER_ELAPSED(g_connectionMgrContext.timer))
+        if (!ModemTimerExpired(g_connectionMgrContext.timer))
         {
             break;
         }
         g_connectionMgrContext.state = CONNECTION_MGR_STATE_NW_INIT;
-        RESET_TIMER(g_connectionMgrContext.timer, 10 * 1000);
+        ModemTimerStart(g_connectionMgrContext.timer, 10 * 1000);
         g_connectionMgrInfo.modemReady = 1;
         break;
 
     case CONNECTION_MGR_STATE_NW_INIT:
-        if (!IS_TIMER_ELAPSED(g_connectionMgrContext.timer))
+        if (!ModemTimerExpired(g_connectionMgrContext.timer))
         {
             break;
         }
-        atErrorResp = AtStart(g_netInitTable, (uint8_t)NET_INIT_MAX_CMD, fillInitCommand, storeInitResponse, initCallBack);
+        atErrorResp = AtStartClient(g_atClient, AT_PRIORITY_HIGH, g_netInitTable, (uint8_t)NET_INIT_MAX_CMD, fillInitCommand, storeInitResponse, initCallBack);
         if (AT_SUCCESS == atErrorResp)
         {
-            RESET_TIMER(g_connectionMgrContext.timer, 60 * 1000);
+            ModemTimerStart(g_connectionMgrContext.timer, 60 * 1000);
             g_connectionMgrContext.state = CONNECTION_MGR_STATE_WAIT_FOR_NW_INIT;
         }
         break;
 
     case CONNECTION_MGR_STATE_WAIT_FOR_NW_INIT:
-        if (!IS_TIMER_ELAPSED(g_connectionMgrContext.timer))
+        if (!ModemTimerExpired(g_connectionMgrContext.timer))
         {
             break;
         }
         break;
 
     case CONNECTION_MGR_STATE_NW_REG:
-        atErrorResp = AtStart(g_connStatusTable, (uint8_t)CONN_STATUS_MAX_CMD, fillConnStatusCommand, storeConnStatusResponse, connStatusCallBack);
+        atErrorResp = AtStartClient(g_atClient, AT_PRIORITY_HIGH, g_connStatusTable, (uint8_t)CONN_STATUS_MAX_CMD, fillConnStatusCommand, storeConnStatusResponse, connStatusCallBack);
         if (AT_SUCCESS == atErrorResp)
         {
-            RESET_TIMER(g_connectionMgrContext.timer, 2 * 60 * 1000);
+            g_connectionMgrContext.events &= ~CONN_EVENT_REG_CHANGED;
+            ModemTimerStart(g_connectionMgrContext.timer, CONN_STATUS_WATCHDOG_MS);
             g_connectionMgrContext.state = CONNECTION_MGR_STATE_WAIT_FOR_NW_REG;
         }
         break;
 
     case CONNECTION_MGR_STATE_WAIT_FOR_NW_REG:
-        if (!IS_TIMER_ELAPSED(g_connectionMgrContext.timer))
+        if (0 != (g_connectionMgrContext.events & CONN_EVENT_REG_CHANGED))
+        {
+            g_connectionMgrContext.state = CONNECTION_MGR_STATE_NW_REG;
+            break;
+        }
+        if ((0 != (g_connectionMgrContext.events & CONN_EVENT_PDP_DEACT)) && g_connectionMgrInfo.networkStatus &&
+            ModemTimerExpired(g_connectionMgrContext.pdpRetryTimer))
+        {
+            g_connectionMgrContext.state = CONNECTION_MGR_STATE_PDP_ACT;
+            break;
+        }
+        if (!ModemTimerExpired(g_connectionMgrContext.timer))
+        {
+            break;
+        }
+        g_connectionMgrContext.state = CONNECTION_MGR_STATE_NW_REG;
+        break;
+
+    case CONNECTION_MGR_STATE_PDP_ACT:
+        atErrorResp = AtStartClient(g_atClient, AT_PRIORITY_HIGH, g_pdpActTable, (uint8_t)PDP_ACT_MAX_CMD, fillPdpActCommand, storePdpActResponse, pdpActCallBack);
+        if (AT_SUCCESS == atErrorResp)
+        {
+            NETWORK_PRINT_DEBUG("re-activating PDP context\r\n");
+            g_connectionMgrContext.events &= ~CONN_EVENT_PDP_DEACT;
+            ModemTimerStart(g_connectionMgrContext.pdpRetryTimer, CONN_PDP_RETRY_MS);
+            ModemTimerStart(g_connectionMgrContext.timer, CONN_PDP_ACT_TIMEOUT_MS);
+            g_connectionMgrContext.state = CONNECTION_MGR_STATE_WAIT_FOR_PDP_ACT;
+        }
+        break;
+
+    case CONNECTION_MGR_STATE_WAIT_FOR_PDP_ACT:
+        if (!ModemTimerExpired(g_connectionMgrContext.timer))
         {
             break;
         }
+        /* No answer to the table, drop it so a later PDP_ACT can start, then retry after the back-off. */
+        NETWORK_PRINT_ERROR("PDP re-activation timed out\r\n");
+        AtStopClient(g_atClient);
+        g_connectionMgrContext.events |= CONN_EVENT_PDP_DEACT;
         g_connectionMgrContext.state = CONNECTION_MGR_STATE_NW_REG;
         break;
 
@@ -257,12 +379,25 @@ uint16_t fillInitCommand(uint8_t *buffer, int16_t offset, const AtCommands_t *aT
     {
         length += sprintf(&bufferPtr[length], "1,1,\"%s\",\"\",\"\",0", g_connectionMgrContext.config.apnName);
     }
+#ifndef GPS_UBX_EN
+    if (NET_INIT_GNSS_FIX_RATE == commandIdx)
+    {
+        length += sprintf(&bufferPtr[length], "%d", GPS_FIX_RATE_HZ);
+    }
+#endif
     length += sprintf(&bufferPtr[length], "\r\n", aTCmdTble->command);
     return length;
 }
 
 static int8_t storeInitResponse(const AtCommands_t *cmdTbl, uint8_t commandIdx, uint32_t bufferLen, uint8_t *buffer, int8_t status)
 {
+#ifdef CMUX_EN
+    if ((NET_INIT_CMUX == commandIdx) && (AT_CB_SUCCESS_SINGLE_CMD == status))
+    {
+        /* Modem is in mux mode after this OK, next commands go over the AT channel. */
+        ModemCmuxStart();
+    }
+#endif
     return 0;
 }
 
@@ -345,6 +480,37 @@ static int8_t storeConnStatusResponse(const AtCommands_t *cmdTbl, uint8_t comman
 
 static int16_t connStatusCallBack(uint8_t commandIdx, uint8_t status, uint32_t bufferLen, void *buffer)
 {
+    if (AT_CB_ALL_CMD_OVR == status)
+    {
+        /* Registered but no address means the PDP context is down, e.g. a deactivation URC was missed. */
+        if (g_connectionMgrInfo.networkStatus && ('\0' == g_connectionMgrInfo.ipAddress[0]))
+        {
+            g_connectionMgrContext.events |= CONN_EVENT_PDP_DEACT;
+        }
+    }
+    return 0;
+}
+
+uint16_t fillPdpActCommand(uint8_t *buffer, int16_t offset, const AtCommands_t *aTCmdTble, int8_t commandIdx)
+{
+    int32_t length = 0;
+
+    length = sprintf((char *)&buffer[offset], "AT%s\r\n", aTCmdTble->command);
+    return length;
+}
+
+static int8_t storePdpActResponse(const AtCommands_t *cmdTbl, uint8_t commandIdx, uint32_t bufferLen, uint8_t *buffer, int8_t status)
+{
+    return 0;
+}
+
+static int16_t pdpActCallBack(uint8_t commandIdx, uint8_t status, uint32_t bufferLen, void *buffer)
+{
+    if (AT_CB_ALL_CMD_OVR == status)
+    {
+        /* Re-read QIACT? so the new IP address is picked up. */
+        g_connectionMgrContext.state = CONNECTION_MGR_STATE_NW_REG;
+    }
     return 0;
 }
 
@@ -411,16 +577,7 @@ uint16_t cregUrcParser(uint8_t *buffer, uint16_t len, uint8_t *outBuff, uint16_t
         }
 
         parseLen = CalculateUrcParseLen((char *)buffer, startPtr, endPtr, (char *)outBuff, outLen, len);
-
-        if (((1 == g_connectionMgrInfo.creg) || (5 == g_connectionMgrInfo.creg)) &&
-            ((1 == g_connectionMgrInfo.cgreg) || (5 == g_connectionMgrInfo.cgreg)))
-        {
-            g_connectionMgrInfo.networkStatus = true;
-        }
-        else
-        {
-            clearConnection();
-        }
+        updateNetworkStatus();
         return parseLen;
     }
     return 0;
@@ -455,21 +612,96 @@ uint16_t cgregUrcParser(uint8_t *buffer, uint16_t len, uint8_t *outBuff, uint16_
         }
 
         parseLen = CalculateUrcParseLen((char *)buffer, startPtr, endPtr, (char *)outBuff, outLen, len);
+        updateNetworkStatus();
+        return parseLen;
+    }
+    return 0;
+}
+
+uint16_t ceregUrcParser(uint8_t *buffer, uint16_t len, uint8_t *outBuff, uint16_t *outLen)
+{
+    char *workingPtr = NULL;
+    char *startPtr = NULL;
+    char *endPtr = NULL;
+    const char *urcString = "+CEREG: ";
+    uint16_t parseLen = 0;
+
+    if (NULL != (startPtr = strstr((char *)buffer, urcString)))
+    {
+        if (NULL != (workingPtr = strstr(startPtr, ","))) /* query response +CEREG: 1,1 */
+        {
+            g_connectionMgrInfo.cereg = atoi(++workingPtr);
+            NETWORK_PRINT_TRACE("CEREG: %d\r\n", g_connectionMgrInfo.cereg);
+            endPtr = workingPtr + 2; // move to end of urc i.e "/r/n"
+        }
+        else /* unsolicited +CEREG: 5 */
+        {
+            workingPtr = startPtr + strlen(urcString);
+            g_connectionMgrInfo.cereg = atoi(workingPtr);
+            NETWORK_PRINT_TRACE("CEREG: %d\r\n", g_connectionMgrInfo.cereg);
+            endPtr = workingPtr + 2; // move to end of urc i.e "/r/n"
+        }
+
+        parseLen = CalculateUrcParseLen((char *)buffer, startPtr, endPtr, (char *)outBuff, outLen, len);
+        updateNetworkStatus();
+        return parseLen;
+    }
+    return 0;
+}
 
-        if (((1 == g_connectionMgrInfo.creg) || (5 == g_connectionMgrInfo.creg)) &&
-            ((1 == g_connectionMgrInfo.cgreg) || (5 == g_connectionMgrInfo.cgreg)))
+uint16_t pdpDeactUrcParser(uint8_t *buffer, uint16_t len, uint8_t *outBuff, uint16_t *outLen)
+{
+    char *startPtr = NULL;
+    char *endPtr = NULL;
+    const char *urcString = "+QIURC: \"pdpdeact\"";
+    uint16_t parseLen = 0;
+
+    if (NULL != (startPtr = strstr((char *)buffer, urcString))) /* +QIURC: "pdpdeact",1 */
+    {
+        if (NULL != (endPtr = strstr(startPtr, "\r\n")))
         {
-            g_connectionMgrInfo.networkStatus = true;
+            endPtr += 2;
         }
         else
         {
-            clearConnection();
+            endPtr = startPtr + strlen(urcString);
         }
+        parseLen = CalculateUrcParseLen((char *)buffer, startPtr, endPtr, (char *)outBuff, outLen, len);
+
+        NETWORK_PRINT_INFO("PDP context deactivated by network\r\n");
+        memset(g_connectionMgrInfo.ipAddress, 0x00, sizeof(g_connectionMgrInfo.ipAddress));
+        g_connectionMgrContext.events |= CONN_EVENT_PDP_DEACT;
         return parseLen;
     }
     return 0;
 }
 
+static bool isRegistered(uint8_t stat)
+{
+    return ((1 == stat) || (5 == stat));
+}
+
+static void updateNetworkStatus(void)
+{
+    bool registered = isRegistered(g_connectionMgrInfo.cereg) ||
+                      (isRegistered(g_connectionMgrInfo.creg) && isRegistered(g_connectionMgrInfo.cgreg));
+
+    if (registered != g_connectionMgrInfo.networkStatus)
+    {
+        NETWORK_PRINT_INFO("network %s\r\n", registered ? "registered" : "lost");
+        g_connectionMgrContext.events |= CONN_EVENT_REG_CHANGED;
+    }
+
+    if (registered)
+    {
+        g_connectionMgrInfo.networkStatus = true;
+    }
+    else
+    {
+        clearConnection();
+    }
+}
+
 static void clearConnection(void)
 {
     g_connectionMgrInfo.networkStatus = false;
@@ -481,8 +713,8 @@ static void clearConnection(void)
 void ConnectionMgrPrintInfo(void)
 {
     ConnectionMgrInfo_t connInfo = ConnectionMgrGetInfo();
-    NETWORK_PRINT_INFO("[NET] network status: %d, CREG: %d, CGREG: %d, CSQ: %d, op name: %s %d, IP: %s \r\n",
-           connInfo.networkStatus, connInfo.creg, connInfo.cgreg, connInfo.csq, connInfo.operatorName,
+    NETWORK_PRINT_INFO("[NET] network status: %d, CREG: %d, CGREG: %d, CEREG: %d, CSQ: %d, op name: %s %d, IP: %s \r\n",
+           connInfo.networkStatus, connInfo.creg, connInfo.cgreg, connInfo.cereg, connInfo.csq, connInfo.operatorName,
            connInfo.accessTechnology, connInfo.ipAddress);
 
     LoggerCan_u sysGsmA = {0};
@@ -34,6 +34,7 @@ typedef struct
     bool networkStatus;
     uint8_t creg;
     uint8_t cgreg;
+    uint8_t cereg;
     bool modemReady;
     uint8_t csq;
     uint8_t operatorName[MAX_OPERATOR_NAME_LEN];
@@ -74,7 +75,7 @@ ConnectionMgrInfo_t ConnectionMgrGetInfo(void);
 
 /**
  * @brief   Retrieves the network status.
- * @return  Return true if CERG and CGREG available.
+ * @return  Return true if CEREG or both CREG and CGREG report registered.
  * 
  */
 bool ConnectionMgrIsNetAvailable(void);
@@ -0,0 +1,604 @@
+/**
+ * @file        modem_cmux.c
+ *
+ * @copyright   Accolade Electronics Pvt Ltd, 2023-24
+ *              All Rights Reserved
+ *              UNPUBLISHED, LICENSED SOFTWARE.
+ *              Accolade Electronics, Pune
+ *              CONFIDENTIAL AND PROPRIETARY INFORMATION
+ *              WHICH IS THE PROPERTY OF M/s Accolade Electronics.
+ *
+ * @date        19 October 2026
+ * @author      agent <agent@local>
+ *              Diksha J <diksha.jadhav@accoladeelectronics.com>
+ *
+ * @brief       3GPP TS 27.010 multiplexer (basic option) between the modem port and the GSM UART.
+ */
+
+// Standard includes.
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Port includes.
+#include "modem_cmux.h"
+#include "modem_port.h"
+#include "hal_cbuf.h"
+
+#define CMUX_FLAG                           0xF9
+#define CMUX_EA                             0x01
+#define CMUX_CR                             0x02
+#define CMUX_PF                             0x10
+
+#define CMUX_CTRL_SABM                      0x2F
+#define CMUX_CTRL_UA                        0x63
+#define CMUX_CTRL_DM                        0x0F
+#define CMUX_CTRL_DISC                      0x43
+#define CMUX_CTRL_UIH                       0xEF
+
+#define CMUX_MSG_CLD                        0xC0    /* Multiplexer close down. */
+#define CMUX_MSG_MSC                        0xE0    /* Modem status command. */
+#define CMUX_MSG_TEST                       0x20    /* Test command, echoed back. */
+
+#define CMUX_V24_FC                         0x02    /* Flow control, peer cannot accept frames. */
+#define CMUX_V24_RTC                        0x04
+#define CMUX_V24_RTR                        0x08
+#define CMUX_V24_DV                         0x80
+
+#define CMUX_FCS_INIT                       0xFF
+#define CMUX_FCS_GOOD                       0xCF
+
+#define CMUX_T1_MS                          300     /* Wait for UA before repeating SABM. */
+#define CMUX_N2                             3       /* Max SABM retransmissions. */
+#define CMUX_LOWER_CHUNK                    256     /* UART bytes pulled per read. */
+
+#define CMUX_RX_SIZE_AT                     (8 * 1024)
+
+typedef enum
+{
+    CMUX_DEC_WAIT_FLAG,
+    CMUX_DEC_ADDRESS,
+    CMUX_DEC_CONTROL,
+    CMUX_DEC_LENGTH,
+    CMUX_DEC_LENGTH2,
+    CMUX_DEC_INFO,
+    CMUX_DEC_FCS,
+    CMUX_DEC_END_FLAG,
+} CmuxDecodeStates_n;
+
+typedef struct
+{
+    uint8_t state;                      /* state is used to store the current decoder state, CmuxDecodeStates_n. */
+    uint8_t address;                    /* address is the address byte of the frame being decoded. */
+    uint8_t control;                    /* control is the control byte of the frame being decoded. */
+    uint8_t fcs;                        /* fcs is the running FCS over the header bytes. */
+    uint16_t length;                    /* length is the information field length announced by the frame. */
+    uint16_t received;                  /* received is the number of information bytes stored so far. */
+    uint8_t info[CMUX_MAX_RX_INFO_LEN]; /* info is used to store the information field until the FCS is checked. */
+} CmuxDecoder_t;
+
+typedef struct
+{
+    bool open;                          /* open is true once the modem answered the SABM with UA. */
+    bool flowStopped;                   /* flowStopped is true while the modem reports FC in its MSC. */
+    uint8_t retryCount;                 /* retryCount is used to store the SABM retransmission count. */
+    volatile HalCbuf_t *rxBuff;         /* rxBuff is used to store received data of the channel, NULL for control. */
+} CmuxChannelContext_t;
+
+typedef struct
+{
+    bool active;                        /* active is true between CmuxStart and CmuxStop. */
+    uint8_t opening;                    /* opening is the channel waiting for UA, CMUX_CHANNEL_MAX when all are open. */
+    ModemTimer_t timer;                 /* timer is used for the UA wait (T1). */
+    fnPtrCmuxIo lowerRead;
+    fnPtrCmuxIo lowerWrite;
+    CmuxChannelContext_t channel[CMUX_CHANNEL_MAX];
+    CmuxDecoder_t decoder;
+    CmuxStats_t stats;
+} CmuxContext_t;
+
+/**
+ * @brief   Runs the 27.010 FCS (reflected CRC-8, x^8 + x^2 + x + 1) over a buffer.
+ */
+static uint8_t fcsCalc(uint8_t fcs, const uint8_t *buffer, uint16_t len);
+/**
+ * @brief   Builds a frame and writes it to the UART.
+ */
+static uint32_t sendFrame(uint8_t dlci, bool command, uint8_t control, const uint8_t *info, uint16_t len);
+/**
+ * @brief   Sends SABM for a channel and starts the UA wait.
+ */
+static void openChannel(uint8_t dlci);
+/**
+ * @brief   Sends a control channel message (type and value bytes).
+ */
+static void sendControlMessage(uint8_t type, bool command, const uint8_t *value, uint8_t len);
+/**
+ * @brief   Feeds one UART byte to the frame decoder.
+ */
+static void decodeByte(uint8_t byte);
+/**
+ * @brief   Handles a frame that passed the FCS check.
+ */
+static void handleFrame(uint8_t dlci, uint8_t control, const uint8_t *info, uint16_t len);
+/**
+ * @brief   Handles a message received on the control channel.
+ */
+static void handleControlMessage(const uint8_t *info, uint16_t len);
+
+static uint8_t g_cmuxRxMemAt[CMUX_RX_SIZE_AT];
+static volatile HalCbuf_t g_cmuxRxAt = { .mem = g_cmuxRxMemAt, .sizeMem = sizeof(g_cmuxRxMemAt) };
+
+static CmuxContext_t g_cmuxContext;
+
+CmuxError_n CmuxInit(fnPtrCmuxIo lowerRead, fnPtrCmuxIo lowerWrite)
+{
+    ModemTimer_t timer;
+
+    if ((NULL == lowerRead) || (NULL == lowerWrite))
+    {
+        return CMUX_INVALID_MEMORY;
+    }
+
+    timer = g_cmuxContext.timer;        /* Timer survives a re-init, the OSAL timer pool is not freed. */
+    memset(&g_cmuxContext, 0x00, sizeof(g_cmuxContext));
+    g_cmuxContext.timer = timer;
+    ModemTimerCreate(&g_cmuxContext.timer);
+    g_cmuxContext.lowerRead = lowerRead;
+    g_cmuxContext.lowerWrite = lowerWrite;
+    g_cmuxContext.channel[CMUX_CHANNEL_AT].rxBuff = &g_cmuxRxAt;
+    CmuxStop(false);
+    return CMUX_SUCCESS;
+}
+
+CmuxError_n CmuxStart(void)
+{
+    if (NULL == g_cmuxContext.lowerWrite)
+    {
+        return CMUX_INVALID_MEMORY;
+    }
+    if (g_cmuxContext.active)
+    {
+        return CMUX_FAILED;
+    }
+
+    g_cmuxContext.active = true;
+    g_cmuxContext.decoder.state = CMUX_DEC_WAIT_FLAG;
+    openChannel(CMUX_CHANNEL_CONTROL);
+    NETWORK_PRINT_INFO("CMUX start\r\n");
+    return CMUX_SUCCESS;
+}
+
+void CmuxStop(bool closeDown)
+{
+    uint8_t dlci = 0;
+
+    if (closeDown && g_cmuxContext.active)
+    {
+        sendControlMessage(CMUX_MSG_CLD, true, NULL, 0);
+    }
+
+    g_cmuxContext.active = false;
+    g_cmuxContext.opening = CMUX_CHANNEL_MAX;
+    g_cmuxContext.decoder.state = CMUX_DEC_WAIT_FLAG;
+    for (dlci = 0; dlci < CMUX_CHANNEL_MAX; dlci++)
+    {
+        g_cmuxContext.channel[dlci].open = false;
+        g_cmuxContext.channel[dlci].flowStopped = false;
+        g_cmuxContext.channel[dlci].retryCount = 0;
+        if (NULL != g_cmuxContext.channel[dlci].rxBuff)
+        {
+            hal_cbuf_init(g_cmuxContext.channel[dlci].rxBuff);
+        }
+    }
+}
+
+bool CmuxIsActive(void)
+{
+    return g_cmuxContext.active;
+}
+
+bool CmuxIsChannelReady(CmuxChannel_n channel)
+{
+    if ((CMUX_CHANNEL_CONTROL == channel) || (channel >= CMUX_CHANNEL_MAX))
+    {
+        return false;
+    }
+    return (g_cmuxContext.active && g_cmuxContext.channel[channel].open && !g_cmuxContext.channel[channel].flowStopped);
+}
+
+void CmuxProcess(void)
+{
+    uint8_t chunk[CMUX_LOWER_CHUNK];
+    uint32_t length = 0;
+    uint32_t iterator = 0;
+
+    if (!g_cmuxContext.active)
+    {
+        return;
+    }
+
+    do
+    {
+        length = g_cmuxContext.lowerRead(chunk, sizeof(chunk));
+        for (iterator = 0; iterator < length; iterator++)
+        {
+            decodeByte(chunk[iterator]);
+        }
+    } while (length == sizeof(chunk));
+
+    /* Channel open in progress and no UA in T1, repeat the SABM up to N2 times. */
+    if ((CMUX_CHANNEL_MAX > g_cmuxContext.opening) && ModemTimerExpired(g_cmuxContext.timer))
+    {
+        if (CMUX_N2 <= g_cmuxContext.channel[g_cmuxContext.opening].retryCount)
+        {
+            /* A channel missing would drop its traffic silently, close the mux and go back to plain AT. */
+            NETWORK_PRINT_ERROR("CMUX DLCI %d not opened, back to plain AT\r\n", g_cmuxContext.opening);
+            g_cmuxContext.stats.countOpenFailures++;
+            CmuxStop(true);
+        }
+        else
+        {
+            g_cmuxContext.channel[g_cmuxContext.opening].retryCount++;
+            openChannel(g_cmuxContext.opening);
+        }
+    }
+}
+
+uint32_t CmuxAvailable(CmuxChannel_n channel)
+{
+    size_t available = 0;
+
+    if ((channel >= CMUX_CHANNEL_MAX) || (NULL == g_cmuxContext.channel[channel].rxBuff))
+    {
+        return 0;
+    }
+    hal_cbuf_available_read(g_cmuxContext.channel[channel].rxBuff, &available);
+    return (uint32_t)available;
+}
+
+uint32_t CmuxRead(CmuxChannel_n channel, uint8_t *buff, uint32_t maxLen)
+{
+    HalBuffer_t buf = {buff, maxLen};
+    uint32_t length = CmuxAvailable(channel);
+
+    if ((NULL == buff) || (0 == length))
+    {
+        return 0;
+    }
+    if (length > maxLen)
+    {
+        length = maxLen;
+    }
+    if (HalCbufErrOk != hal_cbuf_dequeue(g_cmuxContext.channel[channel].rxBuff, buf, length))
+    {
+        return 0;
+    }
+    return length;
+}
+
+int32_t CmuxWrite(CmuxChannel_n channel, const uint8_t *buff, uint32_t len)
+{
+    uint32_t written = 0;
+    uint16_t chunk = 0;
+
+    if ((NULL == buff) || (CMUX_CHANNEL_CONTROL == channel) || (channel >= CMUX_CHANNEL_MAX))
+    {
+        return CMUX_INVALID_MEMORY;
+    }
+    if (!g_cmuxContext.active)
+    {
+        return CMUX_FAILED;
+    }
+    if (!CmuxIsChannelReady(channel))
+    {
+        /* Opening or flow controlled, the caller writes again later. A channel closed by the modem stays closed. */
+        return (g_cmuxContext.channel[channel].open || (g_cmuxContext.opening <= channel)) ? CMUX_BUSY : CMUX_FAILED;
+    }
+
+    while (written < len)
+    {
+        chunk = ((len - written) > CMUX_N1) ? CMUX_N1 : (uint16_t)(len - written);
+        if (0 == sendFrame((uint8_t)channel, true, CMUX_CTRL_UIH, &buff[written], chunk))
+        {
+            break;
+        }
+        written += chunk;
+    }
+    return (0 == written) ? CMUX_BUSY : (int32_t)written;
+}
+
+CmuxStats_t CmuxGetStats(void)
+{
+    return g_cmuxContext.stats;
+}
+
+static uint8_t fcsCalc(uint8_t fcs, const uint8_t *buffer, uint16_t len)
+{
+    uint16_t iterator = 0;
+    uint8_t bit = 0;
+
+    for (iterator = 0; iterator < len; iterator++)
+    {
+        fcs ^= buffer[iterator];
+        for (bit = 0; bit < 8; bit++)
+        {
+            fcs = (fcs & 0x01) ? (uint8_t)((fcs >> 1) ^ 0xE0) : (uint8_t)(fcs >> 1);
+        }
+    }
+    return fcs;
+}
+
+static uint32_t sendFrame(uint8_t dlci, bool command, uint8_t control, const uint8_t *info, uint16_t len)
+{
+    uint8_t frame[CMUX_N1 + 7];
+    uint16_t length = 0;
+    uint16_t headerLen = 0;
+
+    if (len > CMUX_N1)
+    {
+        return 0;
+    }
+
+    frame[length++] = CMUX_FLAG;
+    frame[length++] = (uint8_t)((dlci << 2) | (command ? CMUX_CR : 0) | CMUX_EA);
+    frame[length++] = control;
+    frame[length++] = (uint8_t)((len << 1) | CMUX_EA);
+    headerLen = length - 1;
+    if (len)
+    {
+        memcpy(&frame[length], info, len);
+        length += len;
+    }
+    /* For UIH the FCS covers the header only, for the other frames there is no information field. */
+    frame[length++] = (uint8_t)(CMUX_FCS_INIT - fcsCalc(CMUX_FCS_INIT, &frame[1], headerLen));
+    frame[length++] = CMUX_FLAG;
+
+    if (length != g_cmuxContext.lowerWrite(frame, length))
+    {
+        NETWORK_PRINT_ERROR("CMUX TX short write DLCI %d\r\n", dlci);
+        return 0;
+    }
+    g_cmuxContext.stats.countTxFrames++;
+    return length;
+}
+
+static void openChannel(uint8_t dlci)
+{
+    g_cmuxContext.opening = dlci;
+    ModemTimerStart(g_cmuxContext.timer, CMUX_T1_MS);
+    sendFrame(dlci, true, (uint8_t)(CMUX_CTRL_SABM | CMUX_PF), NULL, 0);
+}
+
+static void sendControlMessage(uint8_t type, bool command, const uint8_t *value, uint8_t len)
+{
+    uint8_t message[CMUX_N1];
+
+    if ((uint16_t)len + 2 > sizeof(message))
+    {
+        return;
+    }
+    message[0] = (uint8_t)(type | (command ? CMUX_CR : 0) | CMUX_EA);
+    message[1] = (uint8_t)((len << 1) | CMUX_EA);
+    if (len)
+    {
+        memcpy(&message[2], value, len);
+    }
+    sendFrame(CMUX_CHANNEL_CONTROL, true, CMUX_CTRL_UIH, message, (uint16_t)(len + 2));
+}
+
+static void decodeByte(uint8_t byte)
+{
+    CmuxDecoder_t *decoder = &g_cmuxContext.decoder;
+
+    switch (decoder->state)
+    {
+    case CMUX_DEC_WAIT_FLAG:
+        if (CMUX_FLAG == byte)
+        {
+            decoder->state = CMUX_DEC_ADDRESS;
+        }
+        break;
+
+    case CMUX_DEC_ADDRESS:
+        /* Back to back flags, closing flag of the previous frame followed by the opening one. */
+        if (CMUX_FLAG == byte)
+        {
+            break;
+        }
+        decoder->address = byte;
+        decoder->fcs = fcsCalc(CMUX_FCS_INIT, &byte, 1);
+        decoder->state = CMUX_DEC_CONTROL;
+        break;
+
+    case CMUX_DEC_CONTROL:
+        decoder->control = byte;
+        decoder->fcs = fcsCalc(decoder->fcs, &byte, 1);
+        decoder->state = CMUX_DEC_LENGTH;
+        break;
+
+    case CMUX_DEC_LENGTH:
+        decoder->fcs = fcsCalc(decoder->fcs, &byte, 1);
+        decoder->length = (uint16_t)(byte >> 1);
+        decoder->received = 0;
+        if (0 == (byte & CMUX_EA))
+        {
+            decoder->state = CMUX_DEC_LENGTH2;
+        }
+        else
+        {
+            decoder->state = (0 == decoder->length) ? CMUX_DEC_FCS : CMUX_DEC_INFO;
+        }
+        break;
+
+    case CMUX_DEC_LENGTH2:
+        decoder->fcs = fcsCalc(decoder->fcs, &byte, 1);
+        decoder->length |= (uint16_t)((uint16_t)byte << 7);
+        if (decoder->length > CMUX_MAX_RX_INFO_LEN)
+        {
+            g_cmuxContext.stats.countFramingErrors++;
+            decoder->state = CMUX_DEC_WAIT_FLAG;
+            break;
+        }
+        decoder->state = (0 == decoder->length) ? CMUX_DEC_FCS : CMUX_DEC_INFO;
+        break;
+
+    case CMUX_DEC_INFO:
+        decoder->info[decoder->received++] = byte;
+        if (decoder->received >= decoder->length)
+        {
+            decoder->state = CMUX_DEC_FCS;
+        }
+        break;
+
+    case CMUX_DEC_FCS:
+        decoder->fcs = fcsCalc(decoder->fcs, &byte, 1);
+        decoder->state = CMUX_DEC_END_FLAG;
+        break;
+
+    case CMUX_DEC_END_FLAG:
+        if (CMUX_FLAG != byte)
+        {
+            g_cmuxContext.stats.countFramingErrors++;
+            decoder->state = CMUX_DEC_WAIT_FLAG;
+            break;
+        }
+        if (CMUX_FCS_GOOD != decoder->fcs)
+        {
+            g_cmuxContext.stats.countFcsErrors++;
+        }
+        else
+        {
+            g_cmuxContext.stats.countRxFrames++;
+            handleFrame((uint8_t)(decoder->address >> 2), (uint8_t)(decoder->control & ~CMUX_PF), decoder->info, decoder->received);
+        }
+        /* The closing flag may also open the next frame. */
+        decoder->state = CMUX_DEC_ADDRESS;
+        break;
+
+    default:
+        decoder->state = CMUX_DEC_WAIT_FLAG;
+        break;
+    }
+}
+
+static void handleFrame(uint8_t dlci, uint8_t control, const uint8_t *info, uint16_t len)
+{
+    CmuxChannelContext_t *channel = NULL;
+    HalBuffer_t buf = {(uint8_t *)info, len};
+    uint8_t v24[2] = {0};
+
+    if (dlci >= CMUX_CHANNEL_MAX)
+    {
+        return;
+    }
+    channel = &g_cmuxContext.channel[dlci];
+
+    switch (control)
+    {
+    case CMUX_CTRL_UA:
+        if (dlci != g_cmuxContext.opening)
+        {
+            break;
+        }
+        channel->open = true;
+        NETWORK_PRINT_DEBUG("CMUX DLCI %d open\r\n", dlci);
+        if (CMUX_CHANNEL_CONTROL != dlci)
+        {
+            /* Tell the modem we are ready on this channel. */
+            v24[0] = (uint8_t)((dlci << 2) | CMUX_CR | CMUX_EA);
+            v24[1] = (uint8_t)(CMUX_V24_RTC | CMUX_V24_RTR | CMUX_V24_DV | CMUX_EA);
+            sendControlMessage(CMUX_MSG_MSC, true, v24, sizeof(v24));
+        }
+        if ((dlci + 1) < CMUX_CHANNEL_MAX)
+        {
+            openChannel((uint8_t)(dlci + 1));
+        }
+        else
+        {
+            g_cmuxContext.opening = CMUX_CHANNEL_MAX;
+        }
+        break;
+
+    case CMUX_CTRL_DM:
+        /* Every channel carries traffic, one the modem refuses would drop it silently, go back to plain AT. */
+        NETWORK_PRINT_ERROR("CMUX DLCI %d rejected, back to plain AT\r\n", dlci);
+        g_cmuxContext.stats.countOpenFailures++;
+        CmuxStop(true);
+        break;
+
+    case CMUX_CTRL_DISC:
+        channel->open = false;
+        sendFrame(dlci, false, (uint8_t)(CMUX_CTRL_UA | CMUX_PF), NULL, 0);
+        break;
+
+    case CMUX_CTRL_UIH:
+        if (CMUX_CHANNEL_CONTROL == dlci)
+        {
+            handleControlMessage(info, len);
+        }
+        else if ((NULL != channel->rxBuff) && len)
+        {
+            if (HalCbufErrOk != hal_cbuf_enqueue(channel->rxBuff, buf, len))
+            {
+                g_cmuxContext.stats.countRxOverflows += len;
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+static void handleControlMessage(const uint8_t *info, uint16_t len)
+{
+    uint8_t type = 0;
+    uint8_t valueLen = 0;
+    uint8_t dlci = 0;
+
+    if (len < 2)
+    {
+        return;
+    }
+    type = (uint8_t)(info[0] & ~(CMUX_CR | CMUX_EA));
+    valueLen = (uint8_t)(info[1] >> 1);
+    if ((uint16_t)valueLen + 2 > len)
+    {
+        return;
+    }
+
+    /* Responses to our own commands need no action. */
+    if (0 == (info[0] & CMUX_CR))
+    {
+        return;
+    }
+
+    switch (type)
+    {
+    case CMUX_MSG_MSC:
+        if (2 <= valueLen)
+        {
+            dlci = (uint8_t)(info[2] >> 2);
+            if ((0 < dlci) && (dlci < CMUX_CHANNEL_MAX))
+            {
+                g_cmuxContext.channel[dlci].flowStopped = (0 != (info[3] & CMUX_V24_FC));
+            }
+        }
+        sendControlMessage(type, false, &info[2], valueLen);
+        break;
+
+    case CMUX_MSG_TEST:
+        sendControlMessage(type, false, &info[2], valueLen);
+        break;
+
+    case CMUX_MSG_CLD:
+        sendControlMessage(type, false, NULL, 0);
+        NETWORK_PRINT_INFO("CMUX closed by modem\r\n");
+        CmuxStop(false);
+        break;
+
+    default:
+        break;
+    }
+}
@@ -0,0 +1,131 @@
+/**
+ * @file        modem_cmux.h
+ *
+ * @copyright   Accolade Electronics Pvt Ltd, 2023-24
+ *              All Rights Reserved
+ *              UNPUBLISHED, LICENSED SOFTWARE.
+ *              Accolade Electronics, Pune
+ *              CONFIDENTIAL AND PROPRIETARY INFORMATION
+ *              WHICH IS THE PROPERTY OF M/s Accolade Electronics.
+ *
+ * @date        19 October 2026
+ * @author      agent <agent@local>
+ *              Diksha J <diksha.jadhav@accoladeelectronics.com>
+ *
+ * @brief       3GPP TS 27.010 multiplexer (basic option) between the modem port and the GSM UART - headers.
+ *
+ * @details     The mux is started after the modem accepted AT+CMUX=0. It opens the control channel (DLCI 0) and
+ *              the virtual channels below with SABM/UA, then carries each channel in UIH frames. Received data
+ *              is demultiplexed into one circular buffer per channel.
+ */
+
+#ifndef MODEM_CMUX_H
+#define MODEM_CMUX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CMUX_N1                             31      /* Max information field length, 27.010 default for basic option. */
+#define CMUX_MAX_RX_INFO_LEN                256     /* Longest information field accepted from the modem. */
+
+typedef uint32_t (*fnPtrCmuxIo)(uint8_t *buff, uint32_t len);
+
+typedef enum
+{
+    CMUX_CHANNEL_CONTROL,                           /* DLCI 0, mux control, not usable for data. */
+    CMUX_CHANNEL_AT,                                /* DLCI 1, AT commands and URC. */
+    CMUX_CHANNEL_MAX
+} CmuxChannel_n;
+
+typedef enum
+{
+    CMUX_BUSY = -3,
+    CMUX_INVALID_MEMORY,
+    CMUX_FAILED,
+    CMUX_SUCCESS,
+} CmuxError_n;
+
+typedef struct
+{
+    uint32_t countRxFrames;                         /* countRxFrames is the number of valid frames received. */
+    uint32_t countTxFrames;                         /* countTxFrames is the number of frames sent. */
+    uint32_t countFcsErrors;                        /* countFcsErrors is the number of frames dropped on FCS mismatch. */
+    uint32_t countFramingErrors;                    /* countFramingErrors is the number of frames dropped on length or closing flag. */
+    uint32_t countRxOverflows;                      /* countRxOverflows is the number of bytes lost on a full channel buffer. */
+    uint32_t countOpenFailures;                     /* countOpenFailures is the number of times the mux was closed on a DLCI open failure. */
+} CmuxStats_t;
+
+/**
+ * @brief   Initializes the mux in the stopped state.
+ * @param   lowerRead   Function reading raw bytes from the UART.
+ * @param   lowerWrite  Function writing raw bytes to the UART.
+ * @return  Error code defined in CmuxError_n
+ */
+CmuxError_n CmuxInit(fnPtrCmuxIo lowerRead, fnPtrCmuxIo lowerWrite);
+
+/**
+ * @brief   Starts the mux, call once the modem answered OK to AT+CMUX=0. Channels are opened by CmuxProcess.
+ * @return  Error code defined in CmuxError_n
+ */
+CmuxError_n CmuxStart(void);
+
+/**
+ * @brief   Stops the mux and drops all channel data.
+ * @param   closeDown   true to send the close down command so the modem goes back to plain AT mode,
+ *                      false when the modem is being reset anyway.
+ */
+void CmuxStop(bool closeDown);
+
+/**
+ * @brief   Tells whether the mux is started, i.e. the UART carries frames.
+ * @return  true if started.
+ */
+bool CmuxIsActive(void);
+
+/**
+ * @brief   Tells whether a channel is open and not flow controlled by the modem.
+ * @param   channel Channel to check.
+ * @return  true if data can be written on the channel.
+ */
+bool CmuxIsChannelReady(CmuxChannel_n channel);
+
+/**
+ * @brief   Reads the UART, decodes frames and runs channel open retries. Call periodically.
+ *          A channel rejected by the modem (DM) or not opened after N2 retries closes the mux (CLD) and the
+ *          port falls back to plain AT.
+ */
+void CmuxProcess(void);
+
+/**
+ * @brief   Number of bytes waiting on a channel.
+ * @param   channel Channel to check.
+ * @return  Bytes available to read.
+ */
+uint32_t CmuxAvailable(CmuxChannel_n channel);
+
+/**
+ * @brief   Reads received data of a channel.
+ * @param   channel Channel to read.
+ * @param   buff    Output buffer.
+ * @param   maxLen  Size of the output buffer.
+ * @return  Number of bytes read.
+ */
+uint32_t CmuxRead(CmuxChannel_n channel, uint8_t *buff, uint32_t maxLen);
+
+/**
+ * @brief   Writes data on a channel, split into UIH frames of at most CMUX_N1 bytes.
+ * @param   channel Channel to write.
+ * @param   buff    Data to send.
+ * @param   len     Length of the data.
+ * @return  Number of bytes accepted, CMUX_BUSY if nothing was sent because the channel is still opening, is
+ *          flow controlled by the modem or the UART is full, other CmuxError_n codes on errors.
+ */
+int32_t CmuxWrite(CmuxChannel_n channel, const uint8_t *buff, uint32_t len);
+
+/**
+ * @brief   Reads the mux statistics.
+ * @return  Copy of the statistics.
+ */
+CmuxStats_t CmuxGetStats(void);
+
+#endif /* MODEM_CMUX_H */
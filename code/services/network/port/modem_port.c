@@ -22,16 +22,80 @@
 
 // Port includes.
 #include "modem_port.h"
+#include "modem_cmux.h"
+#include "hal_util.h"
 #include "Config_PORT.h"    // FIXME: replace with hal_gpio
 #include "tcu_board.h"
 
+static uint32_t uartRead(uint8_t *rxBuff, uint32_t maxBuffSize);
+static uint32_t uartWrite(uint8_t *txBuff, uint32_t txLen);
+
+static OsalThread_t g_timerThread;
+static uint32_t g_timerEvents;
+
 void ModemInit()
 {
     ModemPwrKeyHigh();
     ModemRstKeyHigh();
+    CmuxInit(uartRead, uartWrite);
  }
 
+void ModemCmuxStart(void)
+{
+#ifdef CMUX_EN
+    CmuxStart();
+#endif
+}
+
+void ModemCmuxStop(bool closeDown)
+{
+    CmuxStop(closeDown);
+}
+
 uint32_t ModemRead(uint8_t *rxBuff, uint32_t maxBuffSize)
+{
+    if (CmuxIsActive())
+    {
+        return CmuxRead(CMUX_CHANNEL_AT, rxBuff, maxBuffSize);
+    }
+    return uartRead(rxBuff, maxBuffSize);
+}
+
+int32_t ModemWrite(uint8_t *txBuff, uint32_t txLen)
+{
+    int32_t written = 0;
+
+    if (CmuxIsActive())
+    {
+        written = CmuxWrite(CMUX_CHANNEL_AT, txBuff, txLen);
+        if (CMUX_BUSY == written)
+        {
+            return MODEM_BUSY;
+        }
+        return (0 > written) ? 0 : written;
+    }
+    return (int32_t)uartWrite(txBuff, txLen);
+}
+
+uint32_t ModemDataReady(void)
+{
+    uint32_t readByte = 1;
+
+    if (CmuxIsActive())
+    {
+        CmuxProcess();
+        return (0 < CmuxAvailable(CMUX_CHANNEL_AT)) ? 1 : 0;
+    }
+
+    if (HalUartErrOk == hal_uart_receive_available(g_UartGsm, (size_t *)&readByte) && (0 < readByte))
+    {
+        return 1;
+    }
+
+    return 0;
+}
+
+static uint32_t uartRead(uint8_t *rxBuff, uint32_t maxBuffSize)
 {
     size_t readByte = 0;
     HalBuffer_t buf = {rxBuff, maxBuffSize};
@@ -52,7 +116,7 @@ uint32_t ModemRead(uint8_t *rxBuff, uint32_t maxBuffSize)
     return 0;
 }
 
-uint32_t ModemWrite(uint8_t *txBuff, uint32_t txLen)
+static uint32_t uartWrite(uint8_t *txBuff, uint32_t txLen)
 {
     size_t writeByte = 0;
     HalBuffer_t buf = {txBuff, txLen};
@@ -73,16 +137,33 @@ uint32_t ModemWrite(uint8_t *txBuff, uint32_t txLen)
     return 0;
 }
 
-uint32_t ModemDataReady(void)
+void ModemTimerInit(OsalThread_t thread, uint32_t events)
 {
-    uint32_t readByte = 1;
-    
-    if (HalUartErrOk == hal_uart_receive_available(g_UartGsm, (size_t *)&readByte) && (0 < readByte))
+    g_timerThread = thread;
+    g_timerEvents = events;
+}
+
+void ModemTimerCreate(ModemTimer_t *timer)
+{
+    OsalTimerConfig_t config = { 0, NULL, g_timerThread, g_timerEvents };
+
+    if (NULL == *timer)
     {
-        return 1;
+        hal_util_assert ( OsalErrOk == osal_timer_create(timer, &config) );
     }
+}
 
-    return 0;
+void ModemTimerStart(ModemTimer_t timer, uint32_t timeoutMs)
+{
+    hal_util_assert ( OsalErrOk == osal_timer_start(timer, timeoutMs) );
+}
+
+bool ModemTimerExpired(ModemTimer_t timer)
+{
+    bool expired = false;
+
+    hal_util_assert ( OsalErrOk == osal_timer_expired(timer, &expired) );
+    return expired;
 }
 
 void ModemPwrKeyHigh(void)
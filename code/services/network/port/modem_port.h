@@ -23,17 +23,22 @@
 #ifndef MODEM_PORT_H
 #define MODEM_PORT_H
 
+#include <stdbool.h>
 #include "net_log.h"
 #include "osal.h"
+#include "osal_timer.h"
 
 #define INFO_EN
 #define DEBUG_EN
 #define TRACE_EN
+//#define CMUX_EN                           // AT traffic over a 27.010 mux channel once AT+CMUX=0 is accepted.
+#define MODEM_BUSY                          ( -1 )  // ModemWrite sent nothing, the AT channel is not ready yet.
 
 // FIXME: This is not network functionality, move to proper library (also semantics require review).
 extern uint32_t g_var_sys;
-#define IS_TIMER_ELAPSED(tmr)               ( ( g_var_sys ) > ( tmr ) )
-#define RESET_TIMER(tmr, time)              ( ( tmr ) = ( ( g_var_sys ) + ( time ) ) )
+
+// State machine timeouts, one-shot OSAL timers whose expiry wakes the thread given to ModemTimerInit.
+typedef OsalTimer_t ModemTimer_t;
 
 #ifdef INFO_EN
 #define NETWORK_PRINT_INFO(...)             net_log(##__VA_ARGS__)
@@ -69,15 +74,53 @@ uint32_t ModemRead(uint8_t *rxBuff, uint32_t maxbuffsize);
  * @brief Writes characters to the GSM port.
  * @param txBuff Pointer to the buffer containing characters to be transmitted.
  * @param txLen Number of characters to transmit.
- * 
+ * @return Number of characters sent, MODEM_BUSY if the mux channel is opening or flow controlled, write again later.
  */
-uint32_t ModemWrite(uint8_t *txBuff, uint32_t txLen);
+int32_t ModemWrite(uint8_t *txBuff, uint32_t txLen);
 
 /**
  * @brief Checks if data is ready to be read from the GSM port.
  */
 uint32_t ModemDataReady();
 
+/**
+ * @brief Switches the modem port to multiplexed mode, call after the modem accepted AT+CMUX=0.
+ *        ModemRead/ModemWrite then carry the AT channel.
+ */
+void ModemCmuxStart(void);
+
+/**
+ * @brief Switches the modem port back to the plain UART.
+ * @param closeDown true to ask the modem to leave mux mode, false when the modem is being reset.
+ */
+void ModemCmuxStop(bool closeDown);
+
+/**
+ * @brief Sets the thread woken when a modem timer expires, call before the network modules are initialized.
+ * @param thread Thread running the network modules.
+ * @param events Events set on the thread on expiry.
+ */
+void ModemTimerInit(OsalThread_t thread, uint32_t events);
+
+/**
+ * @brief Creates a stopped timer, nothing is done if the timer exists already.
+ * @param timer Timer handle, NULL before the first call.
+ */
+void ModemTimerCreate(ModemTimer_t *timer);
+
+/**
+ * @brief Starts or restarts a timer.
+ * @param timer Timer created with ModemTimerCreate.
+ * @param timeoutMs Time to expiry.
+ */
+void ModemTimerStart(ModemTimer_t timer, uint32_t timeoutMs);
+
+/**
+ * @brief Tells whether a timer expired since it was last started, a timer never started has not expired.
+ * @param timer Timer created with ModemTimerCreate.
+ */
+bool ModemTimerExpired(ModemTimer_t timer);
+
 /**
  * @brief Sets the power key (P9_1) of EC200 to a high state.
  */
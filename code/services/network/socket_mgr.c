@@ -0,0 +1,652 @@
+/**
+ * @file        socket_mgr.c
+ *
+ * @copyright   Accolade Electronics Pvt Ltd, 2023-24
+ *              All Rights Reserved
+ *              UNPUBLISHED, LICENSED SOFTWARE.
+ *              Accolade Electronics, Pune
+ *              CONFIDENTIAL AND PROPRIETARY INFORMATION
+ *              WHICH IS THE PROPERTY OF M/s Accolade Electronics.
+ *
+ * @date        19 October 2026
+ * @author      agent <agent@local>
+ *              Diksha J <diksha.jadhav@accoladeelectronics.com>
+ *
+ * @brief       Socket manager code, raw TCP/UDP sockets over AT+QIOPEN/QISEND/QIRD.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include "socket_mgr.h"
+#include "connection_mgr.h"
+#include "at_command_handler.h"
+#include "modem_port.h"
+#include "net_utility.h"
+#include "hal_cbuf.h"
+
+#define SOCKET_MGR_CONTEXT_ID               1                   // PDP context activated by the connection manager.
+#define SOCKET_MGR_OPEN_TIMEOUT_MS          (150 * 1000)        // Max wait for +QIOPEN after the command is accepted.
+#define SOCKET_MGR_TX_QUEUE_SIZE            (4 * 1024)
+#define SOCKET_MGR_RX_QUEUE_SIZE            (4 * 1024)
+#define SOCKET_MGR_MAX_SEND_RETRY           3                   // Failed sends of one chunk before the socket is closed.
+
+typedef struct
+{
+    SocketMgrState_n state;
+    SocketMgrProtocol_n protocol;
+    char host[SOCKET_MGR_MAX_HOST_LEN];
+    uint16_t port;
+    bool openRequested;                     /* openRequested is set by SocketMgrOpen until the open is tried. */
+    bool rxPending;                         /* rxPending is set when the modem has data buffered for this socket. */
+    ModemTimer_t timer;                     /* timer is used for the +QIOPEN wait. */
+    uint16_t txChunkLen;                    /* txChunkLen is the length of the chunk being sent, kept until SEND OK. */
+    uint8_t txRetryCount;                   /* txRetryCount is the number of failed sends of the current chunk. */
+    uint8_t txChunk[SOCKET_MGR_MAX_SEND_LEN];
+    volatile HalCbuf_t *txQueue;
+    volatile HalCbuf_t *rxQueue;
+    SocketMgrStats_t stats;
+} SocketMgrSocket_t;
+
+typedef struct
+{
+    AtClientId_t atClient;                  /* atClient is the AT executor client of the socket manager. */
+    uint8_t activeSocket;                   /* activeSocket is the socket the running AT table works on. */
+    uint8_t nextSocket;                     /* nextSocket is where the next scheduling round starts. */
+    uint16_t readRequestLen;                /* readRequestLen is the length asked with the running QIRD. */
+    uint16_t readLen;                       /* readLen is the length returned by the running QIRD. */
+    SocketMgrSocket_t socket[SOCKET_MGR_MAX_SOCKETS];
+} SocketMgrContext_t;
+
+typedef enum
+{
+    SOCK_OPEN_OPEN,
+    SOCK_OPEN_MAX_CMD
+} SockOpenCmd_n;
+
+typedef enum
+{
+    SOCK_CLOSE_CLOSE,
+    SOCK_CLOSE_MAX_CMD
+} SockCloseCmd_n;
+
+typedef enum
+{
+    SOCK_SEND_SEND,
+    SOCK_SEND_DATA,
+    SOCK_SEND_MAX_CMD
+} SockSendCmd_n;
+
+typedef enum
+{
+    SOCK_READ_READ,
+    SOCK_READ_MAX_CMD
+} SockReadCmd_n;
+
+const AtCommands_t g_sockOpenTable[SOCK_OPEN_MAX_CMD] =
+{
+    /* COMMAND     SUCCESS_RSP  ERROR_RSP   OTHRRSP      NTFN FLG TMOUT    MAXRTRYCNT   MAXNTFNRTRYCNT  STOPONERROR   WAITTIMER */
+    {"+QIOPEN=",   "OK",        "ERROR",    "\0",        0,       3000,    1,           0,              1,            10},
+};
+
+const AtCommands_t g_sockCloseTable[SOCK_CLOSE_MAX_CMD] =
+{
+    /* COMMAND     SUCCESS_RSP  ERROR_RSP   OTHRRSP      NTFN FLG TMOUT    MAXRTRYCNT   MAXNTFNRTRYCNT  STOPONERROR   WAITTIMER */
+    {"+QICLOSE=",  "OK",        "ERROR",    "\0",        0,       11000,   1,           0,              0,            10},
+};
+
+const AtCommands_t g_sockSendTable[SOCK_SEND_MAX_CMD] =
+{
+    /* COMMAND     SUCCESS_RSP  ERROR_RSP   OTHRRSP      NTFN FLG TMOUT    MAXRTRYCNT   MAXNTFNRTRYCNT  STOPONERROR   WAITTIMER */
+    {"+QISEND=",   ">",         "ERROR",    "\0",        0,       5000,    1,           0,              1,            0},
+    {"",           "SEND OK",   "SEND FAIL", "\0",      0,       10000,   1,           0,              1,            10},
+};
+
+const AtCommands_t g_sockReadTable[SOCK_READ_MAX_CMD] =
+{
+    /* COMMAND     SUCCESS_RSP  ERROR_RSP   OTHRRSP      NTFN FLG TMOUT    MAXRTRYCNT   MAXNTFNRTRYCNT  STOPONERROR   WAITTIMER */
+    {"+QIRD=",     "OK",        "ERROR",    "\0",        0,       3000,    1,           0,              1,            10},
+};
+
+/**
+ * @brief   The group of functions fill, store and call back is helping function for socket tables.
+ */
+static uint16_t fillSocketCommand(uint8_t *buffer, int16_t offset, const AtCommands_t *aTCmdTble, int8_t commandIdx);
+/**
+ * @brief   The group of functions fill, store and call back is helping function for socket tables.
+ */
+static int8_t storeSocketResponse(const AtCommands_t *cmdTbl, uint8_t commandIdx, uint32_t bufferLen, uint8_t *buffer, int8_t status);
+/**
+ * @brief   Call back of the open table.
+ */
+static int16_t openCallBack(uint8_t commandIdx, uint8_t status, uint32_t bufferLen, void *buffer);
+/**
+ * @brief   Call back of the close table.
+ */
+static int16_t closeCallBack(uint8_t commandIdx, uint8_t status, uint32_t bufferLen, void *buffer);
+/**
+ * @brief   Call back of the send table.
+ */
+static int16_t sendCallBack(uint8_t commandIdx, uint8_t status, uint32_t bufferLen, void *buffer);
+/**
+ * @brief   Call back of the read table.
+ */
+static int16_t readCallBack(uint8_t commandIdx, uint8_t status, uint32_t bufferLen, void *buffer);
+
+/**
+ * @brief   Handle the +QIOPEN URC, result of the socket open. This is call back function.
+ */
+static uint16_t openUrcParser(uint8_t *buffer, uint16_t len, uint8_t *outBuff, uint16_t *outLen);
+/**
+ * @brief   Handle the recv URC, modem has data for a socket. This is call back function.
+ */
+static uint16_t recvUrcParser(uint8_t *buffer, uint16_t len, uint8_t *outBuff, uint16_t *outLen);
+/**
+ * @brief   Handle the closed URC, remote closed a socket. This is call back function.
+ */
+static uint16_t closedUrcParser(uint8_t *buffer, uint16_t len, uint8_t *outBuff, uint16_t *outLen);
+/**
+ * @brief   Handle the +QIRD response, copies the binary payload to the receive queue. This is call back function.
+ */
+static void readRawHandler(const uint8_t *data, uint16_t len);
+
+/**
+ * @brief   Parse the connect id of a "+QIURC: "<event>",<id>" or "+QIOPEN: <id>,<err>" line.
+ * @return  End of the URC line, NULL if the line is not complete.
+ */
+static char *parseUrcSocket(char *start, const char *urcString, int *socketId, int *result);
+/**
+ * @brief   Start the next AT table needed by a socket.
+ * @return  true if a table was started.
+ */
+static bool scheduleSocket(uint8_t socketIdx);
+/**
+ * @brief   Return a socket to closed and drop its queues.
+ */
+static void resetSocket(SocketMgrSocket_t *socket);
+/**
+ * @brief   Copy received payload to the receive queue of a socket.
+ */
+static void queueReceived(SocketMgrSocket_t *socket, const uint8_t *data, uint16_t len);
+
+static uint8_t g_sockTxMem[SOCKET_MGR_MAX_SOCKETS][SOCKET_MGR_TX_QUEUE_SIZE];
+static uint8_t g_sockRxMem[SOCKET_MGR_MAX_SOCKETS][SOCKET_MGR_RX_QUEUE_SIZE];
+static volatile HalCbuf_t g_sockTxQueue[SOCKET_MGR_MAX_SOCKETS] =
+{
+    { .mem = g_sockTxMem[0], .sizeMem = SOCKET_MGR_TX_QUEUE_SIZE },
+    { .mem = g_sockTxMem[1], .sizeMem = SOCKET_MGR_TX_QUEUE_SIZE },
+};
+static volatile HalCbuf_t g_sockRxQueue[SOCKET_MGR_MAX_SOCKETS] =
+{
+    { .mem = g_sockRxMem[0], .sizeMem = SOCKET_MGR_RX_QUEUE_SIZE },
+    { .mem = g_sockRxMem[1], .sizeMem = SOCKET_MGR_RX_QUEUE_SIZE },
+};
+static ModemTimer_t g_sockTimer[SOCKET_MGR_MAX_SOCKETS];
+
+SocketMgrContext_t g_socketMgrContext;
+
+UrcTable_t g_socketMgrUrcTable[] =
+{
+    {"+QIOPEN: ",           &openUrcParser},    // Result of AT+QIOPEN
+    {"+QIURC: \"recv\"",    &recvUrcParser},    // Data buffered in the modem
+    {"+QIURC: \"closed\"",  &closedUrcParser},  // Socket closed by remote
+};
+
+SocketMgrErrorCode_n SocketMgrInit(void)
+{
+    uint8_t iterator = 0;
+
+    memset((void *)&g_socketMgrContext, 0x00, sizeof(g_socketMgrContext));
+    for (iterator = 0; iterator < SOCKET_MGR_MAX_SOCKETS; iterator++)
+    {
+        g_socketMgrContext.socket[iterator].txQueue = &g_sockTxQueue[iterator];
+        g_socketMgrContext.socket[iterator].rxQueue = &g_sockRxQueue[iterator];
+        ModemTimerCreate(&g_sockTimer[iterator]);
+        g_socketMgrContext.socket[iterator].timer = g_sockTimer[iterator];
+        resetSocket(&g_socketMgrContext.socket[iterator]);
+    }
+    AtRegisterUrc(g_socketMgrUrcTable, sizeof(g_socketMgrUrcTable) / sizeof(g_socketMgrUrcTable[0]));
+    AtRegisterRawUrc("+QIRD: ", readRawHandler);
+    g_socketMgrContext.atClient = AtRegisterClient("socket");
+    return SOCKET_MGR_SUCCESS;
+}
+
+SocketMgrErrorCode_n SocketMgrExe(void)
+{
+    uint8_t iterator = 0;
+    uint8_t socketIdx = 0;
+
+    /* One table at a time, the AT executor interleaves it with the other clients. */
+    if (AtIsClientBusy(g_socketMgrContext.atClient))
+    {
+        return SOCKET_MGR_SUCCESS;
+    }
+
+    for (iterator = 0; iterator < SOCKET_MGR_MAX_SOCKETS; iterator++)
+    {
+        socketIdx = (g_socketMgrContext.nextSocket + iterator) % SOCKET_MGR_MAX_SOCKETS;
+        if (scheduleSocket(socketIdx))
+        {
+            g_socketMgrContext.nextSocket = (socketIdx + 1) % SOCKET_MGR_MAX_SOCKETS;
+            break;
+        }
+    }
+    return SOCKET_MGR_SUCCESS;
+}
+
+SocketMgrErrorCode_n SocketMgrOpen(uint8_t socket, SocketMgrProtocol_n protocol, const char *host, uint16_t port)
+{
+    SocketMgrSocket_t *sock = NULL;
+
+    if ((socket >= SOCKET_MGR_MAX_SOCKETS) || (NULL == host) || (strlen(host) >= SOCKET_MGR_MAX_HOST_LEN))
+    {
+        return SOCKET_MGR_INVALID_MEMORY;
+    }
+    sock = &g_socketMgrContext.socket[socket];
+    if ((SOCKET_MGR_STATE_CLOSED != sock->state) || sock->openRequested)
+    {
+        return SOCKET_MGR_ERROR;
+    }
+
+    resetSocket(sock);
+    sock->protocol = protocol;
+    sock->port = port;
+    strcpy(sock->host, host);
+    sock->openRequested = true;
+    return SOCKET_MGR_SUCCESS;
+}
+
+SocketMgrErrorCode_n SocketMgrClose(uint8_t socket)
+{
+    SocketMgrSocket_t *sock = NULL;
+
+    if (socket >= SOCKET_MGR_MAX_SOCKETS)
+    {
+        return SOCKET_MGR_INVALID_MEMORY;
+    }
+    sock = &g_socketMgrContext.socket[socket];
+    sock->openRequested = false;
+    if (SOCKET_MGR_STATE_CLOSED != sock->state)
+    {
+        sock->state = SOCKET_MGR_STATE_CLOSING;
+    }
+    return SOCKET_MGR_SUCCESS;
+}
+
+uint32_t SocketMgrSend(uint8_t socket, const uint8_t *data, uint32_t len)
+{
+    SocketMgrSocket_t *sock = NULL;
+    HalBuffer_t buf = {(uint8_t *)data, len};
+    size_t available = 0;
+
+    if ((socket >= SOCKET_MGR_MAX_SOCKETS) || (NULL == data) || (0 == len))
+    {
+        return 0;
+    }
+    sock = &g_socketMgrContext.socket[socket];
+    if (SOCKET_MGR_STATE_OPEN != sock->state)
+    {
+        return 0;
+    }
+
+    hal_cbuf_available_write(sock->txQueue, &available);
+    if (len > available)
+    {
+        len = (uint32_t)available;
+    }
+    if ((0 == len) || (HalCbufErrOk != hal_cbuf_enqueue(sock->txQueue, buf, len)))
+    {
+        return 0;
+    }
+    return len;
+}
+
+uint32_t SocketMgrReceive(uint8_t socket, uint8_t *data, uint32_t maxLen)
+{
+    SocketMgrSocket_t *sock = NULL;
+    HalBuffer_t buf = {data, maxLen};
+    size_t available = 0;
+
+    if ((socket >= SOCKET_MGR_MAX_SOCKETS) || (NULL == data) || (0 == maxLen))
+    {
+        return 0;
+    }
+    sock = &g_socketMgrContext.socket[socket];
+
+    hal_cbuf_available_read(sock->rxQueue, &available);
+    if (available > maxLen)
+    {
+        available = maxLen;
+    }
+    if ((0 == available) || (HalCbufErrOk != hal_cbuf_dequeue(sock->rxQueue, buf, available)))
+    {
+        return 0;
+    }
+    return (uint32_t)available;
+}
+
+SocketMgrState_n SocketMgrGetState(uint8_t socket)
+{
+    if (socket >= SOCKET_MGR_MAX_SOCKETS)
+    {
+        return SOCKET_MGR_STATE_CLOSED;
+    }
+    return g_socketMgrContext.socket[socket].state;
+}
+
+SocketMgrErrorCode_n SocketMgrGetStats(uint8_t socket, SocketMgrStats_t *stats)
+{
+    if ((socket >= SOCKET_MGR_MAX_SOCKETS) || (NULL == stats))
+    {
+        return SOCKET_MGR_INVALID_MEMORY;
+    }
+    *stats = g_socketMgrContext.socket[socket].stats;
+    return SOCKET_MGR_SUCCESS;
+}
+
+static bool scheduleSocket(uint8_t socketIdx)
+{
+    SocketMgrSocket_t *sock = &g_socketMgrContext.socket[socketIdx];
+    AtError_n atErrorResp = AT_FAILED;
+    HalBuffer_t buf = {sock->txChunk, sizeof(sock->txChunk)};
+    size_t available = 0;
+
+    g_socketMgrContext.activeSocket = socketIdx;
+
+    switch (sock->state)
+    {
+    case SOCKET_MGR_STATE_CLOSED:
+        if (!sock->openRequested || !ConnectionMgrIsNetAvailable())
+        {
+            break;
+        }
+        atErrorResp = AtStartClient(g_socketMgrContext.atClient, AT_PRIORITY_NORMAL, g_sockOpenTable, (uint8_t)SOCK_OPEN_MAX_CMD,
+                                    fillSocketCommand, storeSocketResponse, openCallBack);
+        if (AT_SUCCESS == atErrorResp)
+        {
+            sock->openRequested = false;
+            sock->state = SOCKET_MGR_STATE_OPENING;
+            ModemTimerStart(sock->timer, SOCKET_MGR_OPEN_TIMEOUT_MS);
+            return true;
+        }
+        break;
+
+    case SOCKET_MGR_STATE_OPENING:
+        if (ModemTimerExpired(sock->timer))
+        {
+            NETWORK_PRINT_ERROR("socket %d open timeout\r\n", socketIdx);
+            sock->state = SOCKET_MGR_STATE_CLOSING;
+        }
+        break;
+
+    case SOCKET_MGR_STATE_CLOSING:
+        atErrorResp = AtStartClient(g_socketMgrContext.atClient, AT_PRIORITY_NORMAL, g_sockCloseTable, (uint8_t)SOCK_CLOSE_MAX_CMD,
+                                    fillSocketCommand, storeSocketResponse, closeCallBack);
+        return (AT_SUCCESS == atErrorResp);
+
+    case SOCKET_MGR_STATE_OPEN:
+        /* Pull received data first, only as much as the receive queue can take. */
+        hal_cbuf_available_write(sock->rxQueue, &available);
+        if (sock->rxPending && (0 < available))
+        {
+            g_socketMgrContext.readRequestLen = (available > SOCKET_MGR_MAX_READ_LEN) ? SOCKET_MGR_MAX_READ_LEN : (uint16_t)available;
+            g_socketMgrContext.readLen = 0;
+            atErrorResp = AtStartClient(g_socketMgrContext.atClient, AT_PRIORITY_NORMAL, g_sockReadTable, (uint8_t)SOCK_READ_MAX_CMD,
+                                        fillSocketCommand, storeSocketResponse, readCallBack);
+            return (AT_SUCCESS == atErrorResp);
+        }
+
+        /* Chunk is kept until SEND OK so a failed send is repeated with the same data. */
+        if (0 == sock->txChunkLen)
+        {
+            hal_cbuf_available_read(sock->txQueue, &available);
+            if (available > sizeof(sock->txChunk))
+            {
+                available = sizeof(sock->txChunk);
+            }
+            if ((0 < available) && (HalCbufErrOk == hal_cbuf_dequeue(sock->txQueue, buf, available)))
+            {
+                sock->txChunkLen = (uint16_t)available;
+            }
+        }
+        if (0 < sock->txChunkLen)
+        {
+            atErrorResp = AtStartClient(g_socketMgrContext.atClient, AT_PRIORITY_NORMAL, g_sockSendTable, (uint8_t)SOCK_SEND_MAX_CMD,
+                                        fillSocketCommand, storeSocketResponse, sendCallBack);
+            return (AT_SUCCESS == atErrorResp);
+        }
+        break;
+
+    default:
+        break;
+    }
+    return false;
+}
+
+static void resetSocket(SocketMgrSocket_t *socket)
+{
+    socket->state = SOCKET_MGR_STATE_CLOSED;
+    socket->rxPending = false;
+    socket->txChunkLen = 0;
+    socket->txRetryCount = 0;
+    hal_cbuf_init(socket->txQueue);
+    hal_cbuf_init(socket->rxQueue);
+}
+
+static void queueReceived(SocketMgrSocket_t *socket, const uint8_t *data, uint16_t len)
+{
+    HalBuffer_t buf = {(uint8_t *)data, len};
+
+    if (HalCbufErrOk != hal_cbuf_enqueue(socket->rxQueue, buf, len))
+    {
+        socket->stats.countRxOverflow += len;
+    }
+    else
+    {
+        socket->stats.bytesReceived += len;
+    }
+}
+
+static uint16_t fillSocketCommand(uint8_t *buffer, int16_t offset, const AtCommands_t *aTCmdTble, int8_t commandIdx)
+{
+    int32_t length = 0;
+    char *bufferPtr = (char *)&buffer[offset];
+    uint8_t socketIdx = g_socketMgrContext.activeSocket;
+    SocketMgrSocket_t *sock = &g_socketMgrContext.socket[socketIdx];
+
+    if (aTCmdTble == &g_sockSendTable[SOCK_SEND_DATA])
+    {
+        /* Raw payload after the prompt, no AT prefix and no line ending. */
+        memcpy(bufferPtr, sock->txChunk, sock->txChunkLen);
+        return sock->txChunkLen;
+    }
+
+    length += sprintf(&bufferPtr[length], "AT%s", aTCmdTble->command);
+    if (aTCmdTble == &g_sockOpenTable[SOCK_OPEN_OPEN])
+    {
+        /* Access mode 0, buffer mode. */
+        length += sprintf(&bufferPtr[length], "%d,%d,\"%s\",\"%s\",%u,0,0", SOCKET_MGR_CONTEXT_ID, socketIdx,
+                          (SOCKET_MGR_UDP == sock->protocol) ? "UDP" : "TCP", sock->host, sock->port);
+    }
+    else if (aTCmdTble == &g_sockCloseTable[SOCK_CLOSE_CLOSE])
+    {
+        length += sprintf(&bufferPtr[length], "%d,10", socketIdx);
+    }
+    else if (aTCmdTble == &g_sockSendTable[SOCK_SEND_SEND])
+    {
+        length += sprintf(&bufferPtr[length], "%d,%u", socketIdx, sock->txChunkLen);
+    }
+    else if (aTCmdTble == &g_sockReadTable[SOCK_READ_READ])
+    {
+        length += sprintf(&bufferPtr[length], "%d,%u", socketIdx, g_socketMgrContext.readRequestLen);
+    }
+    length += sprintf(&bufferPtr[length], "\r\n");
+    return length;
+}
+
+static int8_t storeSocketResponse(const AtCommands_t *cmdTbl, uint8_t commandIdx, uint32_t bufferLen, uint8_t *buffer, int8_t status)
+{
+    return 0;
+}
+
+static int16_t openCallBack(uint8_t commandIdx, uint8_t status, uint32_t bufferLen, void *buffer)
+{
+    SocketMgrSocket_t *sock = &g_socketMgrContext.socket[g_socketMgrContext.activeSocket];
+
+    /* Command refused, no +QIOPEN will follow. */
+    if ((AT_CB_ALL_CMD_OVR != status) && (SOCKET_MGR_STATE_OPENING == sock->state))
+    {
+        NETWORK_PRINT_ERROR("socket %d open refused\r\n", g_socketMgrContext.activeSocket);
+        sock->state = SOCKET_MGR_STATE_CLOSED;
+    }
+    return 0;
+}
+
+static int16_t closeCallBack(uint8_t commandIdx, uint8_t status, uint32_t bufferLen, void *buffer)
+{
+    if (AT_CB_ALL_CMD_OVR == status)
+    {
+        resetSocket(&g_socketMgrContext.socket[g_socketMgrContext.activeSocket]);
+        NETWORK_PRINT_DEBUG("socket %d closed\r\n", g_socketMgrContext.activeSocket);
+    }
+    return 0;
+}
+
+static int16_t sendCallBack(uint8_t commandIdx, uint8_t status, uint32_t bufferLen, void *buffer)
+{
+    SocketMgrSocket_t *sock = &g_socketMgrContext.socket[g_socketMgrContext.activeSocket];
+
+    if (AT_CB_ALL_CMD_OVR == status)
+    {
+        sock->stats.bytesSent += sock->txChunkLen;
+        sock->txChunkLen = 0;
+        sock->txRetryCount = 0;
+    }
+    else
+    {
+        sock->stats.countSendFail++;
+        /* The link or the peer is gone, stop repeating the chunk and let the user reopen. */
+        if ((++sock->txRetryCount >= SOCKET_MGR_MAX_SEND_RETRY) && (SOCKET_MGR_STATE_OPEN == sock->state))
+        {
+            NETWORK_PRINT_ERROR("socket %d send failed %d times\r\n", g_socketMgrContext.activeSocket, sock->txRetryCount);
+            sock->txChunkLen = 0;
+            sock->txRetryCount = 0;
+            sock->state = SOCKET_MGR_STATE_CLOSING;
+        }
+    }
+    return 0;
+}
+
+static int16_t readCallBack(uint8_t commandIdx, uint8_t status, uint32_t bufferLen, void *buffer)
+{
+    SocketMgrSocket_t *sock = &g_socketMgrContext.socket[g_socketMgrContext.activeSocket];
+
+    /* A short read means the modem buffer is empty, a full one means there may be more. */
+    if ((AT_CB_ALL_CMD_OVR == status) && (g_socketMgrContext.readLen < g_socketMgrContext.readRequestLen))
+    {
+        sock->rxPending = false;
+    }
+    return 0;
+}
+
+static char *parseUrcSocket(char *start, const char *urcString, int *socketId, int *result)
+{
+    char *workingPtr = start + strlen(urcString);
+    char *endPtr = strstr(workingPtr, "\r\n");
+
+    if (NULL == endPtr)
+    {
+        return NULL;
+    }
+    if (',' == *workingPtr)
+    {
+        workingPtr++;
+    }
+    *socketId = atoi(workingPtr);
+    if ((NULL != result) && (NULL != (workingPtr = strchr(workingPtr, ','))) && (workingPtr < endPtr))
+    {
+        *result = atoi(workingPtr + 1);
+    }
+    return endPtr + 2;
+}
+
+uint16_t openUrcParser(uint8_t *buffer, uint16_t len, uint8_t *outBuff, uint16_t *outLen)
+{
+    char *startPtr = NULL;
+    char *endPtr = NULL;
+    const char *urcString = "+QIOPEN: ";
+    int socketId = -1;
+    int result = -1;
+
+    if (NULL != (startPtr = strstr((char *)buffer, urcString))) /* +QIOPEN: 0,0 */
+    {
+        if (NULL == (endPtr = parseUrcSocket(startPtr, urcString, &socketId, &result)))
+        {
+            endPtr = startPtr + strlen(urcString);
+        }
+        else if ((0 <= socketId) && (socketId < SOCKET_MGR_MAX_SOCKETS) &&
+                 (SOCKET_MGR_STATE_OPENING == g_socketMgrContext.socket[socketId].state))
+        {
+            /* A failed open still holds the connect id, it is freed with QICLOSE. */
+            g_socketMgrContext.socket[socketId].state = (0 == result) ? SOCKET_MGR_STATE_OPEN : SOCKET_MGR_STATE_CLOSING;
+            NETWORK_PRINT_INFO("socket %d open result %d\r\n", socketId, result);
+        }
+        return CalculateUrcParseLen((char *)buffer, startPtr, endPtr, (char *)outBuff, outLen, len);
+    }
+    return 0;
+}
+
+uint16_t recvUrcParser(uint8_t *buffer, uint16_t len, uint8_t *outBuff, uint16_t *outLen)
+{
+    char *startPtr = NULL;
+    char *endPtr = NULL;
+    const char *urcString = "+QIURC: \"recv\"";
+    int socketId = -1;
+
+    if (NULL != (startPtr = strstr((char *)buffer, urcString))) /* +QIURC: "recv",0 */
+    {
+        if (NULL == (endPtr = parseUrcSocket(startPtr, urcString, &socketId, NULL)))
+        {
+            endPtr = startPtr + strlen(urcString);
+        }
+        else if ((0 <= socketId) && (socketId < SOCKET_MGR_MAX_SOCKETS))
+        {
+            g_socketMgrContext.socket[socketId].rxPending = true;
+        }
+        return CalculateUrcParseLen((char *)buffer, startPtr, endPtr, (char *)outBuff, outLen, len);
+    }
+    return 0;
+}
+
+uint16_t closedUrcParser(uint8_t *buffer, uint16_t len, uint8_t *outBuff, uint16_t *outLen)
+{
+    char *startPtr = NULL;
+    char *endPtr = NULL;
+    const char *urcString = "+QIURC: \"closed\"";
+    int socketId = -1;
+
+    if (NULL != (startPtr = strstr((char *)buffer, urcString))) /* +QIURC: "closed",0 */
+    {
+        if (NULL == (endPtr = parseUrcSocket(startPtr, urcString, &socketId, NULL)))
+        {
+            endPtr = startPtr + strlen(urcString);
+        }
+        else if ((0 <= socketId) && (socketId < SOCKET_MGR_MAX_SOCKETS) &&
+                 (SOCKET_MGR_STATE_CLOSED != g_socketMgrContext.socket[socketId].state))
+        {
+            NETWORK_PRINT_INFO("socket %d closed by remote\r\n", socketId);
+            g_socketMgrContext.socket[socketId].state = SOCKET_MGR_STATE_CLOSING;
+        }
+        return CalculateUrcParseLen((char *)buffer, startPtr, endPtr, (char *)outBuff, outLen, len);
+    }
+    return 0;
+}
+
+void readRawHandler(const uint8_t *data, uint16_t len) /* +QIRD: 5\r\nhello */
+{
+    /* The AT reader counted the payload by its length, it is binary safe and always complete here. */
+    if (0 < len)
+    {
+        queueReceived(&g_socketMgrContext.socket[g_socketMgrContext.activeSocket], data, len);
+    }
+    g_socketMgrContext.readLen = len;
+}
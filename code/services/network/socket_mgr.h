@@ -0,0 +1,125 @@
+/**
+ * @file        socket_mgr.h
+ *
+ * @copyright   Accolade Electronics Pvt Ltd, 2023-24
+ *              All Rights Reserved
+ *              UNPUBLISHED, LICENSED SOFTWARE.
+ *              Accolade Electronics, Pune
+ *              CONFIDENTIAL AND PROPRIETARY INFORMATION
+ *              WHICH IS THE PROPERTY OF M/s Accolade Electronics.
+ *
+ * @date        19 October 2026
+ * @author      agent <agent@local>
+ *              Diksha J <diksha.jadhav@accoladeelectronics.com>
+ *
+ * @brief       Socket manager headers, raw TCP/UDP sockets of the EC200 in buffer access mode.
+ *
+ * @details     Data written with SocketMgrSend is queued and sent in chunks of up to SOCKET_MGR_MAX_SEND_LEN
+ *              with AT+QISEND. Received data is pulled with AT+QIRD as soon as the modem reports it and
+ *              queued for SocketMgrReceive.
+ */
+
+#ifndef SOCKET_MGR_H
+#define SOCKET_MGR_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SOCKET_MGR_MAX_SOCKETS              2
+#define SOCKET_MGR_MAX_HOST_LEN             64
+#define SOCKET_MGR_MAX_SEND_LEN             1460    /* Max length of one AT+QISEND. */
+#define SOCKET_MGR_MAX_READ_LEN             1500    /* Max length of one AT+QIRD. */
+
+typedef enum
+{
+    SOCKET_MGR_INVALID_MEMORY = -2,
+    SOCKET_MGR_ERROR,
+    SOCKET_MGR_SUCCESS
+} SocketMgrErrorCode_n;
+
+typedef enum
+{
+    SOCKET_MGR_TCP,
+    SOCKET_MGR_UDP
+} SocketMgrProtocol_n;
+
+typedef enum
+{
+    SOCKET_MGR_STATE_CLOSED,
+    SOCKET_MGR_STATE_OPENING,
+    SOCKET_MGR_STATE_OPEN,
+    SOCKET_MGR_STATE_CLOSING
+} SocketMgrState_n;
+
+typedef struct
+{
+    uint32_t bytesSent;                     /* bytesSent is the payload confirmed with SEND OK. */
+    uint32_t bytesReceived;                 /* bytesReceived is the payload read with QIRD. */
+    uint32_t countSendFail;                 /* countSendFail is the number of QISEND not confirmed. */
+    uint32_t countRxOverflow;               /* countRxOverflow is the number of bytes dropped on a full receive queue. */
+} SocketMgrStats_t;
+
+/**
+ * @brief   Initializes the socket manager.
+ * @return  Return the error code defined in SocketMgrErrorCode_n
+ */
+SocketMgrErrorCode_n SocketMgrInit(void);
+
+/**
+ * @brief   Runs the socket manager state machine.
+ * @return  Return the error code defined in SocketMgrErrorCode_n
+ */
+SocketMgrErrorCode_n SocketMgrExe(void);
+
+/**
+ * @brief   Requests a socket to be opened, done once the network is available.
+ * @param   socket      Socket index, 0 to SOCKET_MGR_MAX_SOCKETS - 1.
+ * @param   protocol    TCP or UDP.
+ * @param   host        Remote host name or IP address.
+ * @param   port        Remote port.
+ * @return  Return the error code defined in SocketMgrErrorCode_n, error if the socket is not closed.
+ */
+SocketMgrErrorCode_n SocketMgrOpen(uint8_t socket, SocketMgrProtocol_n protocol, const char *host, uint16_t port);
+
+/**
+ * @brief   Requests a socket to be closed, pending send data is dropped.
+ * @param   socket      Socket index.
+ * @return  Return the error code defined in SocketMgrErrorCode_n
+ */
+SocketMgrErrorCode_n SocketMgrClose(uint8_t socket);
+
+/**
+ * @brief   Queues data to be sent on an open socket.
+ * @param   socket      Socket index.
+ * @param   data        Data to send.
+ * @param   len         Length of the data.
+ * @return  Number of bytes queued, can be less than len when the send queue is full.
+ */
+uint32_t SocketMgrSend(uint8_t socket, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief   Reads received data of a socket.
+ * @param   socket      Socket index.
+ * @param   data        Output buffer.
+ * @param   maxLen      Size of the output buffer.
+ * @return  Number of bytes read.
+ */
+uint32_t SocketMgrReceive(uint8_t socket, uint8_t *data, uint32_t maxLen);
+
+/**
+ * @brief   Retrieves the state of a socket.
+ * @param   socket      Socket index.
+ * @return  State defined in SocketMgrState_n, closed for an invalid index.
+ */
+SocketMgrState_n SocketMgrGetState(uint8_t socket);
+
+/**
+ * @brief   Retrieves the transfer statistics of a socket.
+ * @param   socket      Socket index.
+ * @param   stats       Output statistics.
+ * @return  Return the error code defined in SocketMgrErrorCode_n
+ */
+SocketMgrErrorCode_n SocketMgrGetStats(uint8_t socket, SocketMgrStats_t *stats);
+
+#endif /*SOCKET_MGR_H*/
@@ -62,7 +62,7 @@ typedef struct
     uint8_t  previousState;
     uint8_t  state;
     uint8_t  mode;
-    uint32_t timeout;
+    ModemTimer_t timeout;
 }XMQTT_FsmContext_t;
 
 typedef enum
@@ -503,6 +503,11 @@ static void logStatus(void);
 static bool    g_statusNetwork;
 static uint8_t g_statusMqttManager;
 
+/*
+ * AT EXECUTOR CLIENT
+ */
+static AtClientId_t g_atClient;
+
 /*
  * FSM STATES
  */
@@ -513,6 +518,11 @@ static XMQTT_FsmContext_t g_fsmContextSubscribe;
 static XMQTT_FsmContext_t g_fsmContextUnsubscribe;
 static XMQTT_FsmContext_t g_fsmContextPublish;
 
+/*
+ * STATUS LOG
+ */
+static ModemTimer_t g_logTimer;
+
 /*
  * LIVE REQUEST
  */
@@ -577,6 +587,12 @@ void XMQTT_Init(void)
     g_container[1].payloadLength = XMQTT_RECEIVE_SIZE;
 
     AtRegisterUrc(g_mqttUrcTable, URC_MQTT_COUNT);
+    g_atClient = AtRegisterClient("mqtt");
+
+    ModemTimerCreate(&g_fsmContextConnect.timeout);
+    ModemTimerCreate(&g_fsmContextPublish.timeout);
+    ModemTimerCreate(&g_logTimer);
+    ModemTimerStart(g_logTimer, 0);
 
     fsmTransitionMain       (XMQTT_FSMS_MAIN_NO_NETWORK      );
     fsmTransitionConnect    (XMQTT_FSMS_CONNECT_SUPERVISE    );
@@ -1659,7 +1675,7 @@ static void fsmConnect(void)
                     case(XMQTT_FSMM_INITIATED) :
                     {
                         g_requestConnect.flagSslFiles = 0;
-                        status = AtStart(atableSslFiles, (uint8_t)XMQTT_ATABLE_SSL_MAX, fillerSslFiles,respondSslFiles,cbStatusSslFiles);
+                        status = AtStartClient(g_atClient, AT_PRIORITY_LOW, atableSslFiles, (uint8_t)XMQTT_ATABLE_SSL_MAX, fillerSslFiles,respondSslFiles,cbStatusSslFiles);
 
                         if(status == AT_SUCCESS)
                         {
@@ -1700,7 +1716,7 @@ static void fsmConnect(void)
                     case(XMQTT_FSMM_INITIATED) :
                     {
                         g_requestConnect.flagSslConfig = 0;
-                        status = AtStart(atableSslConfig, (uint8_t)XMQTT_ATT_SSL_CONFIG_MAX, fillerSslConfig, respondSslConfig, cbStatusSslConfig);
+                        status = AtStartClient(g_atClient, AT_PRIORITY_NORMAL, atableSslConfig, (uint8_t)XMQTT_ATT_SSL_CONFIG_MAX, fillerSslConfig, respondSslConfig, cbStatusSslConfig);
 
                         if(status == AT_SUCCESS)
                         {
@@ -1767,7 +1783,7 @@ static void fsmConnect(void)
                             }
                         }
 
-                        status = AtStart(atableConfig, XMQTT_ATT_CONFIG_MAX, fillerConfiguration,respondConfiguration,cbStatusConfiguration);
+                        status = AtStartClient(g_atClient, AT_PRIORITY_NORMAL, atableConfig, XMQTT_ATT_CONFIG_MAX, fillerConfiguration,respondConfiguration,cbStatusConfiguration);
 
                         if(status == AT_SUCCESS)
                         {
@@ -1814,13 +1830,13 @@ static void fsmConnect(void)
                             {
                                 g_requestConnect.flagClose = 0;
 
-                                status = AtStart(atableClose, XMQTT_ATT_CLOSE_MAX, fillerClose,respondClose,cbStatusClose);
+                                status = AtStartClient(g_atClient, AT_PRIORITY_NORMAL, atableClose, XMQTT_ATT_CLOSE_MAX, fillerClose,respondClose,cbStatusClose);
 
                                 if(status == AT_SUCCESS)
                                 {
                                     g_fsmContextConnect.mode = XMQTT_FSMM_EXECUTED;
 
-                                    RESET_TIMER(g_fsmContextConnect.timeout, 10 * 1000);
+                                    ModemTimerStart(g_fsmContextConnect.timeout, 10 * 1000);
                                 }
                                 else
                                 {
@@ -1836,7 +1852,7 @@ static void fsmConnect(void)
                                 }
                                 else
                                 {
-                                    if(IS_TIMER_ELAPSED(g_fsmContextConnect.timeout))
+                                    if(ModemTimerExpired(g_fsmContextConnect.timeout))
                                     {
                                         g_fsmContextConnect.mode = XMQTT_FSMM_INITIATED;
                                     }
@@ -1864,12 +1880,12 @@ static void fsmConnect(void)
                     case(XMQTT_FSMM_INITIATED):
                         {
                             g_requestConnect.flagOpen = 0;
-                            status = AtStart(atableOpen, XMQTT_ATT_OPEN_MAX, fillerOpen,respondOpen,cbStatusOpen);
+                            status = AtStartClient(g_atClient, AT_PRIORITY_NORMAL, atableOpen, XMQTT_ATT_OPEN_MAX, fillerOpen,respondOpen,cbStatusOpen);
 
                             if(status == AT_SUCCESS)
                             {
                                 g_fsmContextConnect.mode = XMQTT_FSMM_EXECUTED;
-                                RESET_TIMER(g_fsmContextConnect.timeout, 60 * 1000);
+                                ModemTimerStart(g_fsmContextConnect.timeout, 60 * 1000);
                             }
                             else
                             {
@@ -1885,7 +1901,7 @@ static void fsmConnect(void)
                             }
                             else
                             {
-                                if(IS_TIMER_ELAPSED(g_fsmContextConnect.timeout))
+                                if(ModemTimerExpired(g_fsmContextConnect.timeout))
                                 {
                                     fsmTransitionConnect(XMQTT_FSMS_CONNECT_CLOSE_TCP); //TODO:MAYBE ABORT?
                                 }
@@ -1914,13 +1930,13 @@ static void fsmConnect(void)
                     case(XMQTT_FSMM_INITIATED):
                         {
                             g_requestConnect.flagConnect = 0;
-                            status = AtStart(atableConnect, XMQTT_ATT_CONNECT_MAX, fillerConnect,respondConnect,cbStatusConnect);
+                            status = AtStartClient(g_atClient, AT_PRIORITY_NORMAL, atableConnect, XMQTT_ATT_CONNECT_MAX, fillerConnect,respondConnect,cbStatusConnect);
 
                             if(status == AT_SUCCESS)
                             {
                                 g_fsmContextConnect.mode = XMQTT_FSMM_EXECUTED;
 
-                                RESET_TIMER(g_fsmContextConnect.timeout, 60 * 1000);
+                                ModemTimerStart(g_fsmContextConnect.timeout, 60 * 1000);
                             }
                             else
                             {
@@ -1936,7 +1952,7 @@ static void fsmConnect(void)
                             }
                             else
                             {
-                                if(IS_TIMER_ELAPSED(g_fsmContextConnect.timeout))
+                                if(ModemTimerExpired(g_fsmContextConnect.timeout))
                                 {
                                     fsmTransitionConnect(XMQTT_FSMS_CONNECT_OPEN_TCP);
                                 }
@@ -2080,7 +2096,7 @@ static void fsmDisconnect(void)
                     case(XMQTT_FSMM_INITIATED):
                     {
                         g_requestDisconnect.flagDisconnect = 0;
-                        status = AtStart(atableDisconnect, XMQTT_ATT_DISCONNECT_MAX, fillerDisconnect, respondDisconnect, cbStatusDisconnect);
+                        status = AtStartClient(g_atClient, AT_PRIORITY_NORMAL, atableDisconnect, XMQTT_ATT_DISCONNECT_MAX, fillerDisconnect, respondDisconnect, cbStatusDisconnect);
  
                         if(status == AT_SUCCESS)
                         {
@@ -2126,13 +2142,13 @@ static void fsmDisconnect(void)
                         {
                             g_requestDisconnect.flagClose = 0;
 
-                            status = AtStart(atableClose, XMQTT_ATT_CLOSE_MAX, fillerClose,respondClose,cbStatusCloseDisconnect);
+                            status = AtStartClient(g_atClient, AT_PRIORITY_NORMAL, atableClose, XMQTT_ATT_CLOSE_MAX, fillerClose,respondClose,cbStatusCloseDisconnect);
 
                             if(status == AT_SUCCESS)
                             {
                                 g_fsmContextConnect.mode = XMQTT_FSMM_EXECUTED;
 
-                                RESET_TIMER(g_fsmContextConnect.timeout, 10 * 1000);
+                                ModemTimerStart(g_fsmContextConnect.timeout, 10 * 1000);
                             }
                             else
                             {
@@ -2148,7 +2164,7 @@ static void fsmDisconnect(void)
                             }
                             else
                             {
-                                if(IS_TIMER_ELAPSED(g_fsmContextConnect.timeout))
+                                if(ModemTimerExpired(g_fsmContextConnect.timeout))
                                 {
                                     g_fsmContextConnect.mode = XMQTT_FSMM_INITIATED;
                                 }
@@ -2267,7 +2283,7 @@ static void fsmSubscribe(void)
                     case(XMQTT_FSMM_INITIATED):
                     {
                         g_requestSubscribe.flagSubscribe = 0;
-                        status = AtStart(atableSubscribe, XMQTT_ATT_SUBSCRIBE_MAX, fillerSubscribe, respondSubscribe, cbStatusSubscribe);
+                        status = AtStartClient(g_atClient, AT_PRIORITY_NORMAL, atableSubscribe, XMQTT_ATT_SUBSCRIBE_MAX, fillerSubscribe, respondSubscribe, cbStatusSubscribe);
 
                         if(status == AT_SUCCESS)
                         {
@@ -2457,13 +2473,13 @@ static void fsmPublish(void)
                 {
                     case(XMQTT_FSMM_INITIATED):
                     {
-                        status = AtStart(atablePublish, XMQTT_ATT_PUBLISH_MAX, fillerPublish, respondPublish, cbStatusPublish);
+                        status = AtStartClient(g_atClient, AT_PRIORITY_NORMAL, atablePublish, XMQTT_ATT_PUBLISH_MAX, fillerPublish, respondPublish, cbStatusPublish);
 
                         if(status == AT_SUCCESS)
                         {
                             g_fsmContextPublish.mode = XMQTT_FSMM_EXECUTED;
 
-                            RESET_TIMER(g_fsmContextPublish.timeout, 60 * 1000);
+                            ModemTimerStart(g_fsmContextPublish.timeout, 60 * 1000);
                         }
                         else
                         {
@@ -2479,7 +2495,7 @@ static void fsmPublish(void)
                         }
                         else
                         {
-                            if(IS_TIMER_ELAPSED(g_fsmContextPublish.timeout))
+                            if(ModemTimerExpired(g_fsmContextPublish.timeout))
                             {
                                 fsmTransitionPublish(XMQTT_FSMS_PUBLISH_PUB);
                             }
@@ -2576,9 +2592,7 @@ static int8_t isSocketFree(uint8_t id)
 
 static void logStatus(void)
 {
-    static uint32_t logTimer = 0;
-
-    if(IS_TIMER_ELAPSED(logTimer))
+    if(ModemTimerExpired(g_logTimer))
     {
         NETWORK_PRINT_INFO("NET: 0 | MQTT(0-5): %d.%d.%d.%d.%d.%d\r\n",\
                 g_mqttSockets[0].connection,\
@@ -2587,6 +2601,6 @@ static void logStatus(void)
                 g_mqttSockets[3].connection,\
                 g_mqttSockets[4].connection,\
                 g_mqttSockets[5].connection);
-        RESET_TIMER(logTimer, 5 * 1000);
+        ModemTimerStart(g_logTimer, 5 * 1000);
     }
 }
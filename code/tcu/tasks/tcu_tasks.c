@@ -24,6 +24,7 @@
 
 // OSAL includes.
 #include "osal.h"
+#include "osal_timer.h"
 
 // HAL includes.
 #include "hal_uart.h"
@@ -35,15 +36,19 @@
 // User-functionality includes.
 #include "tcu_locks.h"
 #include "logger.h"
+#include "logger_can.h"
 #include "drv_can.h"
 #include "tcu_test.h"
 #include "gps.h"
+#include "can_trace.h"
+#include "can_signal.h"
 
 // Network includes.
 #include "at_command_handler.h"
 #include "connection_mgr.h"
 #include "modem_port.h"
 #include "x_mqtt_manager.h"
+#include "socket_mgr.h"
 #include "tcu_2w_test_mqtt.h"
 
 // Filesystem includes.
@@ -53,6 +58,14 @@
 #include "os_mutex.h"
 
 // Private defines.
+#define TCU_TASKS_EVENT_MODEM_LINE          ( 0x01UL )      // Modem sent a line end, wakes the service thread.
+#define TCU_TASKS_EVENT_TMR_GPIO            ( 0x02UL )      // Service thread timers.
+#define TCU_TASKS_EVENT_TMR_OSTIME          ( 0x04UL )
+#define TCU_TASKS_EVENT_TMR_GSM             ( 0x08UL )
+#define TCU_TASKS_EVENT_TMR_AT              ( 0x10UL )
+#define TCU_TASKS_EVENT_MODEM_TIMER         ( 0x20UL )      // A network state machine timeout expired.
+#define TCU_TASKS_DEBUG_STATS_RUNS          ( 25UL )        // Debug thread runs between two stats prints, 250 ms.
+
 typedef enum
 {
     TcuTasksSys,
@@ -61,6 +74,7 @@ typedef enum
     TcuTasksApp1,
     TcuTasksApp2,
     TcuTasksApp3,
+    TcuTasksTrace,
     TcuTasksMax
 } TcuTasks_n;
 
@@ -74,9 +88,10 @@ typedef struct
 uint32_t g_var_sys;
 
 // Private timer variables.
-static uint32_t gTmrGpio;
-static uint32_t gTmrOstime;
-static uint32_t gTmrGsm;
+static OsalTimer_t gTmrGpio;
+static OsalTimer_t gTmrOstime;
+static OsalTimer_t gTmrGsm;
+static OsalTimer_t gTmrAt;
 static uint8_t g_memSvcThreadUartRx[8192UL];
 
 // Private Sibros locks.
@@ -90,23 +105,30 @@ static void initSvc                         (OsalThread_t thread);
 static void initApp1                        (OsalThread_t thread);
 static void initApp2                        (OsalThread_t thread);
 static void initApp3                        (OsalThread_t thread);
+static void initTrace                       (OsalThread_t thread);
 static void runnerSys                       (OsalThread_t thread);
 static void runnerSvc                       (OsalThread_t thread);
 static void runnerDebug                     (OsalThread_t thread);
+static void printStats                      (OsalThread_t thread, size_t countRx, size_t totalRx);
+static void printCanSignals                 (OsalThread_t thread);
 static void runnerApp1                      (OsalThread_t thread);
 static void runnerApp2                      (OsalThread_t thread);
 static void runnerApp3                      (OsalThread_t thread);
+static void runnerTrace                     (OsalThread_t thread);
 static void logger_for_service_thread       (char* fmt, ...);
 static size_t consumeDebugRx                (void);
+static void modemRxNotify                   (uint8_t byte);
+static void startSvcTimer                   (OsalThread_t thread, OsalTimer_t* timer, uint32_t periodMs, uint32_t events);
 
 TcuTasksInit_t g_taskTable[TcuTasksMax] = 
 {
-    { { NULL }, { NULL,     runnerSys,      OsalThreadPriority_7,   1024UL,     2UL,    "System"        } },    // 2 ms.
-    { { NULL }, { initSvc,  runnerSvc,      OsalThreadPriority_5,   4096UL,     20UL,   "Service"       } },    // 20 ms.
-    { { NULL }, { NULL,     runnerDebug,    OsalThreadPriority_3,   4096UL,     250UL,  "Debug"         } },    // 250 ms.
+    { { NULL }, { NULL,     runnerSys,      OsalThreadPriority_7,   1024UL,     2UL,    "System",       false,  10  } },    // 2 ms.
+    { { NULL }, { initSvc,  runnerSvc,      OsalThreadPriority_5,   4096UL,     20UL,   "Service",      true,   20  } },    // 20 ms, early on modem lines.
+    { { NULL }, { NULL,     runnerDebug,    OsalThreadPriority_3,   4096UL,     10UL,   "Debug",        false,  20  } },    // 10 ms, prints all thread logs.
     { { NULL }, { initApp1, runnerApp1,     OsalThreadPriority_1,   4096UL,     0UL,    "App1",         } },    // Unbounded.
     { { NULL }, { initApp2, runnerApp2,     OsalThreadPriority_1,   4096UL,     0UL,    "App2",         } },    // Unbounded.
     { { NULL }, { initApp3, runnerApp3,     OsalThreadPriority_1,   4096UL,     0UL,    "App3",         } },    // Unbounded.
+    { { NULL }, { initTrace, runnerTrace,   OsalThreadPriority_2,   1024UL,     10UL,   "Trace"         } },    // 10 ms.
 };
 
 void tcu_tasks                              (void)
@@ -132,21 +154,33 @@ static void pre_start_hook                  (void)
 {
     tcu_test_memory();
     tcu_test_flash();
+    logger_can_tx_init(g_taskTable[TcuTasksSys].config.periodicityMs);
+    hal_util_assert ( HalUartErrOk == hal_uart_set_rx_callback(g_UartGsm, modemRxNotify) );
 }
 
 
 static void initSvc                         (OsalThread_t thread)
 {
-    hal_util_assert ( OsalErrOk == osal_tmr_init(&gTmrGpio) );
-    hal_util_assert ( OsalErrOk == osal_tmr_init(&gTmrOstime) );
-    hal_util_assert ( OsalErrOk == osal_tmr_init(&gTmrGsm) );
+    CanSignal_n signal = (CanSignal_n) 0;
+
+    startSvcTimer(thread, &gTmrGpio,    500,    TCU_TASKS_EVENT_TMR_GPIO);
+    startSvcTimer(thread, &gTmrOstime,  5000,   TCU_TASKS_EVENT_TMR_OSTIME);
+    startSvcTimer(thread, &gTmrGsm,     10000,  TCU_TASKS_EVENT_TMR_GSM);
+    startSvcTimer(thread, &gTmrAt,      60000,  TCU_TASKS_EVENT_TMR_AT);
     
     net_log_init(logger_for_service_thread);
+    ModemTimerInit(thread, TCU_TASKS_EVENT_MODEM_TIMER);
     AtInit();
     ConnectionMgrInit();
     XMQTT_Init();
+    SocketMgrInit();
     appMqtt_Init();
     GpsInit(logger_for_service_thread);
+    hal_util_assert ( true == CanSignalInit() );
+    for ( signal = (CanSignal_n) 0 ; signal < CanSignalMax ; ++signal )
+    {
+        hal_util_assert ( true == CanSignalSubscribe(signal) );
+    }
 }
 
 
@@ -168,68 +202,142 @@ static void initApp3                        (OsalThread_t thread)
 }
 
 
+static void initTrace                       (OsalThread_t thread)
+{
+    CanTraceInit();
+#ifdef CAN_TRACE_EN
+    hal_util_assert ( true == CanTraceStart(NULL, 0, true) );
+#endif
+}
+
+
 static void runnerSys                       (OsalThread_t thread)
 {
+    uint64_t timeMs = 0;
+
     // System thread code.
+    logger_can_tx_exec();
     drv_can_bPeriodicTask();
     hal_uart_process(g_UartGps);
     hal_uart_process(g_UartGsm);
     hal_uart_process(g_UartDbg);
-    osal_service_execute();
+    osal_timer_execute();
     
     // Trace code, don't remove.
     __nop();
-    g_var_sys += g_taskTable[TcuTasksSys].config.periodicityMs;
-    hal_util_delay_us( ( g_taskTable[TcuTasksSys].config.periodicityMs * 1000UL ) * 0.10 ); // 0.2 ms
+    (void) osal_time_ms(&timeMs);
+    g_var_sys = (uint32_t) timeMs;
     __nop();
 }
 
 
 static void runnerSvc                       (OsalThread_t thread)
 {
+    uint32_t events = 0;
+
     // Service thread code.
-    tcu_test_can();         //FIXME: Uses raw logger!
+    CanSignalExe();
     AtExe();
     ConnectionMgrExe();
     GpsExe();
     XMQTT_Execute();
+    SocketMgrExe();
     appMqtt_Exe();
     
-    hal_util_assert ( OsalErrOk == osal_tmr_exec(tcu_test_gpio,            500,     &gTmrGpio) );        //FIXME: Uses raw logger!
-    hal_util_assert ( OsalErrOk == osal_tmr_exec(printUpTime,              5000,    &gTmrOstime) );      //FIXME: Uses raw logger!
-    hal_util_assert ( OsalErrOk == osal_tmr_exec(ConnectionMgrPrintInfo,   10000,   &gTmrGsm) );
     
-    // Trace code, don't remove.
-    __nop();
-    hal_util_delay_us( ( g_taskTable[TcuTasksSvc].config.periodicityMs * 1000UL ) * 0.20 ); // 4 ms
-    __nop();
+    // Timer jobs, the timers wake this thread when they expire.
+    (void) osal_event_take(thread, &events, 0);
+    if ( events & TCU_TASKS_EVENT_TMR_GPIO )
+    {
+        tcu_test_gpio(thread);
+    }
+    if ( events & TCU_TASKS_EVENT_TMR_OSTIME )
+    {
+        printUpTime(thread);
+        printCanSignals(thread);
+    }
+    if ( events & TCU_TASKS_EVENT_TMR_GSM )
+    {
+        ConnectionMgrPrintInfo();
+    }
+    if ( events & TCU_TASKS_EVENT_TMR_AT )
+    {
+        AtPrintClientStats();
+    }
 }
 
 
 static void runnerDebug                     (OsalThread_t thread)
 {
-    OsalThreadStats_t stats[TcuTasksMax] = {0};
-    TcuTasks_n taskIndex = TcuTasksSys;
-    size_t countRx = 0;
+    static size_t countRx = 0;
     static size_t totalRx = 0;
+    static uint32_t countRuns = 0;
 
     // Consume Debug Rx.
-    countRx = consumeDebugRx();
-    totalRx += countRx;
+    countRx += consumeDebugRx();
 
     // Print Stats.
-    osal_logger(thread, "Stats:");
+    if ( ++countRuns >= TCU_TASKS_DEBUG_STATS_RUNS )
+    {
+        countRuns = 0;
+        totalRx += countRx;
+        printStats(thread, countRx, totalRx);
+        countRx = 0;
+    }
+
+    // All thread logs are printed from here only, the logger is not reentrant.
+    osal_service_execute();
+    osal_logger_deferred_execute();
+}
+
+
+static void printStats                      (OsalThread_t thread, size_t countRx, size_t totalRx)
+{
+    OsalThreadStats_t stats[TcuTasksMax] = {0};
+    TcuTasks_n taskIndex = TcuTasksSys;
+
+    osal_logger_deferred(thread, "Stats:");
     for ( taskIndex = TcuTasksSys ; taskIndex < TcuTasksMax ; ++taskIndex )
     {
         osal_thread_get_stats(g_taskTable[taskIndex].handle, &stats[taskIndex]);
-        osal_logger(thread, " %7d", stats[taskIndex].countLoops);
+        osal_logger_deferred(thread, " %7d", stats[taskIndex].countLoops);
     }
-    osal_logger(thread, " <%7d, %7d>\r\n", countRx, totalRx);
+    osal_logger_deferred(thread, " <%7d, %7d>\r\n", countRx, totalRx);
+    osal_logger_deferred(thread, "Exec:");
+    for ( taskIndex = TcuTasksSys ; taskIndex < TcuTasksMax ; ++taskIndex )
+    {
+        osal_logger_deferred(thread, " %5"PRIu32"/%5"PRIu32"/", stats[taskIndex].usExecSecond, stats[taskIndex].usExecMax);
+        if ( OSAL_SLACK_NONE == stats[taskIndex].usSlackMin )
+        {
+            osal_logger_deferred(thread, "    -");
+        }
+        else
+        {
+            osal_logger_deferred(thread, "%5"PRIu32, stats[taskIndex].usSlackMin);
+        }
+    }
+    osal_logger_deferred(thread, "\r\n");
+}
 
-    // Trace code, don't remove.
-    __nop();
-    hal_util_delay_us( ( g_taskTable[TcuTasksDebug].config.periodicityMs * 1000UL ) * 0.20 ); // 50 ms
-    __nop();
+
+static void printCanSignals                 (OsalThread_t thread)
+{
+    CanSignalValue_t value = {0};
+    CanSignal_n signal = (CanSignal_n) 0;
+
+    osal_logger_deferred(thread, "CAN:");
+    for ( signal = (CanSignal_n) 0 ; signal < CanSignalMax ; ++signal )
+    {
+        if ( CanSignalGet(signal, &value) )
+        {
+            osal_logger_deferred(thread, " %"PRIu32"/%"PRIu32, (uint32_t) value.value, value.count);
+        }
+        else
+        {
+            osal_logger_deferred(thread, "    -");
+        }
+    }
+    osal_logger_deferred(thread, "\r\n");
 }
 
 
@@ -281,6 +389,13 @@ static void runnerApp3                      (OsalThread_t thread)
 }
 
 
+static void runnerTrace                     (OsalThread_t thread)
+{
+    // Flash writer of the CAN trace, blocks on page program and block erase.
+    CanTraceExe();
+}
+
+
 static void logger_for_service_thread       (char* fmt, ...)
 {
     char printMem[128UL] = {0};
@@ -313,3 +428,22 @@ static size_t consumeDebugRx                (void)
     
     return countRx;
 }
+
+
+static void modemRxNotify                   (uint8_t byte)
+{
+    // Modem responses and URCs are line based, a line end is worth handling before the period ends.
+    if ( '\n' == byte )
+    {
+        (void) osal_event_set_from_isr(g_taskTable[TcuTasksSvc].handle, TCU_TASKS_EVENT_MODEM_LINE);
+    }
+}
+
+
+static void startSvcTimer                   (OsalThread_t thread, OsalTimer_t* timer, uint32_t periodMs, uint32_t events)
+{
+    OsalTimerConfig_t config = { periodMs, NULL, thread, events };
+
+    hal_util_assert ( OsalErrOk == osal_timer_create(timer, &config) );
+    hal_util_assert ( OsalErrOk == osal_timer_start(*timer, periodMs) );
+}
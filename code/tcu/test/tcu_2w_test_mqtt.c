@@ -43,6 +43,8 @@ uint16_t lengthX[6]={2,13,13,13,13,13};
 char *topicSub[6] = {"$aws/certificates/create/json/rejected","subtopic/test1","subtopic/test2","subtopic/test3","subtopic/test4","subtopic/test5"};
 uint16_t topicLen[6] = {38,14,14,14,14,14};
 
+static ModemTimer_t g_publishTimer;
+
 void cbConnect(uint8_t status);
 void cb_subscribe(uint8_t status);
 void cb_publish(uint8_t status);
@@ -91,6 +93,9 @@ appMqtt_Init()
     
     XMQTT_connect(tempHandle);
 
+    ModemTimerCreate(&g_publishTimer);
+    ModemTimerStart(g_publishTimer, 0);
+
     // tempHandle2.socketId = XMQTT_SOCKET_ANY;
     // tempHandle2.ip       = ip2;
     // tempHandle2.port     = port2;
@@ -118,9 +123,7 @@ appMqtt_Init()
 
 appMqtt_Exe()
 {
-    static uint32_t publishTimer = 0;
-    
-    if(IS_TIMER_ELAPSED(publishTimer))
+    if(ModemTimerExpired(g_publishTimer))
     {
         if(XMQTT_isMqtt())
         {
@@ -179,6 +182,6 @@ appMqtt_Exe()
 //            }
 //        }
         
-        RESET_TIMER(publishTimer, 10 * 1000);
+        ModemTimerStart(g_publishTimer, 10 * 1000);
     }
 }
\ No newline at end of file
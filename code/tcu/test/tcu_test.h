@@ -17,10 +17,13 @@
 #ifndef TCU_2W_TEST_H
 #define TCU_2W_TEST_H
 
+#include "osal.h"
+
 /**
  *  @brief                                  Print CPU up time.
+ *  @param  thread                          Calling thread, the print is deferred to the debug thread.
 */
-void printUpTime();
+void printUpTime(OsalThread_t thread);
 
 /**
  *  @brief                                  Tests memory (RAM) memories and validates BSS and DATA correctly configured.
@@ -42,11 +45,6 @@ void tcu_test_uart(void);
 */
 void tcu_test_network(void);
 
-/**
- *  @brief                                  Tests CAN tasks.
-*/
-void tcu_test_can(void);
-
 /**
  *  @brief                                  Tests OsTime tasks.
 */
@@ -54,8 +52,9 @@ void tcu_test_ostime(void);
 
 /**
  *  @brief                                  Tests GPIO interface on DIET PCB
+ *  @param  thread                          Calling thread, the print is deferred to the debug thread.
 */
-void tcu_test_gpio(void);
+void tcu_test_gpio(OsalThread_t thread);
 
 /**
  *  @brief                                  Tests GPS interface on DIET PCB.
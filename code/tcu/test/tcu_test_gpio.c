@@ -28,9 +28,10 @@
 #include "tcu_board.h"
 
 // Extra includes.
-#include "logger.h"
+#include "osal.h"
+#include "tcu_test.h"
 
-void tcu_test_gpio(void)
+void tcu_test_gpio(OsalThread_t thread)
 {
     HalGpioLevel_n level = HalGpioLevelMax;
     static HalGpioLevel_n stateIgnition = HalGpioLevelMax;
@@ -55,6 +56,6 @@ void tcu_test_gpio(void)
     if ( level != stateIgnition )
     {
         stateIgnition = level;
-        logger("IGN: %d\r\n", level);
+        (void) osal_logger_deferred(thread, "IGN: %d\r\n", level);
     }
 }
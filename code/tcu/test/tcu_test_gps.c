@@ -40,13 +40,16 @@
 
 // Private variables.
 static uint8_t g_receiveBuff[RX_BUFF_MAX_LEN];
-static uint32_t g_printTmr = 0;
+static ModemTimer_t g_printTmr;
 
 void tcu_test_gps(void)
 {
     bool initDone = false;
     logger("modem uart init done\r\n");
 
+    ModemTimerCreate(&g_printTmr);
+    ModemTimerStart(g_printTmr, 0);
+
     // turn on the modem
     ModemRstKeyHigh();
     hal_util_delay(1000);
@@ -75,20 +78,20 @@ void tcu_test_gps(void)
                 memset(atCmd, 0, sizeof(atCmd));
                 hal_util_delay(10);
 
-                RESET_TIMER(g_printTmr, 1000);
+                ModemTimerStart(g_printTmr, 1000);
             }
         }
 
         GpsExe();
 
         // print gnss data periodically
-        if (IS_TIMER_ELAPSED(g_printTmr))
+        if (ModemTimerExpired(g_printTmr))
         {
-            RESET_TIMER(g_printTmr, 1000);
+            ModemTimerStart(g_printTmr, 1000);
 
             GpsInfo_t gpsInfo = GpsGetInfo();
-            logger("gps utc_time %d date %u fix %d lat %f long %f speed_kph %.2f num_sat %d alt %.2f\n\r", \
-            gpsInfo.utcTime, gpsInfo.date, gpsInfo.fixStatus, gpsInfo.latitude , gpsInfo.longitude , gpsInfo.speed , gpsInfo.numOfSatellites , gpsInfo.altitude);
+            logger("gps utc_time %d date %u fix %d lat_e7 %ld long_e7 %ld speed_cms %lu num_sat %d alt_mm %ld\n\r", \
+            gpsInfo.utcTime, gpsInfo.date, gpsInfo.fixStatus, (long)gpsInfo.latitude , (long)gpsInfo.longitude , (unsigned long)gpsInfo.speed , gpsInfo.numOfSatellites , (long)gpsInfo.altitude);
         }
 
         hal_util_memset(g_receiveBuff, 0, sizeof(g_receiveBuff));
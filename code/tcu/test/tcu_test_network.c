@@ -37,7 +37,7 @@
 
 // Private variables.
 uint8_t g_network_test_mem[NETWORK_TEST_MEM_SIZE];
-uint32_t g_timer = 0;
+ModemTimer_t g_timer;
 
 void tcu_test_network(void)
 {
@@ -46,19 +46,20 @@ void tcu_test_network(void)
     AtInit();
     ConnectionMgrInit();
     
-    RESET_TIMER(g_timer, 0);
+    ModemTimerCreate(&g_timer);
+    ModemTimerStart(g_timer, 0);
 
     while (1)
     {
         AtExe();
         ConnectionMgrExe();
-        if (IS_TIMER_ELAPSED(g_timer))
+        if (ModemTimerExpired(g_timer))
         {
             ConnectionMgrInfo_t connInfo = ConnectionMgrGetInfo();
             logger("[NET] network status: %d, CREG: %d, CGREG: %d, CSQ: %d, op name: %s %d, IP: %s \r\n",
                    connInfo.networkStatus, connInfo.creg, connInfo.cgreg, connInfo.csq, connInfo.operatorName,
                    connInfo.accessTechnology, connInfo.ipAddress);
-            RESET_TIMER(g_timer, 3 * 1000);
+            ModemTimerStart(g_timer, 3 * 1000);
         }
         receivedString = logger_read(g_network_test_mem, 100);
         if (0 < receivedString)
@@ -24,6 +24,8 @@
 
 // Logger include.
 #include "logger.h"
+#include "osal.h"
+#include "tcu_test.h"
 #include "logger_can.h"
 
 // Port includes.
@@ -108,10 +110,10 @@ static void test_os_time_sum_epochs(void)
     //TODO:
 }
 
-void printUpTime()
+void printUpTime(OsalThread_t thread)
 {
     TcuTime_t uptime = tcu_time_uptime();
-    logger("[TCU uptime %lus %lu us]\r\n", uptime.seconds, uptime.fractional);
+    (void) osal_logger_deferred(thread, "[TCU uptime %lus %lu us]\r\n", uptime.seconds, uptime.fractional);
 
     LoggerCan_u sysUpTime = {0};
     sysUpTime.sysA.uptimeMs = uptime.seconds; 